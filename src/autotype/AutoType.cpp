@@ -29,6 +29,7 @@
 #include "autotype/AutoTypePlatformPlugin.h"
 #include "autotype/AutoTypeSelectDialog.h"
 #include "autotype/PickcharsDialog.h"
+#include "core/DatabaseQueryExecutor.h"
 #include "core/Global.h"
 #include "core/Resources.h"
 #include "core/Tools.h"
@@ -447,10 +448,12 @@ void AutoType::performGlobalAutoType(const QList<QSharedPointer<Database>>& dbLi
         return;
     }
 
-    QList<AutoTypeMatch> matchList;
     bool hideExpired = config()->get(Config::AutoTypeHideExpiredEntry).toBool();
+    const QString windowTitle = m_windowTitleForGlobal;
 
-    for (const auto& db : dbList) {
+    // Databases are matched in parallel, the matches keep the order of the databases
+    const auto matchList = DatabaseQueryExecutor::run<AutoTypeMatch>(dbList, [&](const QSharedPointer<Database>& db) {
+        QList<AutoTypeMatch> matches;
         const QList<Entry*> dbEntries = db->rootGroup()->entriesRecursive();
         for (auto entry : dbEntries) {
             auto group = entry->group();
@@ -461,12 +464,13 @@ void AutoType::performGlobalAutoType(const QList<QSharedPointer<Database>>& dbLi
             if (hideExpired && entry->isExpired()) {
                 continue;
             }
-            const QSet<QString> sequences = Tools::asSet(entry->autoTypeSequences(m_windowTitleForGlobal));
+            const QSet<QString> sequences = Tools::asSet(entry->autoTypeSequences(windowTitle));
             for (const auto& sequence : sequences) {
-                matchList << AutoTypeMatch(entry, sequence);
+                matches << AutoTypeMatch(entry, sequence);
             }
         }
-    }
+        return matches;
+    });
 
     // Show the selection dialog if we always ask, have multiple matches, or no matches
     if (getMainWindow()
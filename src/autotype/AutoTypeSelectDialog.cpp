@@ -155,7 +155,7 @@ void AutoTypeSelectDialog::performSearch()
                     matches.append({entry, defSequence});
                     sequences << defSequence;
                 }
-                for (const auto& assoc : entry->autoTypeAssociations()->getAll()) {
+                for (const auto& assoc : asConst(*entry).autoTypeAssociations()->getAll()) {
                     if (!sequences.contains(assoc.sequence) && !assoc.sequence.isEmpty()) {
                         matches.append({entry, assoc.sequence});
                         sequences << assoc.sequence;
@@ -37,6 +37,7 @@ BrowserHost::BrowserHost(QObject* parent)
     m_localServer = new QLocalServer(this);
     m_localServer->setSocketOptions(QLocalServer::UserAccessOption);
     connect(m_localServer.data(), SIGNAL(newConnection()), this, SLOT(proxyConnected()));
+    m_clock.start();
 }
 
 BrowserHost::~BrowserHost()
@@ -54,6 +55,7 @@ void BrowserHost::start()
 void BrowserHost::stop()
 {
     m_socketList.clear();
+    m_connections.clear();
     m_localServer->close();
 }
 
@@ -61,7 +63,15 @@ void BrowserHost::proxyConnected()
 {
     auto socket = m_localServer->nextPendingConnection();
     if (socket) {
+        socket->setReadBufferSize(BrowserShared::NATIVEMSG_MAX_LENGTH);
+        int socketDesc = socket->socketDescriptor();
+        if (socketDesc) {
+            int max = BrowserShared::NATIVEMSG_MAX_LENGTH;
+            setsockopt(socketDesc, SOL_SOCKET, SO_SNDBUF, reinterpret_cast<char*>(&max), sizeof(max));
+        }
+
         m_socketList.append(socket);
+        m_connections.insert(socket, ProxyConnection());
         connect(socket, SIGNAL(readyRead()), this, SLOT(readProxyMessage()));
         connect(socket, SIGNAL(disconnected()), this, SLOT(proxyDisconnected()));
     }
@@ -70,25 +80,74 @@ void BrowserHost::proxyConnected()
 void BrowserHost::readProxyMessage()
 {
     QLocalSocket* socket = qobject_cast<QLocalSocket*>(QObject::sender());
-    if (!socket || socket->bytesAvailable() <= 0) {
+    if (!socket || socket->bytesAvailable() <= 0 || !m_connections.contains(socket)) {
         return;
     }
 
-    socket->setReadBufferSize(BrowserShared::NATIVEMSG_MAX_LENGTH);
-    int socketDesc = socket->socketDescriptor();
-    if (socketDesc) {
-        int max = BrowserShared::NATIVEMSG_MAX_LENGTH;
-        setsockopt(socketDesc, SOL_SOCKET, SO_SNDBUF, reinterpret_cast<char*>(&max), sizeof(max));
+    // A read can contain several messages or only part of one, so reassemble them per socket
+    auto& connection = m_connections[socket];
+    connection.buffer.append(socket->readAll());
+
+    int offset = 0;
+    int length = 0;
+    while ((length = BrowserShared::jsonMessageLength(connection.buffer, offset)) > 0) {
+        QJsonParseError error;
+        auto json = QJsonDocument::fromJson(connection.buffer.mid(offset, length), &error);
+        offset += length;
+        if (json.isNull()) {
+            qWarning() << "Failed to read proxy message: " << error.errorString();
+            continue;
+        }
+        connection.pending.append(PendingMessage{json.object(), m_clock.nsecsElapsed()});
+    }
+    connection.buffer.remove(0, offset);
+
+    if (connection.buffer.size() > BrowserShared::NATIVEMSG_MAX_LENGTH) {
+        qWarning() << "Discarding incomplete proxy message exceeding the maximum length";
+        connection.buffer.clear();
     }
 
-    QJsonParseError error;
-    auto json = QJsonDocument::fromJson(socket->readAll(), &error);
-    if (json.isNull()) {
-        qWarning() << "Failed to read proxy message: " << error.errorString();
+    processProxyMessages(socket);
+}
+
+void BrowserHost::processProxyMessages(QLocalSocket* socket)
+{
+    // Handle the messages of a socket strictly one after the other. Handling a message can spin
+    // a nested event loop (e.g. to show a dialog), which must not overtake the pending reply.
+    auto it = m_connections.find(socket);
+    if (it == m_connections.end() || it->processing) {
         return;
     }
+    it->processing = true;
+
+    while (true) {
+        it = m_connections.find(socket);
+        if (it == m_connections.end() || it->pending.isEmpty()) {
+            break;
+        }
+
+        const auto message = it->pending.takeFirst();
+        emit clientMessageReceived(socket, message.json);
+
+        const auto latency = m_clock.nsecsElapsed() - message.receivedAt;
+        auto& stats = m_actionLatencies[message.json.value("action").toString()];
+        ++stats.count;
+        stats.totalNsecs += latency;
+        stats.maxNsecs = qMax(stats.maxNsecs, latency);
+    }
+
+    it = m_connections.find(socket);
+    if (it != m_connections.end()) {
+        it->processing = false;
+    }
+}
 
-    emit clientMessageReceived(socket, json.object());
+/**
+ * Time from receiving a message until its handling finished, per action.
+ */
+QHash<QString, BrowserHost::ActionLatency> BrowserHost::actionLatencies() const
+{
+    return m_actionLatencies;
 }
 
 void BrowserHost::broadcastClientMessage(const QJsonObject& json)
@@ -118,4 +177,5 @@ void BrowserHost::proxyDisconnected()
 {
     auto socket = qobject_cast<QLocalSocket*>(QObject::sender());
     m_socketList.removeOne(socket);
+    m_connections.remove(socket);
 }
@@ -18,6 +18,8 @@
 #ifndef KEEPASSXC_NATIVEMESSAGINGHOST_H
 #define KEEPASSXC_NATIVEMESSAGINGHOST_H
 
+#include <QElapsedTimer>
+#include <QHash>
 #include <QJsonObject>
 #include <QObject>
 #include <QPointer>
@@ -31,6 +33,13 @@ class BrowserHost : public QObject
     Q_OBJECT
 
 public:
+    struct ActionLatency
+    {
+        int count = 0;
+        qint64 totalNsecs = 0;
+        qint64 maxNsecs = 0;
+    };
+
     explicit BrowserHost(QObject* parent = nullptr);
     ~BrowserHost() override;
 
@@ -40,6 +49,8 @@ public:
     void broadcastClientMessage(const QJsonObject& json);
     void sendClientMessage(QLocalSocket* socket, const QJsonObject& json);
 
+    QHash<QString, ActionLatency> actionLatencies() const;
+
 signals:
     void clientMessageReceived(QLocalSocket* socket, const QJsonObject& json);
 
@@ -49,11 +60,28 @@ private slots:
     void proxyDisconnected();
 
 private:
+    struct PendingMessage
+    {
+        QJsonObject json;
+        qint64 receivedAt;
+    };
+
+    struct ProxyConnection
+    {
+        QByteArray buffer;
+        QList<PendingMessage> pending;
+        bool processing = false;
+    };
+
+    void processProxyMessages(QLocalSocket* socket);
     void sendClientData(QLocalSocket* socket, const QString& data);
 
 private:
     QPointer<QLocalServer> m_localServer;
     QList<QLocalSocket*> m_socketList;
+    QHash<QLocalSocket*, ProxyConnection> m_connections;
+    QHash<QString, ActionLatency> m_actionLatencies;
+    QElapsedTimer m_clock;
 };
 
 #endif // KEEPASSXC_NATIVEMESSAGINGHOST_H
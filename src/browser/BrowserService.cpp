@@ -24,6 +24,7 @@
 #include "BrowserHost.h"
 #include "BrowserMessageBuilder.h"
 #include "BrowserSettings.h"
+#include "core/DatabaseQueryExecutor.h"
 #include "core/Tools.h"
 #include "core/UrlTools.h"
 #include "gui/MainWindow.h"
@@ -554,6 +555,31 @@ bool BrowserService::isPasswordGeneratorRequested() const
     return m_passwordGenerator && m_passwordGenerator->isVisible();
 }
 
+/**
+ * Describe the browser integration for the debug info, including how long
+ * the handling of each action took on average and at most.
+ */
+QString BrowserService::debugInfo() const
+{
+    const auto latencies = m_browserHost->actionLatencies();
+    if (latencies.isEmpty()) {
+        return {};
+    }
+
+    QString debugInfo = tr("Browser integration actions:").append("\n");
+    auto actions = latencies.keys();
+    actions.sort();
+    for (const auto& action : actions) {
+        const auto& stats = latencies.value(action);
+        debugInfo.append(QString("- %1: %2 calls, avg %3 ms, max %4 ms\n")
+                             .arg(action)
+                             .arg(stats.count)
+                             .arg(stats.totalNsecs / stats.count / 1000000.0, 0, 'f', 1)
+                             .arg(stats.maxNsecs / 1000000.0, 0, 'f', 1));
+    }
+    return debugInfo;
+}
+
 QString BrowserService::storeKey(const QString& key)
 {
     auto db = getDatabase();
@@ -983,13 +1009,14 @@ QList<Entry*> BrowserService::searchEntries(const QSharedPointer<Database>& db,
                                             const QStringList& keys,
                                             bool passkey)
 {
+    // The databases are searched concurrently, so only use the const accessors here
     QList<Entry*> entries;
-    auto* rootGroup = db->rootGroup();
+    const Group* rootGroup = asConst(*db).rootGroup();
     if (!rootGroup) {
         return entries;
     }
 
-    for (const auto& group : rootGroup->groupsRecursive(true)) {
+    for (const auto* group : rootGroup->groupsRecursive(true)) {
         if (group->isRecycled()
             || group->resolveCustomDataTriState(BrowserService::OPTION_HIDE_ENTRY) == Group::Enable) {
             continue;
@@ -1004,26 +1031,29 @@ QList<Entry*> BrowserService::searchEntries(const QSharedPointer<Database>& db,
         const auto omitWwwSubdomain =
             group->resolveCustomDataTriState(BrowserService::OPTION_OMIT_WWW) == Group::Enable;
 
-        for (auto* entry : group->entries()) {
+        auto isMatch = [&](const Entry* entry) {
             if (entry->isRecycled()
                 || (entry->customData()->contains(BrowserService::OPTION_HIDE_ENTRY)
                     && entry->customData()->value(BrowserService::OPTION_HIDE_ENTRY) == TRUE_STR)) {
-                continue;
+                return false;
             }
 
             if (!passkey && !shouldIncludeEntry(entry, siteUrl, formUrl, omitWwwSubdomain)) {
-                continue;
+                return false;
             }
 
 #ifdef WITH_XC_BROWSER_PASSKEYS
             // With Passkeys, check for the Relying Party instead of URL
             if (passkey && entry->attributes()->value(BrowserPasskeys::KPEX_PASSKEY_RELYING_PARTY) != siteUrl) {
-                continue;
+                return false;
             }
 #endif
+            return true;
+        };
 
+        for (auto* entry : group->entries()) {
             // Additional URL check may have already inserted the entry to the list
-            if (!entries.contains(entry)) {
+            if (isMatch(entry) && !entries.contains(entry)) {
                 entries.append(entry);
             }
         }
@@ -1073,9 +1103,9 @@ QList<Entry*> BrowserService::searchEntries(const QString& siteUrl,
     QString hostname = QUrl(siteUrl).host();
     QList<Entry*> entries;
     do {
-        for (const auto& db : databases) {
-            entries << searchEntries(db, siteUrl, formUrl, keys, passkey);
-        }
+        entries = DatabaseQueryExecutor::run<Entry*>(databases, [&](const QSharedPointer<Database>& db) {
+            return searchEntries(db, siteUrl, formUrl, keys, passkey);
+        });
     } while (entries.isEmpty() && removeFirstDomain(hostname));
 
     return entries;
@@ -1331,7 +1361,7 @@ bool BrowserService::removeFirstDomain(QString& hostname)
 
 /* Test if a search URL matches a custom entry. If the URL has the schema "keepassxc", some special checks will be made.
  * Otherwise, this simply delegates to handleURL(). */
-bool BrowserService::shouldIncludeEntry(Entry* entry,
+bool BrowserService::shouldIncludeEntry(const Entry* entry,
                                         const QString& url,
                                         const QString& submitUrl,
                                         const bool omitWwwSubdomain)
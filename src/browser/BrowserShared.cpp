@@ -57,4 +57,39 @@ namespace BrowserShared
         return QStandardPaths::writableLocation(QStandardPaths::TempLocation) + serverName;
 #endif
     }
+
+    /**
+     * Messages between KeePassXC and the proxy are plain JSON documents without any framing,
+     * so several of them may arrive in a single read. This finds where the first one ends.
+     *
+     * @param data received bytes
+     * @param offset position of the first byte of the message in data
+     * @return length of the complete JSON object or array at offset, or -1 if it is still incomplete
+     */
+    int jsonMessageLength(const QByteArray& data, int offset)
+    {
+        int depth = 0;
+        bool inString = false;
+        bool escaped = false;
+        const char* bytes = data.constData();
+        for (int i = offset; i < data.size(); ++i) {
+            const char c = bytes[i];
+            if (inString) {
+                if (escaped) {
+                    escaped = false;
+                } else if (c == '\\') {
+                    escaped = true;
+                } else if (c == '"') {
+                    inString = false;
+                }
+            } else if (c == '"') {
+                inString = true;
+            } else if (c == '{' || c == '[') {
+                ++depth;
+            } else if ((c == '}' || c == ']') && --depth <= 0) {
+                return i - offset + 1;
+            }
+        }
+        return -1;
+    }
 } // namespace BrowserShared
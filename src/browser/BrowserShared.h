@@ -18,6 +18,7 @@
 #ifndef KEEPASSXC_BROWSERSHARED_H
 #define KEEPASSXC_BROWSERSHARED_H
 
+#include <QByteArray>
 #include <QString>
 
 namespace BrowserShared
@@ -38,6 +39,7 @@ namespace BrowserShared
     };
 
     QString localServerPath();
+    int jsonMessageLength(const QByteArray& data, int offset = 0);
 } // namespace BrowserShared
 
 #endif // KEEPASSXC_BROWSERSHARED_H
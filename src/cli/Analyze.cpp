@@ -87,10 +87,7 @@ int Analyze::executeWithDatabase(QSharedPointer<Database> database, QSharedPoint
         const auto entry = finding.first;
         auto count = finding.second;
 
-        QString path = entry->title();
-        for (auto g = entry->group(); g && g != g->database()->rootGroup(); g = g->parentGroup()) {
-            path.prepend("/").prepend(g->name());
-        }
+        QString path = entry->path();
 
         if (count > 0) {
             out << QObject::tr("Password for '%1' has been leaked %2 time(s)!", "", count).arg(path).arg(count)
@@ -26,13 +26,18 @@
 
 #include <QCommandLineParser>
 
+const QCommandLineOption DatabaseInfo::TimingsOption =
+    QCommandLineOption(QStringList() << "timings",
+                       QObject::tr("Show the time spent in each phase of opening the database."));
+
 DatabaseInfo::DatabaseInfo()
 {
     name = QString("db-info");
     description = QObject::tr("Show a database's information.");
+    options.append(DatabaseInfo::TimingsOption);
 }
 
-int DatabaseInfo::executeWithDatabase(QSharedPointer<Database> database, QSharedPointer<QCommandLineParser>)
+int DatabaseInfo::executeWithDatabase(QSharedPointer<Database> database, QSharedPointer<QCommandLineParser> parser)
 {
     auto& out = Utils::STDOUT;
 
@@ -70,5 +75,15 @@ int DatabaseInfo::executeWithDatabase(QSharedPointer<Database> database, QShared
     out << QObject::tr("Average password length") << ": " << QObject::tr("%1 characters").arg(stats.averagePwdLength())
         << Qt::endl;
 
+    if (parser->isSet(DatabaseInfo::TimingsOption)) {
+        const auto& timings = database->openTimings();
+        out << QObject::tr("Open timings") << ":" << Qt::endl;
+        for (const auto& phase : timings.phases()) {
+            out << "  " << phase.name << ": " << QObject::tr("%1 ms").arg(phase.nsecs / 1e6, 0, 'f', 2) << Qt::endl;
+        }
+        out << "  " << QObject::tr("total") << ": " << QObject::tr("%1 ms").arg(timings.total() / 1e6, 0, 'f', 2)
+            << Qt::endl;
+    }
+
     return EXIT_SUCCESS;
 }
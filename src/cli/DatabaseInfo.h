@@ -26,6 +26,8 @@ public:
     DatabaseInfo();
 
     int executeWithDatabase(QSharedPointer<Database> db, QSharedPointer<QCommandLineParser> parser) override;
+
+    static const QCommandLineOption TimingsOption;
 };
 
 #endif // KEEPASSXC_DATABASEINFO_H
@@ -29,27 +29,40 @@ const QCommandLineOption Estimate::AdvancedOption =
                                      << "advanced",
                        QObject::tr("Perform advanced analysis on the password."));
 
+const QCommandLineOption Estimate::StdinOption =
+    QCommandLineOption(QStringList() << "s"
+                                     << "stdin",
+                       QObject::tr("Estimate all passwords read from standard input, one per line."));
+
+// Number of passwords read from standard input and estimated in parallel at once
+static const int STDIN_BATCH_SIZE = 1024;
+
 Estimate::Estimate()
 {
     name = QString("estimate");
     optionalArguments.append(
         {QString("password"), QObject::tr("Password for which to estimate the entropy."), QString("[password]")});
     options.append(Estimate::AdvancedOption);
+    options.append(Estimate::StdinOption);
     description = QObject::tr("Estimate the entropy of a password.");
 }
 
+static void printEstimate(int len, double e)
+{
+    // clang-format off
+    Utils::STDOUT << QObject::tr("Length %1").arg(len, 0) << '\t'
+                  << QObject::tr("Entropy %1").arg(e, 0, 'f', 3) << '\t'
+                  << QObject::tr("Log10 %1").arg(e * 0.301029996, 0, 'f', 3) << Qt::endl;
+    // clang-format on
+}
+
 static void estimate(const char* pwd, bool advanced)
 {
     auto& out = Utils::STDOUT;
 
     auto len = static_cast<int>(strlen(pwd));
     if (!advanced) {
-        const auto e = PasswordHealth(pwd).entropy();
-        // clang-format off
-        out << QObject::tr("Length %1").arg(len, 0) << '\t'
-            << QObject::tr("Entropy %1").arg(e, 0, 'f', 3) << '\t'
-            << QObject::tr("Log10 %1").arg(e * 0.301029996, 0, 'f', 3) << Qt::endl;
-        // clang-format on
+        printEstimate(len, PasswordHealth(pwd).entropy());
     } else {
         int pwdLen = 0;
         ZxcMatch_t *info, *p;
@@ -147,6 +160,35 @@ static void estimate(const char* pwd, bool advanced)
     }
 }
 
+/**
+ * Estimate the passwords read from standard input until its end. The input is read in
+ * batches that are estimated in parallel, the results keep the order of the input.
+ */
+static void estimateStdin(bool advanced)
+{
+    auto& in = Utils::STDIN;
+
+    QStringList passwords;
+    while (!in.atEnd()) {
+        passwords.clear();
+        while (passwords.size() < STDIN_BATCH_SIZE && !in.atEnd()) {
+            passwords.append(in.readLine());
+        }
+
+        if (advanced) {
+            for (const auto& pwd : asConst(passwords)) {
+                estimate(pwd.toUtf8(), true);
+            }
+            continue;
+        }
+
+        const auto entropies = PasswordHealth::estimateEntropies(passwords);
+        for (int i = 0; i < passwords.size(); ++i) {
+            printEstimate(passwords[i].toUtf8().size(), entropies[i]);
+        }
+    }
+}
+
 int Estimate::execute(const QStringList& arguments)
 {
     QSharedPointer<QCommandLineParser> parser = getCommandLineParser(arguments);
@@ -157,6 +199,15 @@ int Estimate::execute(const QStringList& arguments)
     auto& in = Utils::STDIN;
     const QStringList args = parser->positionalArguments();
 
+    if (parser->isSet(Estimate::StdinOption)) {
+        if (!args.isEmpty()) {
+            Utils::STDERR << QObject::tr("Cannot combine a password argument with --stdin.") << Qt::endl;
+            return EXIT_FAILURE;
+        }
+        estimateStdin(parser->isSet(Estimate::AdvancedOption));
+        return EXIT_SUCCESS;
+    }
+
     QString password;
     if (args.size() == 1) {
         password = args.at(0);
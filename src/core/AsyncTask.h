@@ -45,12 +45,19 @@ namespace AsyncTask
 
     /**
      * Run a given task and wait for it to finish without blocking the event loop.
+     * Outside the GUI thread the task runs directly: there is no event loop to keep
+     * running, and a pool thread waiting for another task of the same pool can
+     * deadlock once all threads of the pool are waiting.
      *
      * @param task std::function object to run
      * @return async task result
      */
     template <typename FunctionObject> decltype(auto) runAndWaitForFuture(FunctionObject task)
     {
+        auto app = QCoreApplication::instance();
+        if (app && QThread::currentThread() != app->thread()) {
+            return task();
+        }
         return waitForFuture(QtConcurrent::run(task));
     }
 
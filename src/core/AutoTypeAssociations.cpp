@@ -32,6 +32,16 @@ AutoTypeAssociations::AutoTypeAssociations(QObject* parent)
 {
 }
 
+/**
+ * Share the storage with other if both hold the same associations.
+ */
+void AutoTypeAssociations::shareDataWith(const AutoTypeAssociations* other)
+{
+    if (m_associations == other->m_associations) {
+        m_associations = other->m_associations;
+    }
+}
+
 void AutoTypeAssociations::copyDataFrom(const AutoTypeAssociations* other)
 {
     if (m_associations == other->m_associations) {
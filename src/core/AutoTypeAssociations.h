@@ -36,6 +36,7 @@ public:
 
     explicit AutoTypeAssociations(QObject* parent = nullptr);
     void copyDataFrom(const AutoTypeAssociations* other);
+    void shareDataWith(const AutoTypeAssociations* other);
     void add(const AutoTypeAssociations::Association& association);
     void remove(int index);
     void removeEmpty();
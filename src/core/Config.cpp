@@ -146,6 +146,9 @@ static const QHash<Config::ConfigKey, ConfigDirective> configStrings = {
     {Config::Security_EnableCopyOnDoubleClick,{QS("Security/EnableCopyOnDoubleClick"), Roaming, false}},
     {Config::Security_QuickUnlock, {QS("Security/QuickUnlock"), Local, true}},
     {Config::Security_DatabasePasswordMinimumQuality, {QS("Security/DatabasePasswordMinimumQuality"), Local, 0}},
+    {Config::Security_PersistPasswordHealth, {QS("Security/PersistPasswordHealth"), Roaming, false}},
+    {Config::Security_OpenCache, {QS("Security/OpenCache"), Local, false}},
+    {Config::Security_HibpCache, {QS("Security/HibpCache"), Local, false}},
 
     // Browser
     {Config::Browser_Enabled, {QS("Browser/Enabled"), Roaming, false}},
@@ -225,14 +228,57 @@ static const QHash<Config::ConfigKey, ConfigDirective> configStrings = {
 
 QPointer<Config> Config::m_instance(nullptr);
 
+/**
+ * Get the current value of a setting.
+ * Values are served from an in-memory snapshot of the settings, so this is cheap enough to be called per entry
+ * or row, and safe to call from worker threads while the settings are changed on the GUI thread.
+ */
 QVariant Config::get(ConfigKey key)
 {
-    auto cfg = configStrings[key];
-    auto defaultValue = configStrings[key].defaultValue;
+    return values()->value(key);
+}
+
+QSharedPointer<const QVector<QVariant>> Config::values() const
+{
+    QMutexLocker locker(&m_valuesMutex);
+    return m_values;
+}
+
+void Config::publishValues(const QVector<QVariant>& values)
+{
+    QSharedPointer<const QVector<QVariant>> snapshot(new QVector<QVariant>(values));
+    QMutexLocker locker(&m_valuesMutex);
+    m_values.swap(snapshot);
+}
+
+/**
+ * Read a setting from the settings files. Booleans and numbers are converted to the type
+ * of their default value, as INI files store them as strings.
+ */
+QVariant Config::readValue(ConfigKey key) const
+{
+    const auto& cfg = configStrings[key];
+    QVariant value;
     if (m_localSettings && cfg.type == Local) {
-        return m_localSettings->value(cfg.name, defaultValue);
+        value = m_localSettings->value(cfg.name, cfg.defaultValue);
+    } else {
+        value = m_settings->value(cfg.name, cfg.defaultValue);
+    }
+
+    const auto type = cfg.defaultValue.userType();
+    if ((type == QMetaType::Bool || type == QMetaType::Int) && value.userType() != type && value.canConvert(type)) {
+        value.convert(type);
+    }
+    return value;
+}
+
+void Config::loadValues()
+{
+    QVector<QVariant> values(Deleted + 1);
+    for (auto it = configStrings.constBegin(); it != configStrings.constEnd(); ++it) {
+        values[it.key()] = readValue(it.key());
     }
-    return m_settings->value(cfg.name, defaultValue);
+    publishValues(values);
 }
 
 QVariant Config::getDefault(Config::ConfigKey key)
@@ -262,6 +308,9 @@ void Config::set(ConfigKey key, const QVariant& value)
     } else {
         m_settings->setValue(cfg.name, value);
     }
+    auto updated = *values();
+    updated[key] = value;
+    publishValues(updated);
 
     emit changed(key);
 }
@@ -274,6 +323,9 @@ void Config::remove(ConfigKey key)
     } else {
         m_settings->remove(cfg.name);
     }
+    auto updated = *values();
+    updated[key] = readValue(key);
+    publishValues(updated);
 
     emit changed(key);
 }
@@ -291,6 +343,8 @@ void Config::sync()
     if (m_localSettings) {
         m_localSettings->sync();
     }
+    // Syncing also picks up changes made to the files by other instances
+    loadValues();
 }
 
 void Config::resetToDefaults()
@@ -299,6 +353,7 @@ void Config::resetToDefaults()
     if (m_localSettings) {
         m_localSettings->clear();
     }
+    loadValues();
 }
 
 /**
@@ -502,7 +557,10 @@ void Config::init(const QString& configFileName, const QString& localConfigFileN
         m_localSettings.reset(new QSettings(localConfigFileName, QSettings::IniFormat));
     }
 
+    loadValues();
     migrate();
+    // Migration may have moved settings between files
+    loadValues();
     connect(qApp, &QCoreApplication::aboutToQuit, this, &Config::sync);
 }
 
@@ -19,7 +19,9 @@
 #ifndef KEEPASSX_CONFIG_H
 #define KEEPASSX_CONFIG_H
 
+#include <QMutex>
 #include <QPointer>
+#include <QSharedPointer>
 #include <QVariant>
 #include <QVector>
 
@@ -127,6 +129,9 @@ public:
         Security_EnableCopyOnDoubleClick,
         Security_QuickUnlock,
         Security_DatabasePasswordMinimumQuality,
+        Security_PersistPasswordHealth,
+        Security_OpenCache,
+        Security_HibpCache,
 
         Browser_Enabled,
         Browser_ShowNotification,
@@ -233,6 +238,10 @@ private:
     explicit Config(QObject* parent);
     void init(const QString& configFileName, const QString& localConfigFileName);
     void migrate();
+    void loadValues();
+    void publishValues(const QVector<QVariant>& values);
+    QSharedPointer<const QVector<QVariant>> values() const;
+    QVariant readValue(ConfigKey key) const;
     static QPair<QString, QString> defaultConfigFiles();
 
     static QPointer<Config> m_instance;
@@ -240,6 +249,9 @@ private:
     QScopedPointer<QSettings> m_settings;
     QScopedPointer<QSettings> m_localSettings;
     QHash<QString, QVariant> m_defaults;
+    // Immutable snapshot of all values, replaced as a whole so that get() is safe from any thread
+    QSharedPointer<const QVector<QVariant>> m_values;
+    mutable QMutex m_valuesMutex;
 };
 
 inline Config* config()
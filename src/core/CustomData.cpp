@@ -28,6 +28,7 @@ const QString CustomData::ExcludeFromReportsLegacy = QStringLiteral("KnownBad");
 const QString CustomData::FdoSecretsExposedGroup = QStringLiteral("FDO_SECRETS_EXPOSED_GROUP");
 const QString CustomData::RandomSlug = QStringLiteral("KPXC_RANDOM_SLUG");
 const QString CustomData::RemoteProgramSettings = QStringLiteral("KPXC_REMOTE_SYNC_SETTINGS");
+const QString CustomData::PasswordHealthCache = QStringLiteral("KPXC_PASSWORD_HEALTH_CACHE");
 
 // Fallback item for return by reference
 static const CustomData::CustomDataItem NULL_ITEM{};
@@ -97,6 +98,8 @@ void CustomData::set(const QString& key, CustomDataItem item)
 
     if (addAttribute) {
         emit added(key);
+    } else if (changeValue) {
+        emit valueChanged(key);
     }
 }
 
@@ -140,6 +143,16 @@ void CustomData::rename(const QString& oldKey, const QString& newKey)
     emit renamed(oldKey, newKey);
 }
 
+/**
+ * Share the storage with other if both hold the same data.
+ */
+void CustomData::shareDataWith(const CustomData* other)
+{
+    if (m_data == other->m_data) {
+        m_data = other->m_data;
+    }
+}
+
 void CustomData::copyDataFrom(const CustomData* other)
 {
     if (*this == *other) {
@@ -192,12 +205,12 @@ void CustomData::updateLastModified(QDateTime lastModified)
 bool CustomData::isProtected(const QString& key) const
 {
     return key.startsWith(BrowserKeyPrefix) || key == Created || key == FdoSecretsExposedGroup
-           || key == CustomData::RemoteProgramSettings;
+           || key == CustomData::RemoteProgramSettings || key == PasswordHealthCache;
 }
 
 bool CustomData::isAutoGenerated(const QString& key) const
 {
-    return key == LastModified || key == RandomSlug;
+    return key == LastModified || key == RandomSlug || key == PasswordHealthCache;
 }
 
 bool CustomData::operator==(const CustomData& other) const
@@ -61,6 +61,7 @@ public:
     int size() const;
     int dataSize() const;
     void copyDataFrom(const CustomData* other);
+    void shareDataWith(const CustomData* other);
     bool operator==(const CustomData& other) const;
     bool operator!=(const CustomData& other) const;
 
@@ -72,6 +73,7 @@ public:
     static const QString FdoSecretsExposedGroup;
     static const QString RandomSlug;
     static const QString RemoteProgramSettings;
+    static const QString PasswordHealthCache;
 
     // Pre-KDBX 4.1
     static const QString ExcludeFromReportsLegacy;
@@ -79,6 +81,7 @@ public:
 signals:
     void aboutToBeAdded(const QString& key);
     void added(const QString& key);
+    void valueChanged(const QString& key);
     void aboutToBeRemoved(const QString& key);
     void removed(const QString& key);
     void aboutToRename(const QString& oldKey, const QString& newKey);
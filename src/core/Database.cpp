@@ -19,13 +19,19 @@
 #include "Database.h"
 
 #include "core/AsyncTask.h"
+#include "core/Config.h"
 #include "core/FileWatcher.h"
 #include "core/Group.h"
+#include "core/PasswordHealth.h"
+#include "crypto/CryptoHash.h"
 #include "crypto/Random.h"
+#include "format/DatabaseOpenCache.h"
 #include "format/KdbxXmlReader.h"
 #include "format/KeePass2Reader.h"
 #include "format/KeePass2Writer.h"
 
+#include <QBuffer>
+#include <QElapsedTimer>
 #include <QFileInfo>
 #include <QJsonObject>
 #include <QRegularExpression>
@@ -38,15 +44,18 @@
 #endif
 
 QHash<QUuid, QPointer<Database>> Database::s_uuidMap;
+QMutex Database::s_uuidMapMutex;
 
 Database::Database()
     : m_metadata(new Metadata(this))
     , m_data()
     , m_rootGroup(nullptr)
     , m_fileWatcher(new FileWatcher(this))
+    , m_passwordHealthCache(new PasswordHealthCache())
     , m_uuid(QUuid::createUuid())
 {
-    // setup modified timer
+    // setup modified timer, parented so it follows the database to other threads
+    m_modifiedTimer.setParent(this);
     m_modifiedTimer.setSingleShot(true);
     connect(this, &Database::emitModifiedChanged, this, [this](bool value) {
         if (!value) {
@@ -58,15 +67,41 @@ Database::Database()
     // other signals
     connect(m_metadata, &Metadata::modified, this, &Database::markAsModified);
     connect(this, &Database::databaseOpened, this, [this]() {
+        rebuildEntryIndex();
         updateCommonUsernames();
         updateTagList();
     });
-    connect(this, &Database::modified, this, [this] { updateTagList(); });
-    connect(this, &Database::databaseSaved, this, [this]() { updateCommonUsernames(); });
+    connect(this, &Database::modified, this, [this] {
+        if (m_tagListChanged) {
+            updateTagList();
+        }
+        if (m_usernamesChanged) {
+            updateCommonUsernames();
+        }
+    });
+    connect(this, &Database::groupAboutToMove, this, [this](Group* group) { m_movingGroup = group; });
+    connect(this, &Database::groupMoved, this, [this] {
+        // Moving a group in or out of the recycle bin changes which entries contribute tags
+        if (m_movingGroup) {
+            reindexEntries(m_movingGroup);
+            m_movingGroup.clear();
+        }
+    });
+    connect(m_metadata, &Metadata::modified, this, [this] {
+        if (m_metadata->recycleBin() != m_indexedRecycleBin) {
+            auto oldRecycleBin = m_indexedRecycleBin;
+            m_indexedRecycleBin = m_metadata->recycleBin();
+            reindexEntries(oldRecycleBin);
+            reindexEntries(m_indexedRecycleBin);
+        }
+    });
     connect(m_fileWatcher, &FileWatcher::fileChanged, this, &Database::databaseFileChanged);
 
-    // static uuid map
-    s_uuidMap.insert(m_uuid, this);
+    // static uuid map, databases may be created on worker threads while they are opened
+    {
+        QMutexLocker locker(&s_uuidMapMutex);
+        s_uuidMap.insert(m_uuid, this);
+    }
 
     // block modified signal and set root group
     setEmitModified(false);
@@ -126,6 +161,27 @@ bool Database::open(QSharedPointer<const CompositeKey> key, QString* error)
  * @return true on success
  */
 bool Database::open(const QString& filePath, QSharedPointer<const CompositeKey> key, QString* error)
+{
+    if (!read(filePath, std::move(key), error)) {
+        return false;
+    }
+
+    completeOpen();
+    return true;
+}
+
+/**
+ * Read the database from a file without finishing the open, see completeOpen().
+ *
+ * This is the expensive part of opening a database. It does not touch any other
+ * object, so a database created on a worker thread can be read on that thread.
+ *
+ * @param filePath path to the file
+ * @param key composite key for unlocking the database
+ * @param error error message in case of failure
+ * @return true on success
+ */
+bool Database::read(const QString& filePath, QSharedPointer<const CompositeKey> key, QString* error)
 {
     QFile dbFile(filePath);
     if (!dbFile.exists()) {
@@ -151,24 +207,106 @@ bool Database::open(const QString& filePath, QSharedPointer<const CompositeKey>
 
     setEmitModified(false);
 
-    KeePass2Reader reader;
-    if (!reader.readDatabase(&dbFile, std::move(key), this)) {
-        if (error) {
-            *error = tr("Error while reading the database: %1").arg(reader.errorString());
+    DatabaseOpenCache openCache(filePath);
+    if (key.isNull() || !config()->get(Config::Security_OpenCache).toBool()) {
+        if (!key.isNull()) {
+            openCache.remove();
         }
-        return false;
+
+        KeePass2Reader reader;
+        bool ok = reader.readDatabase(&dbFile, std::move(key), this);
+        m_openTimings = reader.timings();
+        if (!ok) {
+            if (error) {
+                *error = tr("Error while reading the database: %1").arg(reader.errorString());
+            }
+            return false;
+        }
+    } else {
+        // The cache is bound to the exact content of the file
+        QElapsedTimer timer;
+        timer.start();
+        QByteArray content = dbFile.readAll();
+        const auto contentHash = CryptoHash::hash(content, CryptoHash::Sha256);
+        const auto readTime = timer.nsecsElapsed();
+        QBuffer buffer(&content);
+        buffer.open(QIODevice::ReadOnly);
+
+        auto status = openCache.read(&buffer, contentHash, key, this);
+        if (status == DatabaseOpenCache::Status::Failed) {
+            m_openTimings = openCache.timings();
+            if (error) {
+                *error = tr("Error while reading the database: %1").arg(openCache.errorString());
+            }
+            return false;
+        }
+
+        if (status == DatabaseOpenCache::Status::Loaded) {
+            m_openTimings = openCache.timings();
+        } else {
+            buffer.seek(0);
+            KeePass2Reader reader;
+            bool ok = reader.readDatabase(&buffer, std::move(key), this);
+            m_openTimings = reader.timings();
+            if (!ok) {
+                if (error) {
+                    *error = tr("Error while reading the database: %1").arg(reader.errorString());
+                }
+                return false;
+            }
+
+            timer.restart();
+            if (m_data.formatVersion < KeePass2::FILE_VERSION_4) {
+                openCache.remove();
+            } else if (!openCache.write(contentHash, this)) {
+                qWarning("Failed to write the database cache: %s", qPrintable(openCache.errorString()));
+            }
+            m_openTimings.add(PhaseTimings::Cache, timer.nsecsElapsed());
+        }
+        m_openTimings.add(PhaseTimings::Read, readTime);
     }
 
     setFilePath(filePath);
     dbFile.close();
 
+    if (config()->get(Config::Security_PersistPasswordHealth).toBool()) {
+        m_passwordHealthCache->restore(m_metadata->customData()->value(CustomData::PasswordHealthCache));
+    }
+
+    return true;
+}
+
+/**
+ * Finish opening a database read by read(): mark it clean, announce it
+ * and start watching the file for changes.
+ */
+void Database::completeOpen()
+{
     markAsClean();
 
     emit databaseOpened();
     m_fileWatcher->start(canonicalFilePath(), 30, 1);
     setEmitModified(true);
+}
 
-    return true;
+/**
+ * Move the database with all of its groups, entries and history items to another thread.
+ * Has to be called from the thread the database currently lives in.
+ *
+ * @param thread target thread
+ */
+void Database::moveDataToThread(QThread* thread)
+{
+    moveToThread(thread);
+
+    // History items are not part of the object tree
+    if (m_rootGroup) {
+        for (auto* entry : m_rootGroup->entriesRecursive()) {
+            for (auto* historyItem : entry->historyItems()) {
+                historyItem->moveToThread(thread);
+            }
+        }
+    }
 }
 
 /**
@@ -192,6 +330,23 @@ bool Database::hasMinorVersionMismatch() const
     return m_data.formatVersion > KeePass2::FILE_VERSION_MAX;
 }
 
+/**
+ * @return time spent in the phases of the last read from file
+ */
+const PhaseTimings& Database::openTimings() const
+{
+    return m_openTimings;
+}
+
+/**
+ * @return time spent in the phases of the last save, including
+ *         committing the file to disk
+ */
+const PhaseTimings& Database::saveTimings() const
+{
+    return m_saveTimings;
+}
+
 bool Database::isSaving()
 {
     bool locked = m_saveMutex.tryLock();
@@ -278,6 +433,8 @@ bool Database::saveAs(const QString& filePath, SaveAction action, const QString&
     int length = Random::instance()->randomUIntRange(64, 512);
     m_metadata->customData()->set(CustomData::RandomSlug, Random::instance()->randomArray(length).toHex());
 
+    storePasswordHealthCache();
+
     // Prevent destructive operations while saving
     QMutexLocker locker(&m_saveMutex);
 
@@ -289,8 +446,19 @@ bool Database::saveAs(const QString& filePath, SaveAction action, const QString&
     bool isHidden = fileInfo.isHidden();
 #endif
 
-    bool ok = AsyncTask::runAndWaitForFuture([&] { return performSave(realFilePath, action, backupFilePath, error); });
+    bool ok = AsyncTask::runAndWaitForFuture([&] {
+        if (!performSave(realFilePath, action, backupFilePath, error)) {
+            return false;
+        }
+        updateOpenCache(realFilePath);
+        return true;
+    });
     if (ok) {
+        // The cache of the previous file would not be refreshed anymore
+        if (!m_data.filePath.isEmpty() && QFileInfo(m_data.filePath).canonicalFilePath() != realFilePath) {
+            DatabaseOpenCache(m_data.filePath).remove();
+        }
+
         setFilePath(filePath);
         markAsClean();
         if (isNewFile) {
@@ -312,6 +480,35 @@ bool Database::saveAs(const QString& filePath, SaveAction action, const QString&
     return ok;
 }
 
+/**
+ * Replace the open cache of a file that was just written, so the next open can use it.
+ *
+ * @param filePath path of the saved file
+ */
+void Database::updateOpenCache(const QString& filePath)
+{
+    DatabaseOpenCache openCache(filePath);
+    if (!config()->get(Config::Security_OpenCache).toBool() || m_data.formatVersion < KeePass2::FILE_VERSION_4) {
+        openCache.remove();
+        return;
+    }
+
+    QElapsedTimer timer;
+    timer.start();
+
+    QFile file(filePath);
+    if (!file.open(QIODevice::ReadOnly)) {
+        openCache.remove();
+        return;
+    }
+    if (!openCache.write(CryptoHash::hash(file.readAll(), CryptoHash::Sha256), this)) {
+        qWarning("Failed to write the database cache: %s", qPrintable(openCache.errorString()));
+        openCache.remove();
+    }
+
+    m_saveTimings.add(PhaseTimings::Cache, timer.nsecsElapsed());
+}
+
 bool Database::performSave(const QString& filePath, SaveAction action, const QString& backupFilePath, QString* error)
 {
     if (!backupFilePath.isNull()) {
@@ -333,7 +530,12 @@ bool Database::performSave(const QString& filePath, SaveAction action, const QSt
             // Retain original creation time
             saveFile.setFileTime(createTime, QFile::FileBirthTime);
 
-            if (saveFile.commit()) {
+            emit savePhaseStarted(PhaseTimings::Commit);
+            QElapsedTimer commitTimer;
+            commitTimer.start();
+            bool committed = saveFile.commit();
+            m_saveTimings.add(PhaseTimings::Commit, commitTimer.nsecsElapsed());
+            if (committed) {
                 // successfully saved database file
                 return true;
             }
@@ -351,6 +553,10 @@ bool Database::performSave(const QString& filePath, SaveAction action, const QSt
             if (!writeDatabase(&tempFile, error)) {
                 return false;
             }
+
+            emit savePhaseStarted(PhaseTimings::Commit);
+            QElapsedTimer commitTimer;
+            commitTimer.start();
             tempFile.close(); // flush to disk
 
             // Delete the original db and move the temp file in place
@@ -360,7 +566,9 @@ bool Database::performSave(const QString& filePath, SaveAction action, const QSt
             // Note: call into the QFile rename instead of QTemporaryFile
             // due to an undocumented difference in how the function handles
             // errors. This prevents errors when saving across file systems.
-            if (tempFile.QFile::rename(filePath)) {
+            bool renamed = tempFile.QFile::rename(filePath);
+            m_saveTimings.add(PhaseTimings::Commit, commitTimer.nsecsElapsed());
+            if (renamed) {
                 // successfully saved the database
                 tempFile.setAutoRemove(false);
                 QFile::setPermissions(filePath, perms);
@@ -390,7 +598,12 @@ bool Database::performSave(const QString& filePath, SaveAction action, const QSt
             if (!writeDatabase(&dbFile, error)) {
                 return false;
             }
+
+            emit savePhaseStarted(PhaseTimings::Commit);
+            QElapsedTimer commitTimer;
+            commitTimer.start();
             dbFile.close();
+            m_saveTimings.add(PhaseTimings::Commit, commitTimer.nsecsElapsed());
             return true;
         }
         if (error) {
@@ -418,6 +631,7 @@ bool Database::writeDatabase(QIODevice* device, QString* error)
     setEmitModified(false);
     writer.writeDatabase(device, this);
     setEmitModified(true);
+    m_saveTimings = writer.timings();
 
     if (writer.hasError()) {
         if (error) {
@@ -493,7 +707,10 @@ void Database::releaseData()
     setEmitModified(false);
     m_modified = false;
 
-    s_uuidMap.remove(m_uuid);
+    {
+        QMutexLocker uuidLocker(&s_uuidMapMutex);
+        s_uuidMap.remove(m_uuid);
+    }
     m_uuid = QUuid();
 
     m_data.clear();
@@ -508,6 +725,10 @@ void Database::releaseData()
     m_deletedObjects.clear();
     m_commonUsernames.clear();
     m_tagList.clear();
+    m_tagListChanged = false;
+    m_usernamesChanged = false;
+
+    m_passwordHealthCache->clear();
 }
 
 /**
@@ -589,6 +810,15 @@ Group* Database::setRootGroup(Group* group)
         emit databaseDiscarded();
     }
 
+    // The entries of the new root group are indexed as they get connected to this database
+    m_indexedEntries.clear();
+    m_tagCounts.clear();
+    m_usernameCounts.clear();
+    m_entryStatistics = {};
+    m_indexedRecycleBin = m_metadata->recycleBin();
+    m_tagListChanged = true;
+    m_usernamesChanged = true;
+
     auto oldRoot = m_rootGroup;
     m_rootGroup = group;
     m_rootGroup->setParent(this);
@@ -713,32 +943,207 @@ const QStringList& Database::tagList() const
 
 void Database::updateCommonUsernames(int topN)
 {
+    // Sort username/frequency pairs by frequency and name
+    QList<QPair<QString, int>> sortedUsernames;
+    sortedUsernames.reserve(m_usernameCounts.size());
+    for (auto it = m_usernameCounts.constBegin(); it != m_usernameCounts.constEnd(); ++it) {
+        sortedUsernames.append({it.key(), it.value()});
+    }
+
+    auto comparator = [](const QPair<QString, int>& arg1, const QPair<QString, int>& arg2) {
+        if (arg1.second == arg2.second) {
+            return arg1.first < arg2.first;
+        }
+        return arg1.second > arg2.second;
+    };
+
+    // Take first topN usernames if set
+    int actualUsernames = topN < 0 ? sortedUsernames.size() : std::min(topN, sortedUsernames.size());
+    std::partial_sort(
+        sortedUsernames.begin(), sortedUsernames.begin() + actualUsernames, sortedUsernames.end(), comparator);
+
     m_commonUsernames.clear();
-    m_commonUsernames.append(rootGroup()->usernamesRecursive(topN));
+    for (int i = 0; i < actualUsernames; ++i) {
+        m_commonUsernames.append(sortedUsernames[i].first);
+    }
+    m_usernamesChanged = false;
 }
 
 void Database::updateTagList()
 {
-    m_tagList.clear();
-    if (!m_rootGroup) {
-        emit tagListUpdated();
+    m_tagList = m_tagCounts.keys();
+    m_tagList.sort();
+    m_tagListChanged = false;
+    emit tagListUpdated();
+}
+
+namespace
+{
+    // Returns true if key was not counted before
+    bool addCount(QHash<QString, int>& counts, const QString& key)
+    {
+        return ++counts[key] == 1;
+    }
+
+    // Returns true if key is not counted anymore
+    bool removeCount(QHash<QString, int>& counts, const QString& key)
+    {
+        auto it = counts.find(key);
+        if (it == counts.end()) {
+            return false;
+        }
+        if (--it.value() > 0) {
+            return false;
+        }
+        counts.erase(it);
+        return true;
+    }
+} // namespace
+
+void Database::rebuildEntryIndex()
+{
+    m_indexedEntries.clear();
+    m_tagCounts.clear();
+    m_usernameCounts.clear();
+    m_entryStatistics = {};
+    m_indexedRecycleBin = m_metadata->recycleBin();
+    m_tagListChanged = true;
+    m_usernamesChanged = true;
+
+    if (m_rootGroup) {
+        for (const auto entry : m_rootGroup->entriesRecursive()) {
+            indexEntry(entry);
+        }
+    }
+}
+
+/**
+ * Update the tag and username counts and the entry statistics with the current state of entry.
+ * Only the difference to the previously indexed state is applied.
+ */
+void Database::indexEntry(const Entry* entry)
+{
+    IndexedEntry indexed;
+    if (!entry->isRecycled()) {
+        indexed.tags = entry->tagList();
+        indexed.counted = true;
+        indexed.passwordReference = entry->isAttributeReference(EntryAttributes::PasswordKey);
+        if (!indexed.passwordReference) {
+            indexed.password = entry->password();
+        }
+        indexed.excluded = entry->excludeFromReports();
+        indexed.expires = entry->timeInfo().expires();
+    }
+    const auto username = entry->username();
+    if (!username.isEmpty() && !entry->isAttributeReference(EntryAttributes::UserNameKey)) {
+        indexed.username = username;
+    }
+
+    auto it = m_indexedEntries.find(entry);
+    if (it == m_indexedEntries.end()) {
+        it = m_indexedEntries.insert(entry, {});
+    } else if (*it == indexed) {
         return;
     }
 
-    // Search groups recursively looking for tags
-    // Use a set to prevent adding duplicates
-    QSet<QString> tagSet;
-    for (auto entry : m_rootGroup->entriesRecursive()) {
-        if (!entry->isRecycled()) {
-            for (auto tag : entry->tagList()) {
-                tagSet.insert(tag);
-            }
+    updateStatistics(entry, *it, -1);
+    updateStatistics(entry, indexed, 1);
+
+    for (const auto& tag : asConst(it->tags)) {
+        m_tagListChanged |= removeCount(m_tagCounts, tag);
+    }
+    for (const auto& tag : asConst(indexed.tags)) {
+        m_tagListChanged |= addCount(m_tagCounts, tag);
+    }
+
+    if (it->username != indexed.username) {
+        if (!it->username.isEmpty()) {
+            removeCount(m_usernameCounts, it->username);
+        }
+        if (!indexed.username.isEmpty()) {
+            addCount(m_usernameCounts, indexed.username);
         }
+        m_usernamesChanged = true;
     }
 
-    m_tagList = tagSet.values();
-    m_tagList.sort();
-    emit tagListUpdated();
+    *it = indexed;
+}
+
+void Database::unindexEntry(const Entry* entry)
+{
+    auto it = m_indexedEntries.find(entry);
+    if (it == m_indexedEntries.end()) {
+        return;
+    }
+
+    updateStatistics(entry, *it, -1);
+
+    for (const auto& tag : asConst(it->tags)) {
+        m_tagListChanged |= removeCount(m_tagCounts, tag);
+    }
+    if (!it->username.isEmpty()) {
+        removeCount(m_usernameCounts, it->username);
+        m_usernamesChanged = true;
+    }
+
+    m_indexedEntries.erase(it);
+}
+
+/**
+ * Add (sign = 1) or remove (sign = -1) an indexed entry state to the entry statistics.
+ */
+void Database::updateStatistics(const Entry* entry, const IndexedEntry& indexed, int sign)
+{
+    if (!indexed.counted) {
+        return;
+    }
+
+    auto& stats = m_entryStatistics;
+    stats.entries += sign;
+
+    auto updateSet = [sign, entry](QSet<const Entry*>& set) {
+        if (sign > 0) {
+            set.insert(entry);
+        } else {
+            set.remove(entry);
+        }
+    };
+    if (indexed.expires) {
+        updateSet(stats.expiringEntries);
+    }
+    if (indexed.passwordReference) {
+        updateSet(stats.referenceEntries);
+    }
+
+    const auto& pwd = indexed.password;
+    if (pwd.isEmpty()) {
+        return;
+    }
+
+    stats.passwordEntries += sign;
+    stats.totalPasswordLength += sign * pwd.size();
+    if (pwd.size() < PasswordHealth::Length::Short) {
+        stats.shortPasswords += sign;
+    }
+    if (indexed.excluded) {
+        stats.excludedEntries += sign;
+    }
+    if (sign > 0) {
+        addCount(stats.passwords, pwd);
+    } else {
+        removeCount(stats.passwords, pwd);
+    }
+}
+
+void Database::reindexEntries(const Group* group)
+{
+    if (!group || group->database() != this) {
+        return;
+    }
+
+    for (const auto entry : group->entriesRecursive()) {
+        indexEntry(entry);
+    }
 }
 
 void Database::removeTag(const QString& tag)
@@ -747,9 +1152,19 @@ void Database::removeTag(const QString& tag)
         return;
     }
 
+    beginBatchUpdate();
     for (auto entry : m_rootGroup->entriesRecursive()) {
         entry->removeTag(tag);
     }
+    endBatchUpdate();
+}
+
+/**
+ * Entropy estimates of the passwords in this database, shared by all health checks.
+ */
+PasswordHealthCache* Database::passwordHealthCache() const
+{
+    return m_passwordHealthCache.data();
 }
 
 const QUuid& Database::cipher() const
@@ -902,6 +1317,33 @@ void Database::createRecycleBin()
     m_metadata->setRecycleBin(recycleBin);
 }
 
+/**
+ * Store the password health estimates of the current entries in the database, or
+ * remove them if that was disabled. They are encrypted together with the database.
+ */
+void Database::storePasswordHealthCache()
+{
+    auto customData = m_metadata->customData();
+    if (!config()->get(Config::Security_PersistPasswordHealth).toBool() || !m_rootGroup) {
+        if (customData->contains(CustomData::PasswordHealthCache)) {
+            customData->remove(CustomData::PasswordHealthCache);
+        }
+        return;
+    }
+
+    // The entry columns estimate the resolved password, the health check the plain one
+    QStringList passwords;
+    for (const auto* entry : m_rootGroup->entriesRecursive()) {
+        const auto password = entry->password();
+        passwords << password;
+        const auto resolved = entry->resolvePlaceholder(password);
+        if (resolved != password) {
+            passwords << resolved;
+        }
+    }
+    customData->set(CustomData::PasswordHealthCache, m_passwordHealthCache->store(passwords));
+}
+
 void Database::recycleEntry(Entry* entry)
 {
     if (m_metadata->recycleBinEnabled()) {
@@ -955,6 +1397,11 @@ bool Database::hasNonDataChanges() const
 void Database::markAsModified()
 {
     m_modified = true;
+    if (m_batchUpdateDepth > 0) {
+        // Coalesce into a single modified signal when the batch ends
+        m_modifiedDuringBatch = true;
+        return;
+    }
     if (modifiedSignalEnabled() && !m_modifiedTimer.isActive()) {
         // Small time delay prevents numerous consecutive saves due to repeated signals
         startModifiedTimer();
@@ -972,6 +1419,79 @@ void Database::markAsClean()
     }
 }
 
+/**
+ * Start a batch of bulk modifications, such as a merge or a tag rename.
+ *
+ * Until the matching endBatchUpdate() call the modified signal is deferred and
+ * models may coalesce their per-item change notifications. Entries and groups only
+ * note that they changed; their time info, TOTP settings and modified signals are
+ * updated once per object when the batch ends. Batches can be nested.
+ */
+void Database::beginBatchUpdate()
+{
+    if (m_batchUpdateDepth++ == 0) {
+        m_modifiedDuringBatch = false;
+        emit batchUpdateStarted();
+    }
+}
+
+void Database::endBatchUpdate()
+{
+    Q_ASSERT(m_batchUpdateDepth > 0);
+    if (m_batchUpdateDepth == 0 || --m_batchUpdateDepth > 0) {
+        return;
+    }
+
+    const auto groups = m_batchModifiedGroups;
+    const auto entries = m_batchModifiedEntries;
+    m_batchModifiedGroups.clear();
+    m_batchModifiedEntries.clear();
+    for (const auto& group : groups) {
+        if (group.first) {
+            group.first->emitDeferredModified(group.second);
+        }
+    }
+    for (const auto& entry : entries) {
+        if (entry.first) {
+            entry.first->emitDeferredModified(entry.second);
+        }
+    }
+
+    emit batchUpdateFinished();
+
+    if (m_modifiedDuringBatch) {
+        m_modifiedDuringBatch = false;
+        markAsModified();
+    }
+}
+
+bool Database::isBatchUpdating() const
+{
+    return m_batchUpdateDepth > 0;
+}
+
+void Database::deferModified(Entry* entry, bool updateTimeinfo)
+{
+    auto& modification = m_batchModifiedEntries[entry];
+    modification.first = entry;
+    modification.second = modification.second || updateTimeinfo;
+    if (modifiedSignalEnabled()) {
+        m_modified = true;
+        m_modifiedDuringBatch = true;
+    }
+}
+
+void Database::deferModified(Group* group, bool updateTimeinfo)
+{
+    auto& modification = m_batchModifiedGroups[group];
+    modification.first = group;
+    modification.second = modification.second || updateTimeinfo;
+    if (modifiedSignalEnabled()) {
+        m_modified = true;
+        m_modifiedDuringBatch = true;
+    }
+}
+
 void Database::markNonDataChange()
 {
     m_hasNonDataChange = true;
@@ -984,6 +1504,7 @@ void Database::markNonDataChange()
  */
 Database* Database::databaseByUuid(const QUuid& uuid)
 {
+    QMutexLocker locker(&s_uuidMapMutex);
     return s_uuidMap.value(uuid, nullptr);
 }
 
@@ -23,10 +23,12 @@
 #include <QHash>
 #include <QMutex>
 #include <QPointer>
+#include <QSet>
 #include <QTimer>
 
 #include "config-keepassx.h"
 #include "core/ModifiableObject.h"
+#include "core/PhaseTimings.h"
 #include "crypto/kdf/AesKdf.h"
 #include "format/KeePass2.h"
 #include "keys/CompositeKey.h"
@@ -37,7 +39,9 @@ enum class EntryReferenceType;
 class FileWatcher;
 class Group;
 class Metadata;
+class PasswordHealthCache;
 class QIODevice;
+class QThread;
 
 struct DeletedObject
 {
@@ -79,10 +83,14 @@ private:
     bool backupDatabase(const QString& filePath, const QString& destinationFilePath);
     bool restoreDatabase(const QString& filePath, const QString& fromBackupFilePath);
     bool performSave(const QString& filePath, SaveAction flags, const QString& backupFilePath, QString* error);
+    void updateOpenCache(const QString& filePath);
 
 public:
     bool open(QSharedPointer<const CompositeKey> key, QString* error = nullptr);
     bool open(const QString& filePath, QSharedPointer<const CompositeKey> key, QString* error = nullptr);
+    bool read(const QString& filePath, QSharedPointer<const CompositeKey> key, QString* error = nullptr);
+    void completeOpen();
+    void moveDataToThread(QThread* thread);
     bool save(SaveAction action = Atomic, const QString& backupFilePath = QString(), QString* error = nullptr);
     bool saveAs(const QString& filePath,
                 SaveAction action = Atomic,
@@ -95,6 +103,9 @@ public:
     void setFormatVersion(quint32 version);
     bool hasMinorVersionMismatch() const;
 
+    const PhaseTimings& openTimings() const;
+    const PhaseTimings& saveTimings() const;
+
     void releaseData();
 
     bool isInitialized() const;
@@ -132,6 +143,8 @@ public:
     const QStringList& tagList() const;
     void removeTag(const QString& tag);
 
+    PasswordHealthCache* passwordHealthCache() const;
+
     QSharedPointer<const CompositeKey> key() const;
     bool setKey(const QSharedPointer<const CompositeKey>& key,
                 bool updateChangedTime = true,
@@ -153,6 +166,10 @@ public:
     void markAsTemporaryDatabase();
     bool isTemporaryDatabase();
 
+    void beginBatchUpdate();
+    void endBatchUpdate();
+    bool isBatchUpdating() const;
+
     static Database* databaseByUuid(const QUuid& uuid);
 
 public slots:
@@ -173,10 +190,14 @@ signals:
     void groupMoved();
     void databaseOpened();
     void databaseSaved();
+    void openPhaseStarted(const QString& phase);
+    void savePhaseStarted(const QString& phase);
     void databaseDiscarded();
     void databaseFileChanged();
     void databaseNonDataChanged();
     void tagListUpdated();
+    void batchUpdateStarted();
+    void batchUpdateFinished();
 
 private:
     struct DatabaseData
@@ -221,7 +242,50 @@ private:
         }
     };
 
+    struct IndexedEntry
+    {
+        QStringList tags;
+        QString username;
+
+        // Statistics are only gathered outside the recycle bin
+        bool counted = false;
+        QString password; // Empty for references, their target may change without notice
+        bool passwordReference = false;
+        bool excluded = false;
+        bool expires = false;
+
+        bool operator==(const IndexedEntry& other) const
+        {
+            return tags == other.tags && username == other.username && counted == other.counted
+                   && password == other.password && passwordReference == other.passwordReference
+                   && excluded == other.excluded && expires == other.expires;
+        }
+    };
+
+    // Running totals of the indexed entries, see DatabaseStats
+    struct EntryStatistics
+    {
+        int entries = 0;
+        int passwordEntries = 0;
+        int shortPasswords = 0;
+        int excludedEntries = 0;
+        qint64 totalPasswordLength = 0;
+        QHash<QString, int> passwords;
+        QSet<const Entry*> expiringEntries;
+        QSet<const Entry*> referenceEntries;
+    };
+
     void createRecycleBin();
+    void storePasswordHealthCache();
+
+    void rebuildEntryIndex();
+    void indexEntry(const Entry* entry);
+    void unindexEntry(const Entry* entry);
+    void reindexEntries(const Group* group);
+    void updateStatistics(const Entry* entry, const IndexedEntry& indexed, int sign);
+
+    void deferModified(Entry* entry, bool updateTimeinfo);
+    void deferModified(Group* group, bool updateTimeinfo);
 
     void startModifiedTimer();
     void stopModifiedTimer();
@@ -235,14 +299,38 @@ private:
     QPointer<FileWatcher> m_fileWatcher;
     bool m_modified = false;
     bool m_hasNonDataChange = false;
+    int m_batchUpdateDepth = 0;
+    bool m_modifiedDuringBatch = false;
+    // Objects changed during a batch and whether their time info is to be updated
+    QHash<const Entry*, QPair<QPointer<Entry>, bool>> m_batchModifiedEntries;
+    QHash<const Group*, QPair<QPointer<Group>, bool>> m_batchModifiedGroups;
     QString m_keyError;
     bool m_isTemporaryDatabase = false;
+    PhaseTimings m_openTimings;
+    PhaseTimings m_saveTimings;
+
+    // Reference counted tags and usernames of all entries, kept up to date on every change
+    QHash<const Entry*, IndexedEntry> m_indexedEntries;
+    QHash<QString, int> m_tagCounts;
+    QHash<QString, int> m_usernameCounts;
+    QPointer<const Group> m_indexedRecycleBin;
+    QPointer<Group> m_movingGroup;
+    EntryStatistics m_entryStatistics;
+    bool m_tagListChanged = false;
+    bool m_usernamesChanged = false;
 
     QStringList m_commonUsernames;
     QStringList m_tagList;
 
+    QScopedPointer<PasswordHealthCache> m_passwordHealthCache;
+
+    friend class DatabaseStats;
+    friend class Entry;
+    friend class Group;
+
     QUuid m_uuid;
     static QHash<QUuid, QPointer<Database>> s_uuidMap;
+    static QMutex s_uuidMapMutex;
 };
 
 #endif // KEEPASSX_DATABASE_H
@@ -0,0 +1,72 @@
+/*
+ *  Copyright (C) 2024 KeePassXC Team <team@keepassxc.org>
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 2 or (at your option)
+ *  version 3 of the License.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef KEEPASSXC_DATABASEQUERYEXECUTOR_H
+#define KEEPASSXC_DATABASEQUERYEXECUTOR_H
+
+#include <QSharedPointer>
+#include <QtConcurrent>
+
+class Database;
+
+/**
+ * Run read-only queries on several databases at once, one database per thread of the global thread pool.
+ *
+ * The calling thread blocks without processing events until all databases are done, so the databases
+ * can not be changed while they are queried. Each database is only accessed by a single thread, the query
+ * must not modify it or access any other database.
+ */
+namespace DatabaseQueryExecutor
+{
+
+    /**
+     * Run the query on all databases and merge the results in the order of the databases.
+     *
+     * @param databases databases to query
+     * @param query function returning the results of a single database
+     * @return merged results
+     */
+    template <typename T, typename Query> QList<T> run(const QList<QSharedPointer<Database>>& databases, Query query)
+    {
+        if (databases.size() == 1) {
+            return query(databases.first());
+        }
+
+        struct Task
+        {
+            QSharedPointer<Database> db;
+            QList<T> results;
+        };
+
+        QVector<Task> tasks;
+        tasks.reserve(databases.size());
+        for (const auto& db : databases) {
+            tasks.append({db, {}});
+        }
+
+        QtConcurrent::blockingMap(tasks, [&](Task& task) { task.results = query(task.db); });
+
+        QList<T> results;
+        for (const auto& task : tasks) {
+            results.append(task.results);
+        }
+        return results;
+    }
+
+}; // namespace DatabaseQueryExecutor
+
+#endif // KEEPASSXC_DATABASEQUERYEXECUTOR_H
@@ -21,7 +21,7 @@ DatabaseStats::DatabaseStats(QSharedPointer<Database> db)
     : modified(QFileInfo(db->filePath()).lastModified())
     , m_db(db)
 {
-    gatherStats(db->rootGroup()->groupsRecursive(true));
+    gatherStats();
 }
 
 // Get average password length
@@ -35,11 +35,7 @@ int DatabaseStats::averagePwdLength() const
 // share the same password)
 int DatabaseStats::maxPwdReuse() const
 {
-    int ret = 0;
-    for (const auto& count : m_passwords) {
-        ret = std::max(ret, count);
-    }
-    return ret;
+    return m_maxPwdReuse;
 }
 
 // A warning sign is displayed if one of the
@@ -64,56 +60,90 @@ bool DatabaseStats::isAvgPwdTooShort() const
     return averagePwdLength() < 10;
 }
 
-void DatabaseStats::gatherStats(const QList<Group*>& groups)
+/**
+ * Read the statistics from the entry index of the database, which is kept up to date
+ * on every change. Only the password strength and expiry, which depend on the current
+ * time, and passwords given by references, whose target may change, are evaluated here.
+ */
+void DatabaseStats::gatherStats()
 {
-    auto checker = HealthChecker(m_db);
-
-    for (const auto* group : groups) {
+    for (const auto* group : m_db->rootGroup()->groupsRecursive(true)) {
         // Don't count anything in the recycle bin
-        if (group->isRecycled()) {
+        if (!group->isRecycled()) {
+            ++groupCount;
+        }
+    }
+
+    const auto& indexed = m_db->m_entryStatistics;
+    entryCount = indexed.entries;
+    excludedEntries = indexed.excludedEntries;
+    shortPasswords = indexed.shortPasswords;
+    totalPasswordLength = static_cast<int>(indexed.totalPasswordLength);
+    int passwordEntries = indexed.passwordEntries;
+
+    // Passwords given by a reference count as used, but not as re-used in the health check
+    const auto& checkedPasswords = indexed.passwords;
+    auto passwords = indexed.passwords;
+    for (const auto* entry : indexed.referenceEntries) {
+        const auto pwd = entry->password();
+        if (pwd.isEmpty()) {
+            continue;
+        }
+
+        ++passwordEntries;
+        if (pwd.size() < PasswordHealth::Length::Short) {
+            ++shortPasswords;
+        }
+        if (entry->excludeFromReports()) {
+            ++excludedEntries;
+        }
+        totalPasswordLength += pwd.size();
+        ++passwords[pwd];
+    }
+
+    uniquePasswords = passwords.size();
+    reusedPasswords = passwordEntries - uniquePasswords;
+
+    // A password is weak for all of its entries if it has low entropy or is re-used,
+    // see HealthChecker::evaluate()
+    auto cache = m_db->passwordHealthCache();
+    QStringList estimated;
+    for (auto it = passwords.constBegin(); it != passwords.constEnd(); ++it) {
+        if (it.key().size() < PasswordHealth::Length::Long && checkedPasswords.value(it.key()) <= 1) {
+            estimated.append(it.key());
+        }
+    }
+    cache->prefetch(estimated);
+
+    QSet<QString> weak;
+    for (auto it = passwords.constBegin(); it != passwords.constEnd(); ++it) {
+        m_maxPwdReuse = std::max(m_maxPwdReuse, it.value());
+
+        // Speed up Zxcvbn process by excluding very long passwords and most passphrases
+        const auto& pwd = it.key();
+        if (pwd.size() >= PasswordHealth::Length::Long) {
             continue;
         }
+        if (checkedPasswords.value(pwd) > 1
+            || PasswordHealth(cache->entropy(pwd)).quality() <= PasswordHealth::Quality::Weak) {
+            weakPasswords += it.value();
+            weak.insert(pwd);
+        }
+    }
+
+    // Otherwise an entry is weak if it is expired or about to expire
+    const qint64 now = Clock::currentMilliSecondsSinceEpoch();
+    const auto today = QDateTime::currentDateTime();
+    for (const auto* entry : indexed.expiringEntries) {
+        const bool expired = entry->isExpired(now);
+        if (expired) {
+            ++expiredEntries;
+        }
 
-        ++groupCount;
-
-        for (const auto* entry : group->entries()) {
-            // Don't count anything in the recycle bin
-            if (entry->isRecycled()) {
-                continue;
-            }
-
-            ++entryCount;
-
-            if (entry->isExpired()) {
-                ++expiredEntries;
-            }
-
-            // Get password statistics
-            const auto pwd = entry->password();
-            if (!pwd.isEmpty()) {
-                if (!m_passwords.contains(pwd)) {
-                    ++uniquePasswords;
-                } else {
-                    ++reusedPasswords;
-                }
-
-                if (pwd.size() < PasswordHealth::Length::Short) {
-                    ++shortPasswords;
-                }
-
-                // Speed up Zxcvbn process by excluding very long passwords and most passphrases
-                if (pwd.size() < PasswordHealth::Length::Long
-                    && checker.evaluate(entry)->quality() <= PasswordHealth::Quality::Weak) {
-                    ++weakPasswords;
-                }
-
-                if (entry->excludeFromReports()) {
-                    ++excludedEntries;
-                }
-
-                totalPasswordLength += pwd.size();
-                m_passwords[pwd]++;
-            }
+        const auto pwd = entry->password();
+        if (!pwd.isEmpty() && pwd.size() < PasswordHealth::Length::Long && !weak.contains(pwd)
+            && (expired || today.daysTo(entry->timeInfo().expiryTime()) <= 30)) {
+            ++weakPasswords;
         }
     }
 }
@@ -52,8 +52,8 @@ public:
 
 private:
     QSharedPointer<Database> m_db;
-    QHash<QString, int> m_passwords;
+    int m_maxPwdReuse = 0;
 
-    void gatherStats(const QList<Group*>& groups);
+    void gatherStats();
 };
 #endif // KEEPASSXC_DATABASESTATS_H
@@ -27,9 +27,11 @@
 #include "core/Tools.h"
 #include "core/Totp.h"
 
+#include <QCoreApplication>
 #include <QDir>
 #include <QRegularExpression>
 #include <QStringBuilder>
+#include <QThread>
 #include <QUrl>
 
 const int Entry::DefaultIconNumber = 0;
@@ -40,13 +42,35 @@ namespace
     const QString AutoTypeSequenceUsername = "{USERNAME}{ENTER}";
     const QString AutoTypeSequencePassword = "{PASSWORD}{ENTER}";
     const QRegularExpression TagDelimiterRegex(R"([,;\t])");
+
+    // Returned by the const accessors of entries that have no container of their own
+    struct EmptyContainers
+    {
+        const AutoTypeAssociations autoTypeAssociations;
+        const EntryAttachments attachments;
+        const CustomData customData;
+    };
+    EmptyContainers* emptyContainers = nullptr;
+
+    // The empty containers are created on the application thread when the application is constructed
+    // and destroyed with it, so they neither belong to a worker thread nor outlive the application
+    void createEmptyContainers()
+    {
+        emptyContainers = new EmptyContainers();
+        qAddPostRoutine([] {
+            delete emptyContainers;
+            emptyContainers = nullptr;
+        });
+    }
 } // namespace
 
+Q_COREAPP_STARTUP_FUNCTION(createEmptyContainers)
+
 Entry::Entry()
     : m_attributes(new EntryAttributes(this))
-    , m_attachments(new EntryAttachments(this))
-    , m_autoTypeAssociations(new AutoTypeAssociations(this))
-    , m_customData(new CustomData(this))
+    , m_attachments(nullptr)
+    , m_autoTypeAssociations(nullptr)
+    , m_customData(nullptr)
     , m_modifiedSinceBegin(false)
     , m_updateTimeinfo(true)
 {
@@ -56,14 +80,8 @@ Entry::Entry()
     m_data.excludeFromReports = false;
 
     connect(m_attributes, &EntryAttributes::modified, this, &Entry::updateTotp);
-    connect(m_attributes, &EntryAttributes::modified, this, &Entry::modified);
+    connect(m_attributes, &EntryAttributes::modified, this, &Entry::emitModified);
     connect(m_attributes, &EntryAttributes::defaultKeyModified, this, &Entry::emitDataChanged);
-    connect(m_attachments, &EntryAttachments::modified, this, &Entry::modified);
-    connect(m_autoTypeAssociations, &AutoTypeAssociations::modified, this, &Entry::modified);
-    connect(m_customData, &CustomData::modified, this, &Entry::modified);
-
-    connect(this, &Entry::modified, this, &Entry::updateTimeinfo);
-    connect(this, &Entry::modified, this, &Entry::updateModifiedSinceBegin);
 }
 
 Entry::~Entry()
@@ -80,6 +98,52 @@ Entry::~Entry()
     qDeleteAll(m_history);
 }
 
+/**
+ * Create the child container on first use. Only the thread owning the entry may do so,
+ * code reading entries from other threads has to use the const accessors.
+ */
+template <class T> T* Entry::createChild(T*& child)
+{
+    if (!child) {
+        Q_ASSERT(thread() == QThread::currentThread());
+        child = new T(this);
+        connect(child, &T::modified, this, &Entry::emitModified);
+    }
+    return child;
+}
+
+void Entry::emitModified()
+{
+    // Within a batch only note the change, the entry is updated and announced once when it ends
+    auto db = database();
+    if (db && db->isBatchUpdating()) {
+        updateModifiedSinceBegin();
+        db->deferModified(this, m_updateTimeinfo);
+        return;
+    }
+
+    if (modifiedSignalEnabled()) {
+        updateTimeinfo();
+        updateModifiedSinceBegin();
+        emit modified();
+    }
+}
+
+/**
+ * Apply the changes noted during a batch update, see Database::beginBatchUpdate().
+ *
+ * @param updateTimeinfo whether the time info was to be updated when the changes were made
+ */
+void Entry::emitDeferredModified(bool updateTimeinfo)
+{
+    updateTotp();
+
+    const bool updateTimeinfoEnabled = m_updateTimeinfo;
+    m_updateTimeinfo = updateTimeinfo;
+    emitModified();
+    m_updateTimeinfo = updateTimeinfoEnabled;
+}
+
 template <class T> inline bool Entry::set(T& property, const T& value)
 {
     if (property != value) {
@@ -230,7 +294,7 @@ QString Entry::defaultAutoTypeSequence() const
 const QSharedPointer<PasswordHealth> Entry::passwordHealth()
 {
     if (!m_data.passwordHealth) {
-        m_data.passwordHealth.reset(new PasswordHealth(resolvePlaceholder(password())));
+        m_data.passwordHealth.reset(new PasswordHealth(passwordEntropy()));
     }
     return m_data.passwordHealth;
 }
@@ -238,11 +302,24 @@ const QSharedPointer<PasswordHealth> Entry::passwordHealth()
 const QSharedPointer<PasswordHealth> Entry::passwordHealth() const
 {
     if (!m_data.passwordHealth) {
-        return QSharedPointer<PasswordHealth>::create(resolvePlaceholder(password()));
+        return QSharedPointer<PasswordHealth>::create(passwordEntropy());
     }
     return m_data.passwordHealth;
 }
 
+/**
+ * Entropy of the resolved password, taken from the database cache if possible.
+ */
+double Entry::passwordEntropy() const
+{
+    const auto pwd = resolvePlaceholder(password());
+    const auto db = database();
+    if (db) {
+        return db->passwordHealthCache()->entropy(pwd);
+    }
+    return PasswordHealth::estimateEntropy(pwd);
+}
+
 bool Entry::excludeFromReports() const
 {
     return m_data.excludeFromReports
@@ -363,12 +440,13 @@ QList<QString> Entry::autoTypeSequences(const QString& windowTitle) const
 
 AutoTypeAssociations* Entry::autoTypeAssociations()
 {
-    return m_autoTypeAssociations;
+    return createChild(m_autoTypeAssociations);
 }
 
 const AutoTypeAssociations* Entry::autoTypeAssociations() const
 {
-    return m_autoTypeAssociations;
+    Q_ASSERT(m_autoTypeAssociations || emptyContainers);
+    return m_autoTypeAssociations ? m_autoTypeAssociations : &emptyContainers->autoTypeAssociations;
 }
 
 QString Entry::title() const
@@ -404,6 +482,27 @@ QStringList Entry::getAllUrls() const
     return urlList;
 }
 
+/**
+ * Same as !getAllUrls().isEmpty() without resolving any placeholders.
+ */
+bool Entry::hasUrls() const
+{
+    if (!url().isEmpty()) {
+        return true;
+    }
+
+    for (const auto& key : m_attributes->keys()) {
+        if (key.startsWith(EntryAttributes::AdditionalUrlAttribute)
+            || key == QString("%1_RELYING_PARTY").arg(EntryAttributes::PasskeyAttribute)) {
+            if (!m_attributes->value(key).isEmpty()) {
+                return true;
+            }
+        }
+    }
+
+    return false;
+}
+
 QString Entry::webUrl() const
 {
     QString url = resolveMultiplePlaceholders(m_attributes->value(EntryAttributes::URLKey));
@@ -452,12 +551,24 @@ int Entry::size() const
 
 bool Entry::isExpired() const
 {
-    return willExpireInDays(0);
+    return m_data.timeInfo.expires() && isExpired(Clock::currentMilliSecondsSinceEpoch());
+}
+
+/**
+ * @param now current time in milliseconds since the epoch, taken once when checking many entries
+ */
+bool Entry::isExpired(qint64 now) const
+{
+    return m_data.timeInfo.expiresBefore(now);
 }
 
 bool Entry::willExpireInDays(int days) const
 {
-    return m_data.timeInfo.expires() && m_data.timeInfo.expiryTime() < Clock::currentDateTime().addDays(days);
+    if (!m_data.timeInfo.expires()) {
+        return false;
+    }
+    // Days are counted in local time to respect daylight saving time changes
+    return isExpired(Clock::currentDateTime().addDays(days).toMSecsSinceEpoch());
 }
 
 bool Entry::isRecycled() const
@@ -525,22 +636,24 @@ const EntryAttributes* Entry::attributes() const
 
 EntryAttachments* Entry::attachments()
 {
-    return m_attachments;
+    return createChild(m_attachments);
 }
 
 const EntryAttachments* Entry::attachments() const
 {
-    return m_attachments;
+    Q_ASSERT(m_attachments || emptyContainers);
+    return m_attachments ? m_attachments : &emptyContainers->attachments;
 }
 
 CustomData* Entry::customData()
 {
-    return m_customData;
+    return createChild(m_customData);
 }
 
 const CustomData* Entry::customData() const
 {
-    return m_customData;
+    Q_ASSERT(m_customData || emptyContainers);
+    return m_customData ? m_customData : &emptyContainers->customData;
 }
 
 bool Entry::hasTotp() const
@@ -592,6 +705,12 @@ void Entry::setTotp(QSharedPointer<Totp::Settings> settings)
 
 void Entry::updateTotp()
 {
+    auto db = database();
+    if (db && db->isBatchUpdating()) {
+        db->deferModified(this, false);
+        return;
+    }
+
     if (m_attributes->contains(Totp::ATTRIBUTE_SETTINGS)) {
         m_data.totpSettings = Totp::parseSettings(m_attributes->value(Totp::ATTRIBUTE_SETTINGS),
                                                   m_attributes->value(Totp::ATTRIBUTE_SEED));
@@ -802,10 +921,31 @@ void Entry::addHistoryItem(Entry* entry)
 {
     Q_ASSERT(!entry->parent());
 
+    // History items mostly hold the same values as their predecessor and the current entry,
+    // let them share storage so deep histories only pay for what actually changed
+    if (!m_history.isEmpty()) {
+        entry->shareDataWith(m_history.last());
+    }
+    entry->shareDataWith(this);
+
     m_history.append(entry);
     emitModified();
 }
 
+void Entry::shareDataWith(const Entry* other)
+{
+    m_attributes->shareDataWith(other->m_attributes);
+    if (m_attachments && other->m_attachments) {
+        m_attachments->shareDataWith(other->m_attachments);
+    }
+    if (m_customData && other->m_customData) {
+        m_customData->shareDataWith(other->m_customData);
+    }
+    if (m_autoTypeAssociations && other->m_autoTypeAssociations) {
+        m_autoTypeAssociations->shareDataWith(other->m_autoTypeAssociations);
+    }
+}
+
 void Entry::removeHistoryItems(const QList<Entry*>& historyEntries)
 {
     if (historyEntries.isEmpty()) {
@@ -887,16 +1027,16 @@ bool Entry::equals(const Entry* other, CompareItemOptions options) const
     if (!m_data.equals(other->m_data, options)) {
         return false;
     }
-    if (*m_customData != *other->m_customData) {
+    if (*customData() != *other->customData()) {
         return false;
     }
     if (*m_attributes != *other->m_attributes) {
         return false;
     }
-    if (*m_attachments != *other->m_attachments) {
+    if (*attachments() != *other->attachments()) {
         return false;
     }
-    if (*m_autoTypeAssociations != *other->m_autoTypeAssociations) {
+    if (*autoTypeAssociations() != *other->autoTypeAssociations()) {
         return false;
     }
     if (!options.testFlag(CompareItemIgnoreHistory)) {
@@ -922,9 +1062,13 @@ Entry* Entry::clone(CloneFlags flags) const
         entry->m_uuid = m_uuid;
     }
     entry->m_data = m_data;
-    entry->m_customData->copyDataFrom(m_customData);
+    if (m_customData) {
+        entry->customData()->copyDataFrom(m_customData);
+    }
     entry->m_attributes->copyDataFrom(m_attributes);
-    entry->m_attachments->copyDataFrom(m_attachments);
+    if (m_attachments) {
+        entry->attachments()->copyDataFrom(m_attachments);
+    }
 
     if (flags & CloneUserAsRef) {
         entry->m_attributes->set(EntryAttributes::UserNameKey,
@@ -938,7 +1082,9 @@ Entry* Entry::clone(CloneFlags flags) const
                                  m_attributes->isProtected(EntryAttributes::PasswordKey));
     }
 
-    entry->m_autoTypeAssociations->copyDataFrom(m_autoTypeAssociations);
+    if (m_autoTypeAssociations) {
+        entry->autoTypeAssociations()->copyDataFrom(m_autoTypeAssociations);
+    }
     if (flags & CloneIncludeHistory) {
         for (Entry* historyItem : m_history) {
             Entry* historyItemClone =
@@ -971,10 +1117,16 @@ void Entry::copyDataFrom(const Entry* other)
 {
     setUpdateTimeinfo(false);
     m_data = other->m_data;
-    m_customData->copyDataFrom(other->m_customData);
+    if (m_customData || other->m_customData) {
+        customData()->copyDataFrom(other->customData());
+    }
     m_attributes->copyDataFrom(other->m_attributes);
-    m_attachments->copyDataFrom(other->m_attachments);
-    m_autoTypeAssociations->copyDataFrom(other->m_autoTypeAssociations);
+    if (m_attachments || other->m_attachments) {
+        attachments()->copyDataFrom(other->attachments());
+    }
+    if (m_autoTypeAssociations || other->m_autoTypeAssociations) {
+        autoTypeAssociations()->copyDataFrom(other->autoTypeAssociations());
+    }
     setUpdateTimeinfo(true);
 }
 
@@ -987,8 +1139,12 @@ void Entry::beginUpdate()
     m_tmpHistoryItem->m_uuid = m_uuid;
     m_tmpHistoryItem->m_data = m_data;
     m_tmpHistoryItem->m_attributes->copyDataFrom(m_attributes);
-    m_tmpHistoryItem->m_attachments->copyDataFrom(m_attachments);
-    m_tmpHistoryItem->m_autoTypeAssociations->copyDataFrom(m_autoTypeAssociations);
+    if (m_attachments) {
+        m_tmpHistoryItem->attachments()->copyDataFrom(m_attachments);
+    }
+    if (m_autoTypeAssociations) {
+        m_tmpHistoryItem->autoTypeAssociations()->copyDataFrom(m_autoTypeAssociations);
+    }
 
     m_modifiedSinceBegin = false;
 }
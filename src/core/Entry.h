@@ -101,6 +101,7 @@ public:
     QString title() const;
     QString url() const;
     QStringList getAllUrls() const;
+    bool hasUrls() const;
     QString webUrl() const;
     QString displayUrl() const;
     QString username() const;
@@ -125,6 +126,7 @@ public:
 
     bool hasTotp() const;
     bool isExpired() const;
+    bool isExpired(qint64 now) const;
     bool willExpireInDays(int days) const;
     bool isRecycled() const;
     bool isAttributeReference(const QString& key) const;
@@ -277,6 +279,12 @@ private slots:
     void updateTotp();
 
 private:
+    void emitModified() override;
+    void emitDeferredModified(bool updateTimeinfo);
+    template <class T> T* createChild(T*& child);
+    double passwordEntropy() const;
+    void shareDataWith(const Entry* other);
+
     QString resolveMultiplePlaceholdersRecursive(const QString& str, int maxDepth) const;
     QString resolvePlaceholderRecursive(const QString& placeholder, int maxDepth) const;
     QString resolveReferencePlaceholderRecursive(const QString& placeholder, int maxDepth) const;
@@ -289,16 +297,19 @@ private:
 
     QUuid m_uuid;
     EntryData m_data;
-    QPointer<EntryAttributes> m_attributes;
-    QPointer<EntryAttachments> m_attachments;
-    QPointer<AutoTypeAssociations> m_autoTypeAssociations;
-    QPointer<CustomData> m_customData;
+    // Child objects, the containers that are empty for most entries are only created when first modified
+    EntryAttributes* m_attributes;
+    EntryAttachments* m_attachments;
+    AutoTypeAssociations* m_autoTypeAssociations;
+    CustomData* m_customData;
     QList<Entry*> m_history; // Items sorted from oldest to newest
 
     QScopedPointer<Entry> m_tmpHistoryItem;
     bool m_modifiedSinceBegin;
     QPointer<Group> m_group;
     bool m_updateTimeinfo;
+
+    friend class Database;
 };
 
 Q_DECLARE_OPERATORS_FOR_FLAGS(Entry::CloneFlags)
@@ -177,6 +177,14 @@ void EntryAttachments::disconnectAndEraseExternalFile(const QString& path)
     f.remove();
 }
 
+/**
+ * Share the storage of attachments equal to the ones in other, without changing any data.
+ */
+void EntryAttachments::shareDataWith(const EntryAttachments* other)
+{
+    Tools::shareEqualValues(m_attachments, other->m_attachments);
+}
+
 void EntryAttachments::copyDataFrom(const EntryAttachments* other)
 {
     if (*this != *other) {
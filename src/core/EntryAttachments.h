@@ -46,6 +46,7 @@ public:
     bool isEmpty() const;
     void clear();
     void copyDataFrom(const EntryAttachments* other);
+    void shareDataWith(const EntryAttachments* other);
     bool operator==(const EntryAttachments& other) const;
     bool operator!=(const EntryAttachments& other) const;
     int attachmentsSize() const;
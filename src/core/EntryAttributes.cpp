@@ -267,6 +267,18 @@ bool EntryAttributes::areCustomKeysDifferent(const EntryAttributes* other)
     return false;
 }
 
+/**
+ * Share the storage of values equal to the ones in other, without changing any data.
+ * Used to keep history items cheap, as most of their values are unchanged.
+ */
+void EntryAttributes::shareDataWith(const EntryAttributes* other)
+{
+    Tools::shareEqualValues(m_attributes, other->m_attributes);
+    if (m_protectedAttributes == other->m_protectedAttributes) {
+        m_protectedAttributes = other->m_protectedAttributes;
+    }
+}
+
 void EntryAttributes::copyDataFrom(const EntryAttributes* other)
 {
     if (*this != *other) {
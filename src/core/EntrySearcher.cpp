@@ -22,6 +22,80 @@
 #include "core/Group.h"
 #include "core/Tools.h"
 
+#include <QElapsedTimer>
+#include <algorithm>
+
+namespace
+{
+    /**
+     * Recover the plain text of a pattern that does not use any regex syntax,
+     * which is the case for search terms without wildcards.
+     *
+     * @param pattern regex pattern, optionally wrapped for an exact match
+     * @param text receives the unescaped text
+     * @param exactMatch receives whether the pattern is anchored to the whole value
+     * @return true if the pattern only matches the literal text
+     */
+    bool literalFromPattern(QString pattern, QString& text, bool& exactMatch)
+    {
+        static const QString metaCharacters = QStringLiteral("^$.|?*+()[]{}");
+
+        exactMatch = pattern.startsWith("^(?:") && pattern.endsWith(")$");
+        if (exactMatch) {
+            pattern = pattern.mid(4, pattern.size() - 6);
+        }
+
+        text.clear();
+        text.reserve(pattern.size());
+        for (int i = 0; i < pattern.size(); ++i) {
+            QChar c = pattern.at(i);
+            if (c == '\\') {
+                if (++i == pattern.size()) {
+                    return false;
+                }
+                // An escaped ASCII letter or digit is a character class or back reference
+                c = pattern.at(i);
+                if (c.unicode() < 128 && c.isLetterOrNumber()) {
+                    return false;
+                }
+            } else if (metaCharacters.contains(c)) {
+                return false;
+            }
+            text.append(c);
+        }
+        return true;
+    }
+
+    // Rough relative cost of evaluating a term, cheap and selective terms run first
+    int estimateCost(const EntrySearcher::SearchTerm& term)
+    {
+        switch (term.field) {
+        case EntrySearcher::Field::Uuid:
+        case EntrySearcher::Field::Notes:
+        case EntrySearcher::Field::AttributeValue:
+        case EntrySearcher::Field::Tag:
+            return 1;
+        case EntrySearcher::Field::Title:
+        case EntrySearcher::Field::Username:
+        case EntrySearcher::Field::Password:
+        case EntrySearcher::Field::Url:
+            // Placeholders may have to be resolved
+            return 2;
+        case EntrySearcher::Field::Group:
+            return term.word.contains('/') ? 4 : 1;
+        case EntrySearcher::Field::Attachment:
+            return 3;
+        case EntrySearcher::Field::AttributeKV:
+            return 5;
+        case EntrySearcher::Field::Is:
+            // Password health is only calculated when searching for weak passwords
+            return term.word.compare("weak", Qt::CaseInsensitive) == 0 ? 20 : 2;
+        default:
+            return 8;
+        }
+    }
+} // namespace
+
 EntrySearcher::EntrySearcher(bool caseSensitive, bool skipProtected)
     : m_caseSensitive(caseSensitive)
     , m_skipProtected(skipProtected)
@@ -69,6 +143,10 @@ QList<Entry*> EntrySearcher::repeat(const Group* baseGroup, bool forceSearch)
 {
     Q_ASSERT(baseGroup);
 
+    QElapsedTimer timer;
+    timer.start();
+    compileSearchPlan();
+
     QList<Entry*> results;
     for (const auto group : baseGroup->groupsRecursive(true)) {
         if (forceSearch || group->resolveSearchingEnabled()) {
@@ -79,6 +157,8 @@ QList<Entry*> EntrySearcher::repeat(const Group* baseGroup, bool forceSearch)
             }
         }
     }
+
+    m_lastSearchTime = timer.nsecsElapsed();
     return results;
 }
 
@@ -117,12 +197,18 @@ QList<Entry*> EntrySearcher::searchEntries(const QString& searchString, const QL
  */
 QList<Entry*> EntrySearcher::repeatEntries(const QList<Entry*>& entries)
 {
+    QElapsedTimer timer;
+    timer.start();
+    compileSearchPlan();
+
     QList<Entry*> results;
     for (auto* entry : entries) {
         if (searchEntryImpl(entry)) {
             results.append(entry);
         }
     }
+
+    m_lastSearchTime = timer.nsecsElapsed();
     return results;
 }
 
@@ -141,76 +227,182 @@ bool EntrySearcher::isCaseSensitive() const
     return m_caseSensitive;
 }
 
-bool EntrySearcher::searchEntryImpl(const Entry* entry)
+/**
+ * Describe the steps of the last search in the order they are evaluated, for debugging
+ *
+ * @return one line per search term
+ */
+QStringList EntrySearcher::searchPlan() const
 {
-    // Pre-load in case they are needed
-    auto attributes_keys = entry->attributes()->customKeys();
-    auto attributes = QStringList(attributes_keys + entry->attributes()->values(attributes_keys));
-    auto attachments = QStringList(entry->attachments()->keys());
-    // Build a group hierarchy to allow searching for e.g. /group1/subgroup*
-    QString hierarchy;
-    if (entry->group()) {
-        hierarchy = entry->group()->hierarchy().join('/').prepend("/");
+    static const QStringList fieldNames{"any",
+                                        "title",
+                                        "username",
+                                        "password",
+                                        "url",
+                                        "notes",
+                                        "attribute",
+                                        "attachment",
+                                        "attribute value",
+                                        "group",
+                                        "tag",
+                                        "is",
+                                        "uuid"};
+
+    QStringList plan;
+    for (const auto& step : m_plan) {
+        QString operation = step.literal ? (step.exactMatch ? "equals" : "contains") : "matches";
+        if (step.term.exclude) {
+            operation.prepend("not ");
+        }
+        plan << QString("%1 %2 \"%3\" (cost %4)")
+                    .arg(fieldNames.value(static_cast<int>(step.term.field)),
+                         operation,
+                         step.literal ? step.text : step.term.regex.pattern(),
+                         QString::number(step.cost));
     }
+    return plan;
+}
+
+/**
+ * @return duration of the last search in nanoseconds
+ */
+qint64 EntrySearcher::lastSearchTime() const
+{
+    return m_lastSearchTime;
+}
 
+/**
+ * Prepare the search terms for matching. Every term has to match, so they are
+ * reordered to evaluate the cheapest ones first and stop at the first mismatch.
+ */
+void EntrySearcher::compileSearchPlan()
+{
+    const QDateTime now = Clock::currentDateTime();
+    m_now = now.toMSecsSinceEpoch();
+
+    m_plan.clear();
+    m_plan.reserve(m_searchTerms.size());
+    for (const auto& term : asConst(m_searchTerms)) {
+        PlanStep step{term, estimateCost(term), false, false, {}, Qt::CaseSensitive, {}, m_now};
+
+        if (term.field == Field::Is && term.word.startsWith("expired", Qt::CaseInsensitive)) {
+            auto parts = term.word.split("-", Qt::SkipEmptyParts);
+            if (parts.length() >= 2) {
+                step.expiryLimit = now.addDays(parts[1].toInt()).toMSecsSinceEpoch();
+            }
+        }
+
+        auto options = term.regex.patternOptions();
+        if ((options | QRegularExpression::CaseInsensitiveOption) == QRegularExpression::CaseInsensitiveOption) {
+            step.literal = literalFromPattern(term.regex.pattern(), step.text, step.exactMatch);
+            step.exactMatch |= term.field == Field::Tag;
+            if (options & QRegularExpression::CaseInsensitiveOption) {
+                step.caseSensitivity = Qt::CaseInsensitive;
+            }
+        }
+        if (!step.literal) {
+            step.cost += 1;
+            if (term.field == Field::Tag || term.field == Field::Undefined) {
+                step.tagRegex = QRegularExpression(QRegularExpression::anchoredPattern(term.regex.pattern()), options);
+            }
+        }
+
+        m_plan.append(step);
+    }
+
+    std::stable_sort(m_plan.begin(), m_plan.end(), [](const PlanStep& lhs, const PlanStep& rhs) {
+        return lhs.cost < rhs.cost;
+    });
+}
+
+bool EntrySearcher::matches(const PlanStep& step, const QString& value) const
+{
+    if (step.literal) {
+        if (step.exactMatch) {
+            return value.compare(step.text, step.caseSensitivity) == 0;
+        }
+        return value.contains(step.text, step.caseSensitivity);
+    }
+    return step.term.regex.match(value).hasMatch();
+}
+
+bool EntrySearcher::matchesTag(const PlanStep& step, const QStringList& tags) const
+{
+    for (const auto& tag : tags) {
+        if (step.literal ? tag.compare(step.text, step.caseSensitivity) == 0 : step.tagRegex.match(tag).hasMatch()) {
+            return true;
+        }
+    }
+    return false;
+}
+
+bool EntrySearcher::searchEntryImpl(const Entry* entry) const
+{
     // By default, empty term matches every entry.
     // However when skipping protected fields, we will reject everything instead
     bool found = !m_skipProtected;
-    for (const auto& term : m_searchTerms) {
+    for (const auto& step : m_plan) {
+        const auto& term = step.term;
         switch (term.field) {
         case Field::Title:
-            found = term.regex.match(entry->resolvePlaceholder(entry->title())).hasMatch();
+            found = matches(step, entry->resolvePlaceholder(entry->title()));
             break;
         case Field::Username:
-            found = term.regex.match(entry->resolvePlaceholder(entry->username())).hasMatch();
+            found = matches(step, entry->resolvePlaceholder(entry->username()));
             break;
         case Field::Password:
             if (m_skipProtected) {
                 continue;
             }
-            found = term.regex.match(entry->resolvePlaceholder(entry->password())).hasMatch();
+            found = matches(step, entry->resolvePlaceholder(entry->password()));
             break;
         case Field::Url:
-            found = term.regex.match(entry->resolvePlaceholder(entry->url())).hasMatch();
+            found = matches(step, entry->resolvePlaceholder(entry->url()));
             break;
         case Field::Notes:
-            found = term.regex.match(entry->notes()).hasMatch();
+            found = matches(step, entry->notes());
             break;
-        case Field::AttributeKV:
-            found = !attributes.filter(term.regex).empty();
+        case Field::AttributeKV: {
+            const auto keys = entry->attributes()->customKeys();
+            found = std::any_of(keys.begin(), keys.end(), [&](const QString& key) {
+                return matches(step, key) || matches(step, entry->attributes()->value(key));
+            });
             break;
-        case Field::Attachment:
-            found = !attachments.filter(term.regex).empty();
+        }
+        case Field::Attachment: {
+            const auto names = entry->attachments()->keys();
+            found = std::any_of(
+                names.begin(), names.end(), [&](const QString& name) { return matches(step, name); });
             break;
+        }
         case Field::AttributeValue:
             if (m_skipProtected && entry->attributes()->isProtected(term.word)) {
                 continue;
             }
-            found = entry->attributes()->contains(term.word)
-                    && term.regex.match(entry->attributes()->value(term.word)).hasMatch();
+            found = entry->attributes()->contains(term.word) && matches(step, entry->attributes()->value(term.word));
             break;
         case Field::Group:
             // Match against the full hierarchy if the word contains a '/' otherwise just the group name
             if (term.word.contains('/')) {
-                found = term.regex.match(hierarchy).hasMatch();
+                // Match the full path of the group to allow searching for e.g. /group1/subgroup*
+                QString hierarchy;
+                if (entry->group()) {
+                    hierarchy = entry->group()->fullPath();
+                }
+                found = matches(step, hierarchy);
             } else if (entry->group()) {
-                found = term.regex.match(entry->group()->name()).hasMatch();
+                found = matches(step, entry->group()->name());
             }
             break;
         case Field::Tag:
-            found = entry->tagList().indexOf(term.regex) != -1;
+            found = matchesTag(step, entry->tagList());
             break;
         case Field::Is:
             if (term.word.startsWith("expired", Qt::CaseInsensitive)) {
-                auto days = 0;
-                auto parts = term.word.split("-", Qt::SkipEmptyParts);
-                if (parts.length() >= 2) {
-                    days = parts[1].toInt();
-                }
-                found = entry->willExpireInDays(days) && !entry->isRecycled();
+                found = entry->isExpired(step.expiryLimit) && !entry->isRecycled();
                 break;
             } else if (term.word.compare("weak", Qt::CaseInsensitive) == 0) {
-                if (!entry->excludeFromReports() && !entry->password().isEmpty() && !entry->isExpired()) {
+                if (!entry->excludeFromReports() && !entry->password().isEmpty() && !entry->isExpired(m_now)) {
                     const auto quality = entry->passwordHealth()->quality();
                     if (quality == PasswordHealth::Quality::Bad || quality == PasswordHealth::Quality::Poor
                         || quality == PasswordHealth::Quality::Weak) {
@@ -222,14 +414,14 @@ bool EntrySearcher::searchEntryImpl(const Entry* entry)
             found = false;
             break;
         case Field::Uuid:
-            found = term.regex.match(entry->uuidToHex()).hasMatch();
+            found = matches(step, entry->uuidToHex());
             break;
         default:
             // Terms without a specific field try to match title, username, url, and notes
-            found = term.regex.match(entry->resolvePlaceholder(entry->title())).hasMatch()
-                    || term.regex.match(entry->resolvePlaceholder(entry->username())).hasMatch()
-                    || term.regex.match(entry->resolvePlaceholder(entry->url())).hasMatch()
-                    || entry->tagList().indexOf(term.regex) != -1 || term.regex.match(entry->notes()).hasMatch();
+            found = matches(step, entry->resolvePlaceholder(entry->title()))
+                    || matches(step, entry->resolvePlaceholder(entry->username()))
+                    || matches(step, entry->resolvePlaceholder(entry->url())) || matchesTag(step, entry->tagList())
+                    || matches(step, entry->notes());
         }
 
         // negate the result if exclude:
@@ -66,13 +66,39 @@ public:
     void setCaseSensitive(bool state);
     bool isCaseSensitive() const;
 
+    QStringList searchPlan() const;
+    qint64 lastSearchTime() const;
+
 private:
-    bool searchEntryImpl(const Entry* entry);
+    // A search term prepared for matching, terms are evaluated in order of increasing cost
+    struct PlanStep
+    {
+        SearchTerm term;
+        int cost;
+        // Terms without any regex syntax are matched as plain text
+        bool literal;
+        bool exactMatch;
+        QString text;
+        Qt::CaseSensitivity caseSensitivity;
+        // Tags have to match as a whole
+        QRegularExpression tagRegex;
+        // Entries expiring before this time match "is:expired" terms
+        qint64 expiryLimit;
+    };
+
+    bool searchEntryImpl(const Entry* entry) const;
     void parseSearchTerms(const QString& searchString);
+    void compileSearchPlan();
+    bool matches(const PlanStep& step, const QString& value) const;
+    bool matchesTag(const PlanStep& step, const QStringList& tags) const;
 
     bool m_caseSensitive;
     bool m_skipProtected;
     QList<SearchTerm> m_searchTerms;
+    QList<PlanStep> m_plan;
+    // Time of the current search, shared by all entries
+    qint64 m_now = 0;
+    qint64 m_lastSearchTime = 0;
 
     friend class TestEntrySearcher;
 };
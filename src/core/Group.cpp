@@ -29,6 +29,7 @@
 #include "core/Metadata.h"
 #include "core/Tools.h"
 
+#include <QThread>
 #include <QtConcurrent>
 #include <QtConcurrentFilter>
 
@@ -47,7 +48,13 @@ Group::Group()
     m_data.searchingEnabled = Inherit;
     m_data.mergeMode = Default;
 
-    connect(m_customData, &CustomData::modified, this, &Group::modified);
+    connect(m_customData, &CustomData::modified, this, &Group::emitModified);
+    // Unlike modified, these are emitted even while the modified signal is disabled
+    connect(m_customData, &CustomData::reset, this, &Group::invalidateResolvedSettings);
+    connect(m_customData, &CustomData::added, this, &Group::invalidateResolvedSettings);
+    connect(m_customData, &CustomData::valueChanged, this, &Group::invalidateResolvedSettings);
+    connect(m_customData, &CustomData::removed, this, &Group::invalidateResolvedSettings);
+    connect(m_customData, &CustomData::renamed, this, &Group::invalidateResolvedSettings);
     connect(this, &Group::modified, this, &Group::updateTimeinfo);
     connect(this, &Group::groupNonDataChange, this, &Group::updateTimeinfo);
 }
@@ -93,6 +100,29 @@ bool Group::canUpdateTimeinfo() const
     return m_updateTimeinfo;
 }
 
+void Group::emitModified()
+{
+    // Within a batch only note the change, it is announced once when the batch ends
+    if (m_db && m_db->isBatchUpdating()) {
+        m_db->deferModified(this, m_updateTimeinfo);
+        return;
+    }
+    ModifiableObject::emitModified();
+}
+
+/**
+ * Announce the changes noted during a batch update, see Database::beginBatchUpdate().
+ *
+ * @param updateTimeinfo whether the time info was to be updated when the changes were made
+ */
+void Group::emitDeferredModified(bool updateTimeinfo)
+{
+    const bool updateTimeinfoEnabled = m_updateTimeinfo;
+    m_updateTimeinfo = updateTimeinfo;
+    emitModified();
+    m_updateTimeinfo = updateTimeinfoEnabled;
+}
+
 void Group::updateTimeinfo()
 {
     if (m_updateTimeinfo) {
@@ -133,15 +163,13 @@ QString Group::tags() const
 
 QString Group::fullPath() const
 {
-    QString fullPath;
-    auto group = this;
-
-    do {
-        fullPath.insert(0, "/" + group->name());
-        group = group->parentGroup();
-    } while (group);
-
-    return fullPath;
+    if (!canCache()) {
+        return (m_parent ? m_parent->fullPath() : QString("")) + "/" + name();
+    }
+    if (m_fullPath.isNull()) {
+        m_fullPath = (m_parent ? m_parent->fullPath() : QString("")) + "/" + name();
+    }
+    return m_fullPath;
 }
 
 int Group::iconNumber() const
@@ -239,7 +267,7 @@ bool Group::isRecycled() const
 
 bool Group::isExpired() const
 {
-    return m_data.timeInfo.expires() && m_data.timeInfo.expiryTime() < Clock::currentDateTimeUtc();
+    return m_data.timeInfo.expires() && m_data.timeInfo.expiresBefore(Clock::currentMilliSecondsSinceEpoch());
 }
 
 bool Group::isEmpty() const
@@ -259,16 +287,15 @@ const CustomData* Group::customData() const
 
 Group::TriState Group::resolveCustomDataTriState(const QString& key, bool checkParent) const
 {
-    // If not defined, check our parent up to the root group
-    if (!m_customData->contains(key)) {
-        if (!m_parent || !checkParent) {
-            return Inherit;
-        } else {
-            return m_parent->resolveCustomDataTriState(key);
-        }
+    QString value;
+    if (checkParent ? !resolveCustomDataValue(key, value) : !m_customData->contains(key)) {
+        return Inherit;
+    }
+    if (!checkParent) {
+        value = m_customData->value(key);
     }
 
-    return m_customData->value(key) == TRUE_STR ? Enable : Disable;
+    return value == TRUE_STR ? Enable : Disable;
 }
 
 void Group::setCustomDataTriState(const QString& key, const Group::TriState& value)
@@ -289,16 +316,104 @@ void Group::setCustomDataTriState(const QString& key, const Group::TriState& val
 // Note that this returns an empty string both if the key is missing *or* if the key is present but value is empty.
 QString Group::resolveCustomDataString(const QString& key, bool checkParent) const
 {
-    // If not defined, check our parent up to the root group
-    if (!m_customData->contains(key)) {
-        if (!m_parent || !checkParent) {
-            return QString();
-        } else {
-            return m_parent->resolveCustomDataString(key);
-        }
+    if (!checkParent) {
+        return m_customData->contains(key) ? m_customData->value(key) : QString();
+    }
+
+    QString value;
+    resolveCustomDataValue(key, value);
+    return value;
+}
+
+/**
+ * Find the value of key in the custom data of this group or the closest parent group defining it.
+ * Values inherited from parent groups are cached until this group or one of its parents changes.
+ *
+ * @param key custom data key
+ * @param value receives the value if found
+ * @return true if key is defined by this group or one of its parents
+ */
+bool Group::resolveCustomDataValue(const QString& key, QString& value) const
+{
+    if (m_customData->contains(key)) {
+        value = m_customData->value(key);
+        return true;
+    }
+    if (!m_parent) {
+        return false;
+    }
+    if (!canCache()) {
+        return m_parent->resolveCustomDataValue(key, value);
+    }
+
+    auto it = m_resolvedCustomData.constFind(key);
+    if (it == m_resolvedCustomData.constEnd()) {
+        QString parentValue;
+        bool found = m_parent->resolveCustomDataValue(key, parentValue);
+        it = m_resolvedCustomData.insert(key, {found, parentValue});
+    }
+
+    value = it->second;
+    return it->first;
+}
+
+/**
+ * Drop the cached inherited settings of this group and all of its children.
+ * Called when a setting, the custom data or the parent of this group changes,
+ * so the whole subtree is invalidated even if this group caches nothing itself,
+ * e.g. the root group.
+ */
+void Group::invalidateResolvedSettings()
+{
+    m_resolvedSearchingEnabled = Inherit;
+    m_resolvedAutoTypeEnabled = Inherit;
+    m_resolvedCustomData.clear();
+    for (Group* group : asConst(m_children)) {
+        group->invalidateInheritedSettings();
+    }
+}
+
+/**
+ * Drop the cached inherited settings of this descendant of a changed group.
+ * A group with a parent only caches inherited values after its parent resolved
+ * them, so the descendants of a group without cached values have none either.
+ */
+void Group::invalidateInheritedSettings()
+{
+    if (m_resolvedSearchingEnabled == Inherit && m_resolvedAutoTypeEnabled == Inherit
+        && m_resolvedCustomData.isEmpty()) {
+        return;
     }
 
-    return m_customData->value(key);
+    invalidateResolvedSettings();
+}
+
+/**
+ * Drop the cached hierarchy and full path of this group and all of its children.
+ * Like the inherited settings, a group only caches its path after its parent did.
+ */
+void Group::invalidateHierarchy()
+{
+    if (m_hierarchy.isEmpty() && m_fullPath.isNull()) {
+        return;
+    }
+
+    m_hierarchy.clear();
+    m_fullPath.clear();
+    for (Group* group : asConst(m_children)) {
+        group->invalidateHierarchy();
+    }
+}
+
+/**
+ * The resolved settings and the hierarchy are cached in mutable members. To keep the
+ * const accessors safe for worker threads, e.g. the health checks and the database
+ * queries, only the thread owning the group fills and reads those caches. Other
+ * threads resolve the values without them.
+ */
+bool Group::canCache() const
+{
+    return thread() == QThread::currentThread();
 }
 
 bool Group::equals(const Group* other, CompareItemOptions options) const
@@ -342,6 +457,7 @@ void Group::setUuid(const QUuid& uuid)
 void Group::setName(const QString& name)
 {
     if (set(m_data.name, name)) {
+        invalidateHierarchy();
         emit groupDataChanged(this);
     }
 }
@@ -396,12 +512,16 @@ void Group::setDefaultAutoTypeSequence(const QString& sequence)
 
 void Group::setAutoTypeEnabled(TriState enable)
 {
-    set(m_data.autoTypeEnabled, enable);
+    if (set(m_data.autoTypeEnabled, enable)) {
+        invalidateResolvedSettings();
+    }
 }
 
 void Group::setSearchingEnabled(TriState enable)
 {
-    set(m_data.searchingEnabled, enable);
+    if (set(m_data.searchingEnabled, enable)) {
+        invalidateResolvedSettings();
+    }
 }
 
 void Group::setLastTopVisibleEntry(Entry* entry)
@@ -493,6 +613,9 @@ void Group::setParent(Group* parent, int index, bool trackPrevious)
         parent->m_children.insert(index, this);
     }
 
+    invalidateResolvedSettings();
+    invalidateHierarchy();
+
     if (m_updateTimeinfo) {
         m_data.timeInfo.setLocationChanged(Clock::currentDateTimeUtc());
     }
@@ -514,6 +637,8 @@ void Group::setParent(Database* db)
     cleanupParent();
 
     m_parent = nullptr;
+    invalidateResolvedSettings();
+    invalidateHierarchy();
     connectDatabaseSignalsRecursive(db);
 
     QObject::setParent(db);
@@ -521,28 +646,21 @@ void Group::setParent(Database* db)
 
 QStringList Group::hierarchy(int height) const
 {
-    QStringList hierarchy;
-    const Group* group = this;
-    const Group* parent = m_parent;
-
-    if (height == 0) {
-        return hierarchy;
+    QStringList hierarchy = canCache() ? m_hierarchy : QStringList();
+    if (hierarchy.isEmpty()) {
+        if (m_parent) {
+            hierarchy = m_parent->hierarchy();
+        }
+        hierarchy.append(name());
+        if (canCache()) {
+            m_hierarchy = hierarchy;
+        }
     }
 
-    hierarchy.prepend(group->name());
-
-    int level = 1;
-    bool heightReached = level == height;
-
-    while (parent && !heightReached) {
-        group = group->parentGroup();
-        parent = group->parentGroup();
-        heightReached = ++level == height;
-
-        hierarchy.prepend(group->name());
+    if (height < 0 || height >= hierarchy.size()) {
+        return hierarchy;
     }
-
-    return hierarchy;
+    return hierarchy.mid(hierarchy.size() - height);
 }
 
 bool Group::hasChildren() const
@@ -964,6 +1082,8 @@ Group* Group::clone(Entry::CloneFlags entryFlags, Group::CloneFlags groupFlags)
 void Group::copyDataFrom(const Group* other)
 {
     if (set(m_data, other->m_data)) {
+        invalidateResolvedSettings();
+        invalidateHierarchy();
         emit groupDataChanged(this);
     }
     m_customData->copyDataFrom(other->m_customData);
@@ -981,6 +1101,9 @@ void Group::addEntry(Entry* entry)
     connect(entry, &Entry::entryDataChanged, this, &Group::entryDataChanged);
     if (m_db) {
         connect(entry, &Entry::modified, m_db, &Database::markAsModified);
+        auto db = m_db.data();
+        connect(entry, &Entry::modified, db, [db, entry] { db->indexEntry(entry); });
+        db->indexEntry(entry);
     }
 
     emitModified();
@@ -998,6 +1121,7 @@ void Group::removeEntry(Entry* entry)
     entry->disconnect(this);
     if (m_db) {
         entry->disconnect(m_db);
+        m_db->unindexEntry(entry);
     }
     m_entries.removeAll(entry);
     emitModified();
@@ -1039,9 +1163,11 @@ void Group::connectDatabaseSignalsRecursive(Database* db)
     for (Entry* entry : asConst(m_entries)) {
         if (m_db) {
             entry->disconnect(m_db);
+            m_db->unindexEntry(entry);
         }
         if (db) {
             connect(entry, &Entry::modified, db, &Database::markAsModified);
+            connect(entry, &Entry::modified, db, [db, entry] { db->indexEntry(entry); });
         }
     }
 
@@ -1061,6 +1187,12 @@ void Group::connectDatabaseSignalsRecursive(Database* db)
 
     m_db = db;
 
+    if (db) {
+        for (Entry* entry : asConst(m_entries)) {
+            db->indexEntry(entry);
+        }
+    }
+
     for (Group* group : asConst(m_children)) {
         group->connectDatabaseSignalsRecursive(db);
     }
@@ -1096,9 +1228,14 @@ bool Group::resolveSearchingEnabled() const
     case Inherit:
         if (!m_parent) {
             return true;
-        } else {
+        }
+        if (!canCache()) {
             return m_parent->resolveSearchingEnabled();
         }
+        if (m_resolvedSearchingEnabled == Inherit) {
+            m_resolvedSearchingEnabled = m_parent->resolveSearchingEnabled() ? Enable : Disable;
+        }
+        return m_resolvedSearchingEnabled == Enable;
     case Enable:
         return true;
     case Disable:
@@ -1115,9 +1252,14 @@ bool Group::resolveAutoTypeEnabled() const
     case Inherit:
         if (!m_parent) {
             return true;
-        } else {
+        }
+        if (!canCache()) {
             return m_parent->resolveAutoTypeEnabled();
         }
+        if (m_resolvedAutoTypeEnabled == Inherit) {
+            m_resolvedAutoTypeEnabled = m_parent->resolveAutoTypeEnabled() ? Enable : Disable;
+        }
+        return m_resolvedAutoTypeEnabled == Enable;
     case Enable:
         return true;
     case Disable:
@@ -203,11 +203,18 @@ private slots:
     void updateTimeinfo();
 
 private:
+    void emitModified() override;
+    void emitDeferredModified(bool updateTimeinfo);
     template <class P, class V> bool set(P& property, const V& value);
 
     void setParent(Database* db);
 
     void connectDatabaseSignalsRecursive(Database* db);
+    void invalidateResolvedSettings();
+    void invalidateInheritedSettings();
+    bool resolveCustomDataValue(const QString& key, QString& value) const;
+    void invalidateHierarchy();
+    bool canCache() const;
     void cleanupParent();
     void recCreateDelObjects();
 
@@ -225,9 +232,18 @@ private:
 
     QPointer<Group> m_parent;
 
+    // Settings inherited from the parent groups, resolved on first use. Inherit means not resolved yet.
+    // The caches below are only filled and read on the thread owning the group, see canCache().
+    mutable TriState m_resolvedSearchingEnabled = Inherit;
+    mutable TriState m_resolvedAutoTypeEnabled = Inherit;
+    mutable QHash<QString, QPair<bool, QString>> m_resolvedCustomData;
+    // Names of all ancestors and the full path, built on first use and cleared when an ancestor changes
+    mutable QStringList m_hierarchy;
+    mutable QString m_fullPath;
+
     bool m_updateTimeinfo;
 
-    friend Group* Database::setRootGroup(Group* group);
+    friend class Database;
 };
 
 Q_DECLARE_OPERATORS_FOR_FLAGS(Group::CloneFlags)
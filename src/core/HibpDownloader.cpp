@@ -16,13 +16,23 @@
  */
 
 #include "HibpDownloader.h"
+#include "core/Clock.h"
+#include "core/Global.h"
 #include "core/NetworkManager.h"
 
 #include <QCryptographicHash>
+#include <QDir>
+#include <QFileInfo>
+#include <QMap>
 #include <QNetworkReply>
+#include <QSaveFile>
+#include <QStandardPaths>
+#include <QTimer>
 
 namespace
 {
+    const QString DefaultApiUrl = QStringLiteral("https://api.pwnedpasswords.com/range/");
+
     /*
      * Return the SHA1 hash of the specified password in upper-case hex.
      *
@@ -66,6 +76,7 @@ namespace
 
 HibpDownloader::HibpDownloader(QObject* parent)
     : QObject(parent)
+    , m_apiUrl(DefaultApiUrl)
 {
 }
 
@@ -92,49 +103,184 @@ void HibpDownloader::add(const QString& password)
  */
 void HibpDownloader::validate()
 {
-    for (auto password : m_pwdsToTry) {
-        // The URL we query is https://api.pwnedpasswords.com/range/XXXXX,
-        // where XXXXX is the first five bytes of the hex representation of
-        // the password's SHA1.
-        const auto url = QString("https://api.pwnedpasswords.com/range/") + sha1Hex(password).left(5);
+    // The URL we query is https://api.pwnedpasswords.com/range/XXXXX,
+    // where XXXXX is the first five bytes of the hex representation of
+    // the password's SHA1. All passwords sharing these five bytes are
+    // answered by the same response.
+    QMap<QString, QStringList> passwordsByPrefix;
+    for (const auto& password : asConst(m_pwdsToTry)) {
+        passwordsByPrefix[sha1Hex(password).left(5)] << password;
+    }
+    for (auto it = passwordsByPrefix.constBegin(); it != passwordsByPrefix.constEnd(); ++it) {
+        m_queue.append({it.key(), it.value(), {}});
+    }
+
+    m_remaining += m_pwdsToTry.size();
+    m_pwdsToTry.clear();
+
+    // Results are always reported from the event loop, even if they are cached
+    QTimer::singleShot(0, this, &HibpDownloader::processQueue);
+}
+
+int HibpDownloader::passwordsToValidate() const
+{
+    return m_pwdsToTry.size();
+}
+
+int HibpDownloader::passwordsRemaining() const
+{
+    return m_remaining;
+}
+
+/*
+ * Set the URL the hash prefixes are appended to.
+ */
+void HibpDownloader::setApiUrl(const QString& url)
+{
+    m_apiUrl = url;
+}
+
+/*
+ * Set the directory to cache the responses in, an empty path disables the cache.
+ * The cache is disabled by default: the cached prefixes tell which passwords were checked.
+ */
+void HibpDownloader::setCacheDirectory(const QString& path)
+{
+    m_cacheDir = path;
+}
+
+/*
+ * Set how long a cached response is used before it is queried again.
+ */
+void HibpDownloader::setCacheExpiry(int seconds)
+{
+    m_cacheExpiry = seconds;
+}
+
+/*
+ * Abort the current online activity (if any).
+ */
+void HibpDownloader::abort()
+{
+    for (auto reply : m_replies.keys()) {
+        reply->abort();
+        reply->deleteLater();
+    }
+    m_replies.clear();
+    m_queue.clear();
+    m_remaining = 0;
+}
+
+/*
+ * Answer queued prefixes from the cache and start requests for
+ * the others until the limit of concurrent requests is reached.
+ */
+void HibpDownloader::processQueue()
+{
+    while (!m_queue.isEmpty() && m_replies.size() < MaxRequests) {
+        auto query = m_queue.takeFirst();
+        if (readCache(query.prefix, query.response)) {
+            report(query);
+            continue;
+        }
 
         // HIBP requires clients to specify a user agent in the request
         // (https://haveibeenpwned.com/API/v3#UserAgent); however, in order
         // to minimize the amount of information we expose about ourselves,
         // we don't add the KeePassXC version number or platform.
-        auto request = QNetworkRequest(url);
+        auto request = QNetworkRequest(m_apiUrl + query.prefix);
         request.setRawHeader("User-Agent", "KeePassXC");
 
         // Finally, submit the request to HIBP.
         auto reply = getNetMgr()->get(request);
         connect(reply, &QNetworkReply::finished, this, &HibpDownloader::fetchFinished);
         connect(reply, &QIODevice::readyRead, this, &HibpDownloader::fetchReadyRead);
-        m_replies.insert(reply, {password, {}});
+        m_replies.insert(reply, query);
     }
+}
 
-    m_pwdsToTry.clear();
+/*
+ * Read the cached response for a prefix, fails if there is none or it expired.
+ */
+bool HibpDownloader::readCache(const QString& prefix, QByteArray& response) const
+{
+    if (m_cacheDir.isEmpty() || m_cacheExpiry <= 0) {
+        return false;
+    }
+
+    QFile file(QDir(m_cacheDir).filePath(prefix));
+    const auto modified = QFileInfo(file).lastModified().toUTC();
+    if (!modified.isValid() || modified.secsTo(Clock::currentDateTimeUtc()) >= m_cacheExpiry) {
+        return false;
+    }
+    if (!file.open(QIODevice::ReadOnly)) {
+        return false;
+    }
+
+    response = file.readAll();
+    return file.error() == QFile::NoError;
 }
 
-int HibpDownloader::passwordsToValidate() const
+void HibpDownloader::writeCache(const QString& prefix, const QByteArray& response) const
 {
-    return m_pwdsToTry.size();
+    if (m_cacheDir.isEmpty()) {
+        return;
+    }
+
+    // The prefixes tell which passwords were checked, keep them private
+    QDir dir(m_cacheDir);
+    if (!dir.exists()) {
+        if (!QDir().mkpath(m_cacheDir)
+            || !QFile::setPermissions(m_cacheDir, QFile::ReadOwner | QFile::WriteOwner | QFile::ExeOwner)) {
+            dir.removeRecursively();
+            return;
+        }
+    }
+
+    QSaveFile file(dir.filePath(prefix));
+    if (!file.open(QIODevice::WriteOnly) || !file.setPermissions(QFile::ReadOwner | QFile::WriteOwner)) {
+        return;
+    }
+    if (file.write(response) == response.size()) {
+        file.commit();
+    }
 }
 
-int HibpDownloader::passwordsRemaining() const
+/*
+ * Default location of the response cache, empty if there is no cache location.
+ */
+QString HibpDownloader::defaultCacheDirectory()
 {
-    return m_replies.size();
+    const auto cacheLocation = QStandardPaths::writableLocation(QStandardPaths::CacheLocation);
+    if (cacheLocation.isEmpty()) {
+        return {};
+    }
+    return cacheLocation + "/hibp";
 }
 
 /*
- * Abort the current online activity (if any).
+ * Delete all responses cached in the default location.
  */
-void HibpDownloader::abort()
+void HibpDownloader::removeDefaultCache()
 {
-    for (auto reply : m_replies.keys()) {
-        reply->abort();
-        reply->deleteLater();
+    const auto dir = defaultCacheDirectory();
+    if (!dir.isEmpty()) {
+        QDir(dir).removeRecursively();
+    }
+}
+
+/*
+ * Send the results of all passwords of a prefix to the caller.
+ */
+void HibpDownloader::report(const RangeQuery& query)
+{
+    const auto range = QString::fromLatin1(query.response);
+    for (const auto& password : query.passwords) {
+        if (m_remaining > 0) {
+            --m_remaining;
+        }
+        emit hibpResult(password, pwnCount(password, range));
     }
-    m_replies.clear();
 }
 
 /*
@@ -145,7 +291,7 @@ void HibpDownloader::fetchReadyRead()
     const auto reply = qobject_cast<QNetworkReply*>(sender());
     auto entry = m_replies.find(reply);
     if (entry != m_replies.end()) {
-        entry->second += reply->readAll();
+        entry->response += reply->readAll();
     }
 }
 
@@ -164,24 +310,25 @@ void HibpDownloader::fetchFinished()
     const auto ok = reply->error() == QNetworkReply::NoError;
     const auto err = reply->errorString();
 
-    const auto password = entry->first;
-    const auto hibpReply = entry->second;
+    const auto query = entry.value();
 
     reply->deleteLater();
-    m_replies.remove(reply);
+    m_replies.erase(entry);
 
     // If there was an error, assume it's permanent and abort
     // (don't process the rest of the password list).
     if (!ok) {
         auto msg = tr("Online password validation failed") + ":\n" + err;
-        if (!hibpReply.isEmpty()) {
-            msg += "\n" + hibpReply;
+        if (!query.response.isEmpty()) {
+            msg += "\n" + query.response;
         }
         abort();
         emit fetchFailed(msg);
         return;
     }
 
-    // Current password validated, send the result to the caller
-    emit hibpResult(password, pwnCount(password, hibpReply));
+    // Current prefix validated, send the results to the caller
+    writeCache(query.prefix, query.response);
+    report(query);
+    processQueue();
 }
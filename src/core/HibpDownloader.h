@@ -21,6 +21,7 @@
 #include "config-keepassx.h"
 #include <QHash>
 #include <QObject>
+#include <QStringList>
 
 #ifndef WITH_XC_NETWORKING
 #error This file requires KeePassXC to be built with network support.
@@ -33,9 +34,15 @@ class QNetworkReply;
  * "Have I Been Pwned" website (https://haveibeenpwned.com/)
  * in the background.
  *
- * Usage: Pass the password to check to the ctor and process
- * the `finished` signal to get the result. Process the
- * `failed` signal to handle errors.
+ * Usage: Pass the passwords to check to add(), call validate() and
+ * process the `hibpResult` signal to get the results. Process the
+ * `fetchFailed` signal to handle errors.
+ *
+ * Passwords sharing the same hash prefix are looked up with a single
+ * request and at most MaxRequests requests run at the same time. If a
+ * cache directory is set, the responses are cached on disk, so checking
+ * the same passwords again only queries the prefixes whose cache entry
+ * expired.
  */
 class HibpDownloader : public QObject
 {
@@ -45,11 +52,21 @@ public:
     explicit HibpDownloader(QObject* parent = nullptr);
     ~HibpDownloader() override;
 
+    static constexpr int MaxRequests = 6;
+    static constexpr int DefaultCacheExpiry = 24 * 60 * 60;
+
     void add(const QString& password);
     void validate();
     int passwordsToValidate() const;
     int passwordsRemaining() const;
 
+    void setApiUrl(const QString& url);
+    void setCacheDirectory(const QString& path);
+    void setCacheExpiry(int seconds);
+
+    static QString defaultCacheDirectory();
+    static void removeDefaultCache();
+
 signals:
     void hibpResult(const QString& password, int count);
     void fetchFailed(const QString& error);
@@ -60,10 +77,27 @@ public slots:
 private slots:
     void fetchFinished();
     void fetchReadyRead();
+    void processQueue();
 
 private:
-    QStringList m_pwdsToTry; // The list of remaining passwords to validate
-    QHash<QNetworkReply*, QPair<QString, QByteArray>> m_replies;
+    struct RangeQuery
+    {
+        QString prefix;
+        QStringList passwords;
+        QByteArray response;
+    };
+
+    bool readCache(const QString& prefix, QByteArray& response) const;
+    void writeCache(const QString& prefix, const QByteArray& response) const;
+    void report(const RangeQuery& query);
+
+    QStringList m_pwdsToTry; // The list of passwords added since the last validate()
+    QList<RangeQuery> m_queue; // Prefixes waiting for a free request slot
+    QHash<QNetworkReply*, RangeQuery> m_replies;
+    int m_remaining = 0; // Passwords queued or in flight
+    QString m_apiUrl;
+    QString m_cacheDir;
+    int m_cacheExpiry = DefaultCacheExpiry;
 };
 
 #endif // KEEPASSXC_HIBPDOWNLOADER_H
@@ -68,6 +68,8 @@ QStringList Merger::merge()
 {
     // Order of merge steps is important - it is possible that we
     // create some items before deleting them afterwards
+    m_context.m_targetDb->beginBatchUpdate();
+
     ChangeList changes;
     changes << mergeGroup(m_context);
     changes << mergeDeletions(m_context);
@@ -77,6 +79,8 @@ QStringList Merger::merge()
     if (!changes.isEmpty()) {
         m_context.m_targetDb->markAsModified();
     }
+
+    m_context.m_targetDb->endBatchUpdate();
     return changes;
 }
 
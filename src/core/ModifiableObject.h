@@ -46,7 +46,7 @@ public slots:
     void setEmitModified(bool value);
 
 protected:
-    void emitModified();
+    virtual void emitModified();
 
 signals:
     void modified();
@@ -15,16 +15,25 @@
  *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
  */
 
+#include <QDataStream>
+#include <QSet>
 #include <QString>
+#include <QtConcurrent>
 
 #include "Clock.h"
 #include "Group.h"
 #include "PasswordHealth.h"
+#include "crypto/CryptoHash.h"
+#include "crypto/Random.h"
 #include "zxcvbn.h"
 
 namespace
 {
     const static int ZXCVBN_ESTIMATE_THRESHOLD = 256;
+
+    const quint8 HEALTH_CACHE_VERSION = 1;
+    const int HEALTH_CACHE_KEY_SIZE = 32;
+    const int HEALTH_CACHE_HASH_SIZE = 16;
 } // namespace
 
 PasswordHealth::PasswordHealth(double entropy)
@@ -33,6 +42,11 @@ PasswordHealth::PasswordHealth(double entropy)
 }
 
 PasswordHealth::PasswordHealth(const QString& pwd)
+{
+    init(estimateEntropy(pwd));
+}
+
+double PasswordHealth::estimateEntropy(const QString& pwd)
 {
     auto entropy = 0.0;
     entropy += ZxcvbnMatch(pwd.left(ZXCVBN_ESTIMATE_THRESHOLD).toUtf8(), nullptr, nullptr);
@@ -41,7 +55,24 @@ PasswordHealth::PasswordHealth(const QString& pwd)
         auto average = entropy / ZXCVBN_ESTIMATE_THRESHOLD;
         entropy += average * (pwd.length() - ZXCVBN_ESTIMATE_THRESHOLD);
     }
-    init(entropy);
+    return entropy;
+}
+
+/**
+ * Estimate the entropy of many passwords at once, spread over the global thread pool.
+ *
+ * @return the estimates in the order of the passwords
+ */
+QVector<double> PasswordHealth::estimateEntropies(const QStringList& passwords)
+{
+    if (passwords.size() < 2) {
+        QVector<double> entropies;
+        for (const auto& pwd : passwords) {
+            entropies.append(estimateEntropy(pwd));
+        }
+        return entropies;
+    }
+    return QtConcurrent::blockingMapped<QVector<double>>(passwords, &PasswordHealth::estimateEntropy);
 }
 
 void PasswordHealth::init(double entropy)
@@ -110,11 +141,143 @@ PasswordHealth::Quality PasswordHealth::quality() const
     return Quality::Excellent;
 }
 
+PasswordHealthCache::PasswordHealthCache()
+    : m_key(randomGen()->randomArray(HEALTH_CACHE_KEY_SIZE))
+{
+}
+
+/**
+ * Entropy of the password, estimated only if it is not cached yet.
+ */
+double PasswordHealthCache::entropy(const QString& pwd)
+{
+    QMutexLocker locker(&m_mutex);
+    const auto hash = passwordHash(pwd);
+    auto cached = m_entropies.constFind(hash);
+    if (cached != m_entropies.constEnd()) {
+        return cached.value();
+    }
+
+    // Don't block other threads while estimating
+    locker.unlock();
+    const auto entropy = PasswordHealth::estimateEntropy(pwd);
+    locker.relock();
+
+    m_entropies.insert(hash, entropy);
+    return entropy;
+}
+
+/**
+ * Estimate all passwords that are not cached yet in parallel, see PasswordHealth::estimateEntropies().
+ */
+void PasswordHealthCache::prefetch(const QStringList& passwords)
+{
+    QStringList missing;
+    QList<QByteArray> hashes;
+    {
+        QMutexLocker locker(&m_mutex);
+        QSet<QByteArray> seen;
+        for (const auto& pwd : passwords) {
+            const auto hash = passwordHash(pwd);
+            if (!m_entropies.contains(hash) && !seen.contains(hash)) {
+                seen.insert(hash);
+                missing.append(pwd);
+                hashes.append(hash);
+            }
+        }
+    }
+
+    if (missing.isEmpty()) {
+        return;
+    }
+
+    // Don't block other threads while estimating
+    const auto entropies = PasswordHealth::estimateEntropies(missing);
+
+    QMutexLocker locker(&m_mutex);
+    for (int i = 0; i < hashes.size(); ++i) {
+        m_entropies.insert(hashes[i], entropies[i]);
+    }
+}
+
+int PasswordHealthCache::size() const
+{
+    QMutexLocker locker(&m_mutex);
+    return m_entropies.size();
+}
+
+/**
+ * Forget all estimates and start over with a new key.
+ */
+void PasswordHealthCache::clear()
+{
+    QMutexLocker locker(&m_mutex);
+    m_key = randomGen()->randomArray(HEALTH_CACHE_KEY_SIZE);
+    m_entropies.clear();
+}
+
+/**
+ * Replace the cache with data created by store().
+ *
+ * @return false if the data could not be read, the cache is unchanged in that case
+ */
+bool PasswordHealthCache::restore(const QString& data)
+{
+    QDataStream stream(QByteArray::fromBase64(data.toLatin1()));
+    stream.setVersion(QDataStream::Qt_5_0);
+
+    quint8 version = 0;
+    QByteArray key;
+    QHash<QByteArray, double> entropies;
+    stream >> version;
+    if (version != HEALTH_CACHE_VERSION) {
+        return false;
+    }
+    stream >> key >> entropies;
+    if (stream.status() != QDataStream::Ok || key.size() != HEALTH_CACHE_KEY_SIZE) {
+        return false;
+    }
+
+    QMutexLocker locker(&m_mutex);
+    m_key = key;
+    m_entropies = entropies;
+    return true;
+}
+
+/**
+ * Serialize the estimates of the given passwords, other estimates are left out.
+ */
+QString PasswordHealthCache::store(const QStringList& passwords) const
+{
+    QMutexLocker locker(&m_mutex);
+
+    QHash<QByteArray, double> entropies;
+    for (const auto& pwd : passwords) {
+        const auto hash = passwordHash(pwd);
+        auto cached = m_entropies.constFind(hash);
+        if (cached != m_entropies.constEnd()) {
+            entropies.insert(hash, cached.value());
+        }
+    }
+
+    QByteArray data;
+    QDataStream stream(&data, QIODevice::WriteOnly);
+    stream.setVersion(QDataStream::Qt_5_0);
+    stream << HEALTH_CACHE_VERSION << m_key << entropies;
+    return QString::fromLatin1(data.toBase64());
+}
+
+QByteArray PasswordHealthCache::passwordHash(const QString& pwd) const
+{
+    return CryptoHash::hmac(pwd.toUtf8(), m_key, CryptoHash::Sha256).left(HEALTH_CACHE_HASH_SIZE);
+}
+
 /**
  * This class provides additional information about password health
  * than can be derived from the password itself (re-use, expiry).
  */
 HealthChecker::HealthChecker(QSharedPointer<Database> db)
+    : m_db(db)
 {
     // Build the cache of re-used passwords
     for (const auto* entry : db->rootGroup()->entriesRecursive()) {
@@ -123,6 +286,9 @@ HealthChecker::HealthChecker(QSharedPointer<Database> db)
                 << QObject::tr("Used in %1/%2").arg(entry->group()->hierarchy().join('/'), entry->title());
         }
     }
+
+    // Estimate all passwords up front, evaluate() is called for every entry
+    m_db->passwordHealthCache()->prefetch(m_reuse.keys());
 }
 
 /**
@@ -140,7 +306,7 @@ QSharedPointer<PasswordHealth> HealthChecker::evaluate(const Entry* entry) const
 
     // First analyse the password itself
     const auto pwd = entry->password();
-    auto health = QSharedPointer<PasswordHealth>(new PasswordHealth(pwd));
+    auto health = QSharedPointer<PasswordHealth>(new PasswordHealth(m_db->passwordHealthCache()->entropy(pwd)));
 
     // Second, if the password is in the database more than once,
     // reduce the score accordingly
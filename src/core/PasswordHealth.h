@@ -19,7 +19,9 @@
 #define KEEPASSX_PASSWORDHEALTH_H
 
 #include <QHash>
+#include <QMutex>
 #include <QSharedPointer>
+#include <QVector>
 
 class Database;
 class Entry;
@@ -37,6 +39,9 @@ public:
 
     void init(double entropy);
 
+    static double estimateEntropy(const QString& pwd);
+    static QVector<double> estimateEntropies(const QStringList& passwords);
+
     /*
      * The password score is defined to be the greater the better
      * (more secure) the password is. It doesn't have a dimension,
@@ -97,6 +102,34 @@ private:
     QStringList m_scoreDetails;
 };
 
+/**
+ * Entropy estimates of the passwords of a database, keyed by a keyed hash of the password.
+ *
+ * The estimate is the expensive part of a health check. The cache outlives password
+ * edits and can be stored in the encrypted database, so the estimates are available
+ * right after unlocking it.
+ */
+class PasswordHealthCache
+{
+public:
+    PasswordHealthCache();
+
+    double entropy(const QString& pwd);
+    void prefetch(const QStringList& passwords);
+    int size() const;
+    void clear();
+
+    bool restore(const QString& data);
+    QString store(const QStringList& passwords) const;
+
+private:
+    QByteArray passwordHash(const QString& pwd) const;
+
+    QByteArray m_key;
+    QHash<QByteArray, double> m_entropies;
+    mutable QMutex m_mutex;
+};
+
 /**
  * Password health check for all entries of a database.
  *
@@ -111,6 +144,7 @@ public:
     QSharedPointer<PasswordHealth> evaluate(const Entry* entry) const;
 
 private:
+    QSharedPointer<Database> m_db;
     // To determine password re-use: first = password, second = entries that use it
     QHash<QString, QStringList> m_reuse;
 };
@@ -0,0 +1,90 @@
+/*
+ *  Copyright (C) 2024 KeePassXC Team <team@keepassxc.org>
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 2 or (at your option)
+ *  version 3 of the License.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "PhaseTimings.h"
+
+const QString PhaseTimings::Header = QStringLiteral("header");
+const QString PhaseTimings::Kdf = QStringLiteral("kdf");
+const QString PhaseTimings::Binaries = QStringLiteral("binaries");
+const QString PhaseTimings::Xml = QStringLiteral("xml");
+const QString PhaseTimings::Cache = QStringLiteral("cache");
+const QString PhaseTimings::Read = QStringLiteral("read");
+const QString PhaseTimings::Decrypt = QStringLiteral("decrypt");
+const QString PhaseTimings::Decompress = QStringLiteral("decompress");
+const QString PhaseTimings::Model = QStringLiteral("model");
+const QString PhaseTimings::Compress = QStringLiteral("compress");
+const QString PhaseTimings::Encrypt = QStringLiteral("encrypt");
+const QString PhaseTimings::Write = QStringLiteral("write");
+const QString PhaseTimings::Commit = QStringLiteral("commit");
+
+/**
+ * Add time to a phase. The phase is created if it was not recorded yet.
+ *
+ * @param phase name of the phase
+ * @param nsecs time spent in nanoseconds, negative values are clamped to zero
+ */
+void PhaseTimings::add(const QString& phase, qint64 nsecs)
+{
+    nsecs = qMax<qint64>(nsecs, 0);
+    for (auto& existing : m_phases) {
+        if (existing.name == phase) {
+            existing.nsecs += nsecs;
+            return;
+        }
+    }
+    m_phases.append({phase, nsecs});
+}
+
+/**
+ * @return time spent in the phase in nanoseconds, 0 if it was not recorded
+ */
+qint64 PhaseTimings::value(const QString& phase) const
+{
+    for (const auto& existing : m_phases) {
+        if (existing.name == phase) {
+            return existing.nsecs;
+        }
+    }
+    return 0;
+}
+
+/**
+ * @return time spent in all phases in nanoseconds
+ */
+qint64 PhaseTimings::total() const
+{
+    qint64 total = 0;
+    for (const auto& phase : m_phases) {
+        total += phase.nsecs;
+    }
+    return total;
+}
+
+const QList<PhaseTimings::Phase>& PhaseTimings::phases() const
+{
+    return m_phases;
+}
+
+bool PhaseTimings::isEmpty() const
+{
+    return m_phases.isEmpty();
+}
+
+void PhaseTimings::clear()
+{
+    m_phases.clear();
+}
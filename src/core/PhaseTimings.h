@@ -0,0 +1,69 @@
+/*
+ *  Copyright (C) 2024 KeePassXC Team <team@keepassxc.org>
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 2 or (at your option)
+ *  version 3 of the License.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef KEEPASSXC_PHASETIMINGS_H
+#define KEEPASSXC_PHASETIMINGS_H
+
+#include <QList>
+#include <QString>
+
+/**
+ * Time spent in the phases of opening or saving a database.
+ *
+ * Phases are exclusive: time spent in one phase is never counted in another one,
+ * so the sum of all phases is the total time. Phases keep the order in which
+ * they were first recorded.
+ */
+class PhaseTimings
+{
+public:
+    struct Phase
+    {
+        QString name;
+        qint64 nsecs;
+    };
+
+    // Phases shared by opening and saving
+    static const QString Header;
+    static const QString Kdf;
+    static const QString Binaries;
+    static const QString Xml;
+    static const QString Cache;
+    // Phases of opening a database
+    static const QString Read;
+    static const QString Decrypt;
+    static const QString Decompress;
+    static const QString Model;
+    // Phases of saving a database
+    static const QString Compress;
+    static const QString Encrypt;
+    static const QString Write;
+    static const QString Commit;
+
+    void add(const QString& phase, qint64 nsecs);
+    qint64 value(const QString& phase) const;
+    qint64 total() const;
+    const QList<Phase>& phases() const;
+
+    bool isEmpty() const;
+    void clear();
+
+private:
+    QList<Phase> m_phases;
+};
+
+#endif // KEEPASSXC_PHASETIMINGS_H
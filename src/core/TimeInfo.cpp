@@ -17,11 +17,29 @@
 
 #include "TimeInfo.h"
 
+#include <limits>
+
+namespace
+{
+    // Marks an invalid QDateTime
+    constexpr qint64 InvalidTime = std::numeric_limits<qint64>::min();
+
+    qint64 comparable(qint64 msecs, CompareItemOptions options)
+    {
+        if (msecs == InvalidTime || !options.testFlag(CompareItemIgnoreMilliseconds)) {
+            return msecs;
+        }
+        // Round towards the beginning of the second, also before the epoch
+        qint64 remainder = msecs % 1000;
+        return remainder < 0 ? msecs - remainder - 1000 : msecs - remainder;
+    }
+} // namespace
+
 TimeInfo::TimeInfo()
-    : m_expires(false)
-    , m_usageCount(0)
+    : m_usageCount(0)
+    , m_expires(false)
 {
-    QDateTime now = Clock::currentDateTimeUtc();
+    qint64 now = Clock::currentDateTimeUtc().toMSecsSinceEpoch();
     m_lastModificationTime = now;
     m_creationTime = now;
     m_lastAccessTime = now;
@@ -29,24 +47,34 @@ TimeInfo::TimeInfo()
     m_locationChanged = now;
 }
 
+qint64 TimeInfo::toMSecs(const QDateTime& dateTime)
+{
+    return dateTime.isValid() ? dateTime.toMSecsSinceEpoch() : InvalidTime;
+}
+
+QDateTime TimeInfo::toDateTime(qint64 msecs)
+{
+    return msecs == InvalidTime ? QDateTime() : QDateTime::fromMSecsSinceEpoch(msecs, Qt::UTC);
+}
+
 QDateTime TimeInfo::lastModificationTime() const
 {
-    return m_lastModificationTime;
+    return toDateTime(m_lastModificationTime);
 }
 
 QDateTime TimeInfo::creationTime() const
 {
-    return m_creationTime;
+    return toDateTime(m_creationTime);
 }
 
 QDateTime TimeInfo::lastAccessTime() const
 {
-    return m_lastAccessTime;
+    return toDateTime(m_lastAccessTime);
 }
 
 QDateTime TimeInfo::expiryTime() const
 {
-    return m_expiryTime;
+    return toDateTime(m_expiryTime);
 }
 
 bool TimeInfo::expires() const
@@ -61,31 +89,50 @@ int TimeInfo::usageCount() const
 
 QDateTime TimeInfo::locationChanged() const
 {
-    return m_locationChanged;
+    return toDateTime(m_locationChanged);
+}
+
+/**
+ * @return last modification time in milliseconds since the epoch, for comparisons without QDateTime
+ */
+qint64 TimeInfo::lastModificationMSecs() const
+{
+    return m_lastModificationTime;
+}
+
+/**
+ * Check for expiry against a point in time taken once for a whole batch of items.
+ *
+ * @param msecsSinceEpoch point in time, see Clock::currentMilliSecondsSinceEpoch()
+ * @return true if the item expires and its expiry time is before the given time
+ */
+bool TimeInfo::expiresBefore(qint64 msecsSinceEpoch) const
+{
+    return m_expires && m_expiryTime != InvalidTime && m_expiryTime < msecsSinceEpoch;
 }
 
 void TimeInfo::setLastModificationTime(const QDateTime& dateTime)
 {
     Q_ASSERT(dateTime.timeSpec() == Qt::UTC);
-    m_lastModificationTime = dateTime;
+    m_lastModificationTime = toMSecs(dateTime);
 }
 
 void TimeInfo::setCreationTime(const QDateTime& dateTime)
 {
     Q_ASSERT(dateTime.timeSpec() == Qt::UTC);
-    m_creationTime = dateTime;
+    m_creationTime = toMSecs(dateTime);
 }
 
 void TimeInfo::setLastAccessTime(const QDateTime& dateTime)
 {
     Q_ASSERT(dateTime.timeSpec() == Qt::UTC);
-    m_lastAccessTime = dateTime;
+    m_lastAccessTime = toMSecs(dateTime);
 }
 
 void TimeInfo::setExpiryTime(const QDateTime& dateTime)
 {
     Q_ASSERT(dateTime.timeSpec() == Qt::UTC);
-    m_expiryTime = dateTime;
+    m_expiryTime = toMSecs(dateTime);
 }
 
 void TimeInfo::setExpires(bool expires)
@@ -101,7 +148,7 @@ void TimeInfo::setUsageCount(int count)
 void TimeInfo::setLocationChanged(const QDateTime& dateTime)
 {
     Q_ASSERT(dateTime.timeSpec() == Qt::UTC);
-    m_locationChanged = dateTime;
+    m_locationChanged = toMSecs(dateTime);
 }
 
 bool TimeInfo::operator==(const TimeInfo& other) const
@@ -117,22 +164,22 @@ bool TimeInfo::operator!=(const TimeInfo& other) const
 bool TimeInfo::equals(const TimeInfo& other, CompareItemOptions options) const
 {
     // clang-format off
-    if (::compare(m_lastModificationTime, other.m_lastModificationTime, options) != 0) {
+    if (::compare(comparable(m_lastModificationTime, options), comparable(other.m_lastModificationTime, options), options) != 0) {
         return false;
     }
-    if (::compare(m_creationTime, other.m_creationTime, options) != 0) {
+    if (::compare(comparable(m_creationTime, options), comparable(other.m_creationTime, options), options) != 0) {
         return false;
     }
-    if (::compare(!options.testFlag(CompareItemIgnoreStatistics), m_lastAccessTime, other.m_lastAccessTime, options) != 0) {
+    if (::compare(!options.testFlag(CompareItemIgnoreStatistics), comparable(m_lastAccessTime, options), comparable(other.m_lastAccessTime, options), options) != 0) {
         return false;
     }
-    if (::compare(m_expires, m_expiryTime, other.m_expires, other.expiryTime(), options) != 0) {
+    if (::compare(m_expires, comparable(m_expiryTime, options), other.m_expires, comparable(other.m_expiryTime, options), options) != 0) {
         return false;
     }
     if (::compare(!options.testFlag(CompareItemIgnoreStatistics), m_usageCount, other.m_usageCount, options) != 0) {
         return false;
     }
-    if (::compare(!options.testFlag(CompareItemIgnoreLocation), m_locationChanged, other.m_locationChanged, options) != 0) {
+    if (::compare(!options.testFlag(CompareItemIgnoreLocation), comparable(m_locationChanged, options), comparable(other.m_locationChanged, options), options) != 0) {
         return false;
     }
     return true;
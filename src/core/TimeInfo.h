@@ -22,6 +22,12 @@
 
 #include "core/Compare.h"
 
+/**
+ * Timestamps of an entry or group.
+ *
+ * Times are kept as milliseconds since the Unix epoch in UTC, they are only turned into
+ * QDateTime when requested through the accessors.
+ */
 class TimeInfo
 {
 public:
@@ -35,6 +41,9 @@ public:
     int usageCount() const;
     QDateTime locationChanged() const;
 
+    qint64 lastModificationMSecs() const;
+    bool expiresBefore(qint64 msecsSinceEpoch) const;
+
     bool operator==(const TimeInfo& other) const;
     bool operator!=(const TimeInfo& other) const;
     bool equals(const TimeInfo& other, CompareItemOptions options = CompareItemDefault) const;
@@ -48,13 +57,16 @@ public:
     void setLocationChanged(const QDateTime& dateTime);
 
 private:
-    QDateTime m_lastModificationTime;
-    QDateTime m_creationTime;
-    QDateTime m_lastAccessTime;
-    QDateTime m_expiryTime;
-    bool m_expires;
+    static qint64 toMSecs(const QDateTime& dateTime);
+    static QDateTime toDateTime(qint64 msecs);
+
+    qint64 m_lastModificationTime;
+    qint64 m_creationTime;
+    qint64 m_lastAccessTime;
+    qint64 m_expiryTime;
+    qint64 m_locationChanged;
     int m_usageCount;
-    QDateTime m_locationChanged;
+    bool m_expires;
 };
 
 #endif // KEEPASSX_TIMEINFO_H
@@ -57,6 +57,33 @@ namespace Tools
 #endif
     }
 
+    /**
+     * Let the values of map share their storage with equal values in other.
+     * The map is only detached if anything can be shared, its contents do not change.
+     *
+     * @param map map to deduplicate, values must be implicitly shared (e.g. QString, QByteArray)
+     * @param other map to share values with
+     */
+    template <class Map> void shareEqualValues(Map& map, const Map& other)
+    {
+        if (map == other) {
+            map = other;
+            return;
+        }
+
+        QList<typename Map::key_type> sharedKeys;
+        for (auto it = map.constBegin(); it != map.constEnd(); ++it) {
+            auto otherIt = other.constFind(it.key());
+            if (otherIt != other.constEnd() && !otherIt.value().isSharedWith(it.value())
+                && otherIt.value() == it.value()) {
+                sharedKeys.append(it.key());
+            }
+        }
+        for (const auto& key : asConst(sharedKeys)) {
+            map[key] = other.value(key);
+        }
+    }
+
     /**
      * Escapes all characters in regex such that they do not receive any special treatment when used
      * in a regular expression. Essentially, this function escapes any characters not in a-zA-Z0-9.
@@ -22,7 +22,6 @@
 #include "fdosecrets/objects/Prompt.h"
 #include "fdosecrets/objects/Service.h"
 
-#include "core/Tools.h"
 #include "gui/DatabaseWidget.h"
 #include "gui/GuiTools.h"
 
@@ -245,47 +244,81 @@ namespace FdoSecrets
             return {};
         }
 
-        QList<EntrySearcher::SearchTerm> terms;
+        // searching using empty terms returns nothing
+        if (attributes.isEmpty()) {
+            return {};
+        }
+
+        // intersect the candidate sets from the index, starting with the most selective one
+        QList<const QSet<Item*>*> candidates;
+        candidates.reserve(attributes.size());
         for (auto it = attributes.constBegin(); it != attributes.constEnd(); ++it) {
-            terms << attributeToTerm(it.key(), it.value());
-        }
-
-        constexpr auto caseSensitive = false;
-        constexpr auto skipProtected = true;
-        constexpr auto forceSearch = true;
-        const auto foundEntries =
-            EntrySearcher(caseSensitive, skipProtected).search(terms, m_exposedGroup, forceSearch);
-        items.reserve(foundEntries.size());
-        for (const auto& entry : foundEntries) {
-            const auto item = m_entryToItem.value(entry);
-            // it's possible that we don't have a corresponding item for the entry
-            // this can happen when the recycle bin is below the exposed group.
-            if (item) {
+            auto found = m_attributeIndex.constFind({it.key(), it.value()});
+            if (found == m_attributeIndex.constEnd()) {
+                candidates.clear();
+                break;
+            }
+            candidates << &found.value();
+        }
+
+        if (!candidates.isEmpty()) {
+            std::sort(candidates.begin(), candidates.end(), [](const QSet<Item*>* lhs, const QSet<Item*>* rhs) {
+                return lhs->size() < rhs->size();
+            });
+
+            auto matched = *candidates.first();
+            for (int i = 1; i < candidates.size() && !matched.isEmpty(); ++i) {
+                matched.intersect(*candidates.at(i));
+            }
+            items.reserve(matched.size());
+            for (const auto& item : asConst(matched)) {
+                items << item;
+            }
+        }
+
+        // items that can not be indexed are matched directly
+        for (const auto& item : asConst(m_volatileItems)) {
+            if (!item->backend()) {
+                continue;
+            }
+            bool isVolatile = false;
+            const auto itemAttrs = searchableAttributes(item->backend(), isVolatile);
+            bool found = true;
+            for (auto it = attributes.constBegin(); found && it != attributes.constEnd(); ++it) {
+                auto attr = itemAttrs.constFind(it.key());
+                found = attr != itemAttrs.constEnd() && attr.value() == it.value();
+            }
+            if (found) {
                 items << item;
             }
         }
         return {};
     }
 
-    EntrySearcher::SearchTerm Collection::attributeToTerm(const QString& key, const QString& value)
-    {
-        static QMap<QString, EntrySearcher::Field> attrKeyToField{
-            {EntryAttributes::TitleKey, EntrySearcher::Field::Title},
-            {EntryAttributes::UserNameKey, EntrySearcher::Field::Username},
-            {EntryAttributes::URLKey, EntrySearcher::Field::Url},
-            {EntryAttributes::NotesKey, EntrySearcher::Field::Notes},
-        };
-
-        EntrySearcher::SearchTerm term{};
-        term.field = attrKeyToField.value(key, EntrySearcher::Field::AttributeValue);
-        term.word = key;
-        term.exclude = false;
-        term.regex =
-            Tools::convertToRegex(value,
-                                  Tools::RegexConvertOpts::EXACT_MATCH | Tools::RegexConvertOpts::CASE_SENSITIVE
-                                      | Tools::RegexConvertOpts::ESCAPE_REGEX);
-
-        return term;
+    StringStringMap Collection::searchableAttributes(const Entry* entry, bool& isVolatile)
+    {
+        isVolatile = false;
+
+        StringStringMap attrs;
+        const auto entryAttrs = entry->attributes();
+        const auto keys = entryAttrs->keys();
+        for (const auto& key : keys) {
+            auto value = entryAttrs->value(key);
+            if (key == EntryAttributes::TitleKey || key == EntryAttributes::UserNameKey
+                || key == EntryAttributes::URLKey) {
+                // match the resolved value, like the entry searcher does
+                auto resolved = entry->resolvePlaceholder(value);
+                if (resolved != value) {
+                    isVolatile = true;
+                }
+                attrs[key] = resolved;
+            } else if (key == EntryAttributes::NotesKey
+                       || (key != EntryAttributes::PasswordKey && !entryAttrs->isProtected(key))) {
+                // the password and protected attributes are never searchable
+                attrs[key] = value;
+            }
+        }
+        return attrs;
     }
 
     DBusResult Collection::createItem(const QVariantMap& properties,
@@ -501,6 +534,7 @@ namespace FdoSecrets
 
         m_items << item;
         m_entryToItem[entry] = item;
+        indexItem(item);
 
         // forward delete signals
         connect(entry->group(), &Group::entryAboutToRemove, item, [item](Entry* toBeRemoved) {
@@ -510,10 +544,14 @@ namespace FdoSecrets
         });
 
         // relay signals
-        connect(item, &Item::itemChanged, this, [this, item]() { emit itemChanged(item); });
+        connect(item, &Item::itemChanged, this, [this, item]() {
+            indexItem(item);
+            emit itemChanged(item);
+        });
         connect(item, &Item::itemAboutToDelete, this, [this, item]() {
             m_items.removeAll(item);
             m_entryToItem.remove(item->backend());
+            unindexItem(item);
             emit itemDeleted(item);
         });
 
@@ -522,6 +560,44 @@ namespace FdoSecrets
         }
     }
 
+    void Collection::indexItem(Item* item)
+    {
+        unindexItem(item);
+
+        if (!item->backend()) {
+            return;
+        }
+
+        bool isVolatile = false;
+        auto attrs = searchableAttributes(item->backend(), isVolatile);
+        if (isVolatile) {
+            m_volatileItems.insert(item);
+            return;
+        }
+
+        for (auto it = attrs.constBegin(); it != attrs.constEnd(); ++it) {
+            m_attributeIndex[{it.key(), it.value()}].insert(item);
+        }
+        m_indexedAttributes.insert(item, attrs);
+    }
+
+    void Collection::unindexItem(Item* item)
+    {
+        m_volatileItems.remove(item);
+
+        const auto attrs = m_indexedAttributes.take(item);
+        for (auto it = attrs.constBegin(); it != attrs.constEnd(); ++it) {
+            auto indexed = m_attributeIndex.find({it.key(), it.value()});
+            if (indexed == m_attributeIndex.end()) {
+                continue;
+            }
+            indexed->remove(item);
+            if (indexed->isEmpty()) {
+                m_attributeIndex.erase(indexed);
+            }
+        }
+    }
+
     void Collection::connectGroupSignalRecursive(Group* group)
     {
         if (group->isRecycled()) {
@@ -607,6 +683,9 @@ namespace FdoSecrets
         }
 
         m_items.clear();
+        m_attributeIndex.clear();
+        m_indexedAttributes.clear();
+        m_volatileItems.clear();
     }
 
     QString Collection::backendFilePath() const
@@ -21,7 +21,7 @@
 #include "fdosecrets/dbus/DBusClient.h"
 #include "fdosecrets/dbus/DBusObject.h"
 
-#include "core/EntrySearcher.h"
+#include <QHash>
 
 class Database;
 class DatabaseWidget;
@@ -108,7 +108,14 @@ namespace FdoSecrets
         QString backendFilePath() const;
         Service* service() const;
 
-        static EntrySearcher::SearchTerm attributeToTerm(const QString& key, const QString& value);
+        /**
+         * The attributes an entry can be looked up with in searchItems, with placeholders resolved.
+         * The password and protected attributes are left out, so a search on them matches no item.
+         * @param entry
+         * @param isVolatile set to true if any value depends on placeholders, e.g. references to other entries
+         * @return map from attribute key to the value matched exactly by searchItems
+         */
+        static StringStringMap searchableAttributes(const Entry* entry, bool& isVolatile);
 
     public slots:
         // expose some methods for Prompt to use
@@ -144,6 +151,9 @@ namespace FdoSecrets
         void connectGroupSignalRecursive(Group* group);
         void cleanupConnections();
 
+        void indexItem(Item* item);
+        void unindexItem(Item* item);
+
         bool backendLocked() const;
 
         /**
@@ -173,6 +183,12 @@ namespace FdoSecrets
         QSet<QString> m_aliases;
         QList<Item*> m_items;
         QMap<const Entry*, Item*> m_entryToItem;
+
+        // exact match index of (attribute key, value) pairs used by searchItems
+        QHash<QPair<QString, QString>, QSet<Item*>> m_attributeIndex;
+        QHash<Item*, StringStringMap> m_indexedAttributes;
+        // items whose resolved values may change without the entry being modified, always matched directly
+        QSet<Item*> m_volatileItems;
     };
 
 } // namespace FdoSecrets
@@ -27,6 +27,7 @@
 #include "core/Group.h"
 
 #include <QMimeDatabase>
+#include <QRegularExpression>
 #include <QSet>
 #include <QTextCodec>
 
@@ -389,15 +390,28 @@ namespace FdoSecrets
 
     QString Item::path() const
     {
-        QStringList pathComponents{m_backend->title()};
-
         Group* group = m_backend->group();
-        while (group && group != collection()->exposedRootGroup()) {
-            pathComponents.prepend(group->name());
-            group = group->parentGroup();
+        auto exposedRoot = collection()->exposedRootGroup();
+        if (!group || !exposedRoot) {
+            return {};
+        }
+
+        // only the groups below the exposed root group are part of the path. An item outside of it
+        // must not reveal the groups above the exposed root group, so it has no path at all.
+        int depth = group->hierarchy().size() - exposedRoot->hierarchy().size();
+        if (depth < 0) {
+            return {};
         }
-        // we should always reach the exposed root group
-        Q_ASSERT(group);
+        auto ancestor = group;
+        for (int i = 0; i < depth; ++i) {
+            ancestor = ancestor->parentGroup();
+        }
+        if (ancestor != exposedRoot) {
+            return {};
+        }
+
+        QStringList pathComponents = group->hierarchy(depth);
+        pathComponents << m_backend->title();
 
         // root group is represented by a single slash, thus adding an empty component.
         pathComponents.prepend(QLatin1Literal(""));
@@ -438,7 +452,7 @@ namespace FdoSecrets
             }
             // save the data to password field
             entry->setPassword(password);
-            if (entry->attachments()->hasKey(FDO_SECRETS_DATA)) {
+            if (asConst(*entry).attachments()->hasKey(FDO_SECRETS_DATA)) {
                 entry->attachments()->remove(FDO_SECRETS_DATA);
             }
             if (entry->attributes()->hasKey(FDO_SECRETS_CONTENT_TYPE)) {
@@ -452,8 +466,8 @@ namespace FdoSecrets
     {
         Secret ss{};
 
-        if (entry->attachments()->hasKey(FDO_SECRETS_DATA)) {
-            ss.value = entry->attachments()->value(FDO_SECRETS_DATA);
+        if (asConst(*entry).attachments()->hasKey(FDO_SECRETS_DATA)) {
+            ss.value = asConst(*entry).attachments()->value(FDO_SECRETS_DATA);
             if (entry->attributes()->hasKey(FDO_SECRETS_CONTENT_TYPE)) {
                 ss.contentType = entry->attributes()->value(FDO_SECRETS_CONTENT_TYPE);
             } else {
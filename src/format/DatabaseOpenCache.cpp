@@ -0,0 +1,703 @@
+/*
+ *  Copyright (C) 2024 KeePassXC Team <team@keepassxc.org>
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 2 or (at your option)
+ *  version 3 of the License.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "DatabaseOpenCache.h"
+
+#include "config-keepassx.h"
+#include "core/Database.h"
+#include "core/Entry.h"
+#include "core/Group.h"
+#include "core/Metadata.h"
+#include "crypto/CryptoHash.h"
+#include "crypto/Random.h"
+#include "crypto/SymmetricCipher.h"
+#include "format/KeePass2Reader.h"
+
+#include <QDataStream>
+#include <QDir>
+#include <QElapsedTimer>
+#include <QFile>
+#include <QFileInfo>
+#include <QSaveFile>
+#include <QStandardPaths>
+
+namespace
+{
+    const quint32 CACHE_SIGNATURE = 0x4f435850; // "PXCO"
+    const quint32 CACHE_VERSION = 1;
+
+    // Values read from the cache that can only be applied once all groups and entries exist
+    struct MetadataRecord
+    {
+        QUuid recycleBin;
+        QUuid entryTemplatesGroup;
+        QUuid lastSelectedGroup;
+        QUuid lastTopVisibleGroup;
+        QList<QPair<Group*, QUuid>> lastTopVisibleEntries;
+        QList<Group*> groups;
+        QList<Entry*> entries;
+    };
+
+    QByteArray deriveKey(const QByteArray& cacheKey, const char* purpose)
+    {
+        return CryptoHash::hmac(QByteArray(purpose), cacheKey, CryptoHash::Sha256);
+    }
+
+    // KDBX stores whole seconds, the cache must not be more precise than the file it stands for
+    QDateTime fileTime(const QDateTime& dateTime)
+    {
+        return dateTime.isValid() ? dateTime.addMSecs(-dateTime.time().msec()) : dateTime;
+    }
+
+    void writeTimeInfo(QDataStream& out, const TimeInfo& timeInfo)
+    {
+        out << fileTime(timeInfo.lastModificationTime()) << fileTime(timeInfo.creationTime())
+            << fileTime(timeInfo.lastAccessTime()) << fileTime(timeInfo.expiryTime()) << timeInfo.expires()
+            << static_cast<qint32>(timeInfo.usageCount()) << fileTime(timeInfo.locationChanged());
+    }
+
+    TimeInfo readTimeInfo(QDataStream& in)
+    {
+        QDateTime lastModificationTime, creationTime, lastAccessTime, expiryTime, locationChanged;
+        bool expires;
+        qint32 usageCount;
+        in >> lastModificationTime >> creationTime >> lastAccessTime >> expiryTime >> expires >> usageCount
+            >> locationChanged;
+
+        TimeInfo timeInfo;
+        timeInfo.setLastModificationTime(lastModificationTime);
+        timeInfo.setCreationTime(creationTime);
+        timeInfo.setLastAccessTime(lastAccessTime);
+        timeInfo.setExpiryTime(expiryTime);
+        timeInfo.setExpires(expires);
+        timeInfo.setUsageCount(usageCount);
+        timeInfo.setLocationChanged(locationChanged);
+        return timeInfo;
+    }
+
+    void writeCustomData(QDataStream& out, const CustomData* customData)
+    {
+        const auto keys = customData->keys();
+        out << static_cast<quint32>(keys.size());
+        for (const auto& key : keys) {
+            const auto& item = customData->item(key);
+            out << key << item.value << fileTime(item.lastModified);
+        }
+    }
+
+    // The custom data of entries is only created if there is any
+    template <class Owner> void readCustomData(QDataStream& in, Owner* owner)
+    {
+        quint32 count;
+        in >> count;
+        for (quint32 i = 0; i < count && in.status() == QDataStream::Ok; ++i) {
+            QString key;
+            CustomData::CustomDataItem item;
+            in >> key >> item.value >> item.lastModified;
+            owner->customData()->set(key, item);
+        }
+    }
+
+    /**
+     * Attachments are shared between entries and history items, they are stored once
+     * and referenced by their index.
+     */
+    class AttachmentPool
+    {
+    public:
+        int index(const QByteArray& data)
+        {
+            auto it = m_indexes.constFind(data.constData());
+            if (it != m_indexes.constEnd()) {
+                return it.value();
+            }
+            m_indexes.insert(data.constData(), m_data.size());
+            m_data.append(data);
+            return m_data.size() - 1;
+        }
+
+        void collect(const Entry* entry)
+        {
+            const auto attachments = entry->attachments();
+            for (const auto& key : attachments->keys()) {
+                index(attachments->value(key));
+            }
+        }
+
+        const QList<QByteArray>& data() const
+        {
+            return m_data;
+        }
+
+    private:
+        QHash<const char*, int> m_indexes;
+        QList<QByteArray> m_data;
+    };
+
+    void writeEntry(QDataStream& out, const Entry* entry, AttachmentPool& pool, bool withHistory)
+    {
+        out << entry->uuid() << static_cast<qint32>(entry->iconNumber()) << entry->iconUuid()
+            << entry->foregroundColor() << entry->backgroundColor() << entry->overrideUrl() << entry->tags();
+        writeTimeInfo(out, entry->timeInfo());
+        out << entry->excludeFromReports() << entry->autoTypeEnabled()
+            << static_cast<qint32>(entry->autoTypeObfuscation()) << entry->defaultAutoTypeSequence()
+            << entry->previousParentGroupUuid();
+
+        const auto attributes = entry->attributes();
+        const auto attributeKeys = attributes->keys();
+        out << static_cast<quint32>(attributeKeys.size());
+        for (const auto& key : attributeKeys) {
+            out << key << attributes->value(key) << attributes->isProtected(key);
+        }
+
+        const auto attachments = entry->attachments();
+        const auto attachmentKeys = attachments->keys();
+        out << static_cast<quint32>(attachmentKeys.size());
+        for (const auto& key : attachmentKeys) {
+            out << key << static_cast<quint32>(pool.index(attachments->value(key)));
+        }
+
+        const auto associations = entry->autoTypeAssociations()->getAll();
+        out << static_cast<quint32>(associations.size());
+        for (const auto& association : associations) {
+            out << association.window << association.sequence;
+        }
+
+        writeCustomData(out, entry->customData());
+
+        if (withHistory) {
+            const auto& history = entry->historyItems();
+            out << static_cast<quint32>(history.size());
+            for (const auto historyItem : history) {
+                writeEntry(out, historyItem, pool, false);
+            }
+        }
+    }
+
+    Entry* readEntry(QDataStream& in, const QList<QByteArray>& pool, MetadataRecord& record, bool withHistory)
+    {
+        auto entry = new Entry();
+        entry->setUpdateTimeinfo(false);
+        record.entries.append(entry);
+
+        QUuid uuid, customIcon, previousParentGroupUuid;
+        qint32 iconNumber, autoTypeObfuscation;
+        QString foregroundColor, backgroundColor, overrideUrl, tags, defaultAutoTypeSequence;
+        bool excludeFromReports, autoTypeEnabled;
+        in >> uuid >> iconNumber >> customIcon >> foregroundColor >> backgroundColor >> overrideUrl >> tags;
+        const auto timeInfo = readTimeInfo(in);
+        in >> excludeFromReports >> autoTypeEnabled >> autoTypeObfuscation >> defaultAutoTypeSequence
+            >> previousParentGroupUuid;
+
+        entry->setUuid(uuid);
+        if (!customIcon.isNull()) {
+            entry->setIcon(customIcon);
+        } else if (iconNumber >= 0) {
+            entry->setIcon(iconNumber);
+        }
+        entry->setForegroundColor(foregroundColor);
+        entry->setBackgroundColor(backgroundColor);
+        entry->setOverrideUrl(overrideUrl);
+        entry->setTags(tags);
+        entry->setTimeInfo(timeInfo);
+        entry->setExcludeFromReports(excludeFromReports);
+        entry->setAutoTypeEnabled(autoTypeEnabled);
+        entry->setAutoTypeObfuscation(autoTypeObfuscation);
+        entry->setDefaultAutoTypeSequence(defaultAutoTypeSequence);
+        entry->setPreviousParentGroupUuid(previousParentGroupUuid);
+
+        quint32 count;
+        in >> count;
+        for (quint32 i = 0; i < count && in.status() == QDataStream::Ok; ++i) {
+            QString key, value;
+            bool protect;
+            in >> key >> value >> protect;
+            entry->attributes()->set(key, value, protect);
+        }
+
+        in >> count;
+        for (quint32 i = 0; i < count && in.status() == QDataStream::Ok; ++i) {
+            QString key;
+            quint32 index;
+            in >> key >> index;
+            if (index >= static_cast<quint32>(pool.size())) {
+                in.setStatus(QDataStream::ReadCorruptData);
+                break;
+            }
+            entry->attachments()->set(key, pool.at(static_cast<int>(index)));
+        }
+
+        in >> count;
+        for (quint32 i = 0; i < count && in.status() == QDataStream::Ok; ++i) {
+            AutoTypeAssociations::Association association;
+            in >> association.window >> association.sequence;
+            entry->autoTypeAssociations()->add(association);
+        }
+
+        readCustomData(in, entry);
+
+        if (withHistory) {
+            in >> count;
+            for (quint32 i = 0; i < count && in.status() == QDataStream::Ok; ++i) {
+                entry->addHistoryItem(readEntry(in, pool, record, false));
+            }
+        }
+
+        return entry;
+    }
+
+    void writeGroup(QDataStream& out, const Group* group, AttachmentPool& pool)
+    {
+        const auto lastTopVisibleEntry = group->lastTopVisibleEntry();
+        out << group->uuid() << group->name() << group->notes() << group->tags()
+            << static_cast<qint32>(group->iconNumber()) << group->iconUuid();
+        writeTimeInfo(out, group->timeInfo());
+        out << group->isExpanded() << group->defaultAutoTypeSequence()
+            << static_cast<qint32>(group->autoTypeEnabled()) << static_cast<qint32>(group->searchingEnabled())
+            << (lastTopVisibleEntry ? lastTopVisibleEntry->uuid() : QUuid()) << group->previousParentGroupUuid();
+        writeCustomData(out, group->customData());
+
+        const auto& entries = group->entries();
+        out << static_cast<quint32>(entries.size());
+        for (const auto entry : entries) {
+            writeEntry(out, entry, pool, true);
+        }
+
+        const auto& children = group->children();
+        out << static_cast<quint32>(children.size());
+        for (const auto child : children) {
+            writeGroup(out, child, pool);
+        }
+    }
+
+    Group* readGroup(QDataStream& in, const QList<QByteArray>& pool, MetadataRecord& record)
+    {
+        auto group = new Group();
+        group->setUpdateTimeinfo(false);
+        record.groups.append(group);
+
+        QUuid uuid, customIcon, lastTopVisibleEntry, previousParentGroupUuid;
+        QString name, notes, tags, defaultAutoTypeSequence;
+        qint32 iconNumber, autoTypeEnabled, searchingEnabled;
+        bool isExpanded;
+        in >> uuid >> name >> notes >> tags >> iconNumber >> customIcon;
+        const auto timeInfo = readTimeInfo(in);
+        in >> isExpanded >> defaultAutoTypeSequence >> autoTypeEnabled >> searchingEnabled >> lastTopVisibleEntry
+            >> previousParentGroupUuid;
+
+        group->setUuid(uuid);
+        group->setName(name);
+        group->setNotes(notes);
+        group->setTags(tags);
+        if (!customIcon.isNull()) {
+            group->setIcon(customIcon);
+        } else {
+            group->setIcon(iconNumber);
+        }
+        group->setTimeInfo(timeInfo);
+        group->setExpanded(isExpanded);
+        group->setDefaultAutoTypeSequence(defaultAutoTypeSequence);
+        group->setAutoTypeEnabled(static_cast<Group::TriState>(autoTypeEnabled));
+        group->setSearchingEnabled(static_cast<Group::TriState>(searchingEnabled));
+        group->setPreviousParentGroupUuid(previousParentGroupUuid);
+        if (!lastTopVisibleEntry.isNull()) {
+            record.lastTopVisibleEntries.append({group, lastTopVisibleEntry});
+        }
+        readCustomData(in, group);
+
+        quint32 count;
+        in >> count;
+        for (quint32 i = 0; i < count && in.status() == QDataStream::Ok; ++i) {
+            readEntry(in, pool, record, true)->setGroup(group, false);
+        }
+
+        in >> count;
+        for (quint32 i = 0; i < count && in.status() == QDataStream::Ok; ++i) {
+            readGroup(in, pool, record)->setParent(group, -1, false);
+        }
+
+        return group;
+    }
+
+    void writeMetadata(QDataStream& out, const Metadata* meta)
+    {
+        auto groupUuid = [](const Group* group) { return group ? group->uuid() : QUuid(); };
+
+        out << meta->generator() << meta->name() << fileTime(meta->nameChanged()) << meta->description()
+            << fileTime(meta->descriptionChanged()) << meta->defaultUserName()
+            << fileTime(meta->defaultUserNameChanged()) << static_cast<qint32>(meta->maintenanceHistoryDays())
+            << meta->color() << fileTime(meta->databaseKeyChanged())
+            << static_cast<qint32>(meta->databaseKeyChangeRec()) << static_cast<qint32>(meta->databaseKeyChangeForce())
+            << meta->protectTitle() << meta->protectUsername() << meta->protectPassword() << meta->protectUrl()
+            << meta->protectNotes() << meta->recycleBinEnabled() << groupUuid(meta->recycleBin())
+            << fileTime(meta->recycleBinChanged()) << groupUuid(meta->entryTemplatesGroup())
+            << fileTime(meta->entryTemplatesGroupChanged()) << groupUuid(meta->lastSelectedGroup())
+            << groupUuid(meta->lastTopVisibleGroup()) << static_cast<qint32>(meta->historyMaxItems())
+            << static_cast<qint32>(meta->historyMaxSize()) << fileTime(meta->settingsChanged());
+
+        const auto icons = meta->customIconsOrder();
+        out << static_cast<quint32>(icons.size());
+        for (const auto& uuid : icons) {
+            const auto& icon = meta->customIcon(uuid);
+            out << uuid << icon.data << icon.name << fileTime(icon.lastModified);
+        }
+
+        writeCustomData(out, meta->customData());
+    }
+
+    void readMetadata(QDataStream& in, Metadata* meta, MetadataRecord& record)
+    {
+        QString generator, name, description, defaultUserName, color;
+        QDateTime nameChanged, descriptionChanged, defaultUserNameChanged, databaseKeyChanged, recycleBinChanged,
+            entryTemplatesGroupChanged, settingsChanged;
+        qint32 maintenanceHistoryDays, databaseKeyChangeRec, databaseKeyChangeForce, historyMaxItems, historyMaxSize;
+        bool protectTitle, protectUsername, protectPassword, protectUrl, protectNotes, recycleBinEnabled;
+
+        in >> generator >> name >> nameChanged >> description >> descriptionChanged >> defaultUserName
+            >> defaultUserNameChanged >> maintenanceHistoryDays >> color >> databaseKeyChanged >> databaseKeyChangeRec
+            >> databaseKeyChangeForce >> protectTitle >> protectUsername >> protectPassword >> protectUrl
+            >> protectNotes >> recycleBinEnabled >> record.recycleBin >> recycleBinChanged
+            >> record.entryTemplatesGroup >> entryTemplatesGroupChanged >> record.lastSelectedGroup
+            >> record.lastTopVisibleGroup >> historyMaxItems >> historyMaxSize >> settingsChanged;
+
+        meta->setUpdateDatetime(false);
+        meta->setGenerator(generator);
+        meta->setName(name);
+        meta->setNameChanged(nameChanged);
+        meta->setDescription(description);
+        meta->setDescriptionChanged(descriptionChanged);
+        meta->setDefaultUserName(defaultUserName);
+        meta->setDefaultUserNameChanged(defaultUserNameChanged);
+        meta->setMaintenanceHistoryDays(maintenanceHistoryDays);
+        meta->setColor(color);
+        meta->setDatabaseKeyChanged(databaseKeyChanged);
+        meta->setMasterKeyChangeRec(databaseKeyChangeRec);
+        meta->setMasterKeyChangeForce(databaseKeyChangeForce);
+        meta->setProtectTitle(protectTitle);
+        meta->setProtectUsername(protectUsername);
+        meta->setProtectPassword(protectPassword);
+        meta->setProtectUrl(protectUrl);
+        meta->setProtectNotes(protectNotes);
+        meta->setRecycleBinEnabled(recycleBinEnabled);
+        meta->setRecycleBinChanged(recycleBinChanged);
+        meta->setEntryTemplatesGroupChanged(entryTemplatesGroupChanged);
+        meta->setHistoryMaxItems(historyMaxItems);
+        meta->setHistoryMaxSize(historyMaxSize);
+        meta->setSettingsChanged(settingsChanged);
+
+        quint32 count;
+        in >> count;
+        for (quint32 i = 0; i < count && in.status() == QDataStream::Ok; ++i) {
+            QUuid uuid;
+            Metadata::CustomIconData icon;
+            in >> uuid >> icon.data >> icon.name >> icon.lastModified;
+            meta->addCustomIcon(uuid, icon);
+        }
+
+        readCustomData(in, meta);
+    }
+} // namespace
+
+/**
+ * @param databaseFilePath path of the database file the cache belongs to
+ */
+DatabaseOpenCache::DatabaseOpenCache(const QString& databaseFilePath)
+{
+    const auto dir = directory();
+    if (!dir.isEmpty()) {
+        // One cache per file, named after its path so the name does not reveal it
+        const QFileInfo info(databaseFilePath);
+        const auto path = info.exists() ? info.canonicalFilePath() : info.absoluteFilePath();
+        m_fileName = QDir(dir).filePath(CryptoHash::hash(path.toUtf8(), CryptoHash::Sha256).toHex());
+    }
+}
+
+/**
+ * Read the database from the cache.
+ *
+ * Only the headers are read from the device. If the cache matches the content hash,
+ * the key is transformed and the content of the database is restored from the cache.
+ * The groups and entries of db are only replaced if the cache is loaded.
+ *
+ * @param device database file
+ * @param contentHash SHA-256 hash of the database file
+ * @param key database encryption composite key
+ * @param db database to read into
+ * @return Loaded on success, Unavailable if the file has to be read instead
+ */
+DatabaseOpenCache::Status DatabaseOpenCache::read(QIODevice* device,
+                                                  const QByteArray& contentHash,
+                                                  QSharedPointer<const CompositeKey> key,
+                                                  Database* db)
+{
+    m_error.clear();
+    m_timings.clear();
+
+    if (m_fileName.isEmpty() || !key) {
+        return Status::Unavailable;
+    }
+
+    QElapsedTimer timer;
+    timer.start();
+
+    QFile file(m_fileName);
+    if (!file.open(QIODevice::ReadOnly)) {
+        return Status::Unavailable;
+    }
+
+    QDataStream stream(&file);
+    stream.setVersion(QDataStream::Qt_5_0);
+
+    quint32 signature, version;
+    QString appVersion;
+    QByteArray cachedContentHash, keyCheck;
+    stream >> signature >> version >> appVersion >> cachedContentHash >> keyCheck;
+    if (stream.status() != QDataStream::Ok || signature != CACHE_SIGNATURE || version != CACHE_VERSION
+        || appVersion != KEEPASSXC_VERSION || cachedContentHash != contentHash) {
+        return Status::Unavailable;
+    }
+    m_timings.add(PhaseTimings::Read, timer.nsecsElapsed());
+
+    // The header tells how to transform the key, the payload is left alone
+    KeePass2Reader headerReader;
+    if (!headerReader.readDatabase(device, {}, db) || db->formatVersion() < KeePass2::FILE_VERSION_4) {
+        return Status::Unavailable;
+    }
+    const auto headerTimings = headerReader.timings();
+    for (const auto& phase : headerTimings.phases()) {
+        m_timings.add(phase.name, phase.nsecs);
+    }
+
+    emit db->openPhaseStarted(PhaseTimings::Kdf);
+    timer.restart();
+    bool ok = db->setKey(key, false, false);
+    m_timings.add(PhaseTimings::Kdf, timer.nsecsElapsed());
+    if (!ok) {
+        m_error = tr("Unable to calculate database key: %1").arg(db->keyError());
+        return Status::Failed;
+    }
+
+    const auto cacheKey = CryptoHash::hmac(contentHash, db->transformedDatabaseKey(), CryptoHash::Sha256);
+    if (keyCheck != deriveKey(cacheKey, "check")) {
+        m_error = tr("Invalid credentials were provided, please try again.\n"
+                     "If this reoccurs, then your database file may be corrupt.");
+        return Status::Failed;
+    }
+
+    timer.restart();
+    QByteArray iv, data;
+    stream >> iv >> data;
+    file.close();
+    m_timings.add(PhaseTimings::Read, timer.nsecsElapsed());
+    if (stream.status() != QDataStream::Ok) {
+        return Status::Unavailable;
+    }
+
+    timer.restart();
+    SymmetricCipher cipher;
+    if (!cipher.init(SymmetricCipher::Aes256_GCM, SymmetricCipher::Decrypt, deriveKey(cacheKey, "encrypt"), iv)
+        || !cipher.finish(data)) {
+        return Status::Unavailable;
+    }
+    m_timings.add(PhaseTimings::Decrypt, timer.nsecsElapsed());
+
+    emit db->openPhaseStarted(PhaseTimings::Model);
+    timer.restart();
+
+    QDataStream in(data);
+    in.setVersion(QDataStream::Qt_5_0);
+
+    QList<QByteArray> pool;
+    in >> pool;
+
+    // Build the tree apart from the database and only use it if the whole cache could be read
+    Metadata meta;
+    MetadataRecord record;
+    readMetadata(in, &meta, record);
+    QScopedPointer<Group> root(readGroup(in, pool, record));
+    QList<DeletedObject> deletedObjects;
+    quint32 count;
+    in >> count;
+    for (quint32 i = 0; i < count && in.status() == QDataStream::Ok; ++i) {
+        DeletedObject deletedObject;
+        in >> deletedObject.uuid >> deletedObject.deletionTime;
+        deletedObjects.append(deletedObject);
+    }
+    if (in.status() != QDataStream::Ok || !in.atEnd()) {
+        return Status::Unavailable;
+    }
+
+    for (const auto& lastTopVisible : asConst(record.lastTopVisibleEntries)) {
+        lastTopVisible.first->setLastTopVisibleEntry(root->findEntryByUuid(lastTopVisible.second));
+    }
+
+    auto groupByUuid = [&root](const QUuid& uuid) { return uuid.isNull() ? nullptr : root->findGroupByUuid(uuid); };
+
+    auto dbMeta = db->metadata();
+    dbMeta->setUpdateDatetime(false);
+    dbMeta->copyAttributesFrom(&meta);
+    dbMeta->setDatabaseKeyChanged(meta.databaseKeyChanged());
+    dbMeta->setSettingsChanged(meta.settingsChanged());
+    for (const auto& uuid : meta.customIconsOrder()) {
+        dbMeta->addCustomIcon(uuid, meta.customIcon(uuid));
+    }
+    dbMeta->customData()->copyDataFrom(meta.customData());
+    dbMeta->setRecycleBin(groupByUuid(record.recycleBin));
+    dbMeta->setRecycleBinChanged(meta.recycleBinChanged());
+    dbMeta->setEntryTemplatesGroup(groupByUuid(record.entryTemplatesGroup));
+    dbMeta->setEntryTemplatesGroupChanged(meta.entryTemplatesGroupChanged());
+    dbMeta->setLastSelectedGroup(groupByUuid(record.lastSelectedGroup));
+    dbMeta->setLastTopVisibleGroup(groupByUuid(record.lastTopVisibleGroup));
+
+    delete db->setRootGroup(root.take());
+    db->setDeletedObjects(deletedObjects);
+
+    dbMeta->setUpdateDatetime(true);
+    for (auto group : asConst(record.groups)) {
+        group->setUpdateTimeinfo(true);
+    }
+    for (auto entry : asConst(record.entries)) {
+        entry->setUpdateTimeinfo(true);
+    }
+
+    m_timings.add(PhaseTimings::Model, timer.nsecsElapsed());
+    return Status::Loaded;
+}
+
+/**
+ * Store the content of the database, which must be the content of the file with the given hash.
+ *
+ * @param contentHash SHA-256 hash of the database file
+ * @param db database to store
+ * @return true on success
+ */
+bool DatabaseOpenCache::write(const QByteArray& contentHash, const Database* db)
+{
+    m_error.clear();
+
+    const auto transformedKey = db->transformedDatabaseKey();
+    if (m_fileName.isEmpty() || transformedKey.isEmpty() || db->formatVersion() < KeePass2::FILE_VERSION_4) {
+        remove();
+        return false;
+    }
+
+    QByteArray content;
+    {
+        QByteArray model;
+        QDataStream out(&model, QIODevice::WriteOnly);
+        out.setVersion(QDataStream::Qt_5_0);
+
+        AttachmentPool pool;
+        for (const auto entry : db->rootGroup()->entriesRecursive(true)) {
+            pool.collect(entry);
+        }
+
+        writeMetadata(out, db->metadata());
+        writeGroup(out, db->rootGroup(), pool);
+        const auto& deletedObjects = db->deletedObjects();
+        out << static_cast<quint32>(deletedObjects.size());
+        for (const auto& deletedObject : deletedObjects) {
+            out << deletedObject.uuid << fileTime(deletedObject.deletionTime);
+        }
+
+        // The attachments are needed first when reading
+        QDataStream contentStream(&content, QIODevice::WriteOnly);
+        contentStream.setVersion(QDataStream::Qt_5_0);
+        contentStream << pool.data();
+        content.append(model);
+    }
+
+    const auto cacheKey = CryptoHash::hmac(contentHash, transformedKey, CryptoHash::Sha256);
+    const auto iv = randomGen()->randomArray(SymmetricCipher::defaultIvSize(SymmetricCipher::Aes256_GCM));
+    SymmetricCipher cipher;
+    if (!cipher.init(SymmetricCipher::Aes256_GCM, SymmetricCipher::Encrypt, deriveKey(cacheKey, "encrypt"), iv)
+        || !cipher.finish(content)) {
+        m_error = cipher.errorString();
+        return false;
+    }
+
+    if (!QDir().mkpath(QFileInfo(m_fileName).absolutePath())) {
+        m_error = tr("Unable to create the cache directory.");
+        return false;
+    }
+
+    QSaveFile file(m_fileName);
+    if (!file.open(QIODevice::WriteOnly)) {
+        m_error = file.errorString();
+        return false;
+    }
+    file.setPermissions(QFile::ReadOwner | QFile::WriteOwner);
+
+    QDataStream stream(&file);
+    stream.setVersion(QDataStream::Qt_5_0);
+    stream << CACHE_SIGNATURE << CACHE_VERSION << QString(KEEPASSXC_VERSION) << contentHash
+           << deriveKey(cacheKey, "check") << iv << content;
+    if (stream.status() != QDataStream::Ok || !file.commit()) {
+        m_error = file.errorString();
+        return false;
+    }
+
+    return true;
+}
+
+/**
+ * Remove the cache of the database, if any.
+ */
+void DatabaseOpenCache::remove()
+{
+    if (!m_fileName.isEmpty()) {
+        QFile::remove(m_fileName);
+    }
+}
+
+QString DatabaseOpenCache::fileName() const
+{
+    return m_fileName;
+}
+
+QString DatabaseOpenCache::errorString() const
+{
+    return m_error;
+}
+
+/**
+ * @return time spent in the phases of the last read
+ */
+const PhaseTimings& DatabaseOpenCache::timings() const
+{
+    return m_timings;
+}
+
+/**
+ * Remove the caches of all databases.
+ */
+void DatabaseOpenCache::removeAll()
+{
+    const auto dir = directory();
+    if (!dir.isEmpty()) {
+        QDir(dir).removeRecursively();
+    }
+}
+
+QString DatabaseOpenCache::directory()
+{
+    const auto cacheLocation = QStandardPaths::writableLocation(QStandardPaths::CacheLocation);
+    if (cacheLocation.isEmpty()) {
+        return {};
+    }
+    return cacheLocation + "/open";
+}
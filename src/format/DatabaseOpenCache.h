@@ -0,0 +1,71 @@
+/*
+ *  Copyright (C) 2024 KeePassXC Team <team@keepassxc.org>
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 2 or (at your option)
+ *  version 3 of the License.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef KEEPASSXC_DATABASEOPENCACHE_H
+#define KEEPASSXC_DATABASEOPENCACHE_H
+
+#include "core/PhaseTimings.h"
+
+#include <QCoreApplication>
+#include <QSharedPointer>
+
+class CompositeKey;
+class Database;
+class QIODevice;
+
+/**
+ * Local cache of the decrypted content of a KDBX 4 file in a compact binary form.
+ *
+ * Reading the cache replaces decrypting, decompressing and parsing the XML payload
+ * of the file, the key is still transformed as usual. The cache is encrypted with
+ * AES-256-GCM under a key derived from the transformed database key and the hash of
+ * the file content, so it is as hard to attack as the database file itself and it
+ * is only used while the file is unchanged.
+ */
+class DatabaseOpenCache
+{
+    Q_DECLARE_TR_FUNCTIONS(DatabaseOpenCache)
+
+public:
+    enum class Status
+    {
+        Loaded,
+        Unavailable, // No usable cache, the database has to be read from the file
+        Failed // The key is wrong or could not be transformed, see errorString()
+    };
+
+    explicit DatabaseOpenCache(const QString& databaseFilePath);
+
+    Status read(QIODevice* device, const QByteArray& contentHash, QSharedPointer<const CompositeKey> key, Database* db);
+    bool write(const QByteArray& contentHash, const Database* db);
+    void remove();
+
+    QString fileName() const;
+    QString errorString() const;
+    const PhaseTimings& timings() const;
+
+    static void removeAll();
+
+private:
+    static QString directory();
+
+    QString m_fileName;
+    QString m_error;
+    PhaseTimings m_timings;
+};
+
+#endif // KEEPASSXC_DATABASEOPENCACHE_H
@@ -18,6 +18,8 @@
 
 #include "Kdbx3Reader.h"
 
+#include <QElapsedTimer>
+
 #include "core/AsyncTask.h"
 #include "core/Endian.h"
 #include "core/Group.h"
@@ -47,7 +49,11 @@ bool Kdbx3Reader::readDatabaseImpl(QIODevice* device,
         return false;
     }
 
+    startPhase(PhaseTimings::Kdf);
+    QElapsedTimer timer;
+    timer.start();
     bool ok = AsyncTask::runAndWaitForFuture([&] { return db->setKey(key, false); });
+    m_timings.add(PhaseTimings::Kdf, timer.nsecsElapsed());
     if (!ok) {
         raiseError(tr("Unable to calculate database key"));
         return false;
@@ -112,9 +118,17 @@ bool Kdbx3Reader::readDatabaseImpl(QIODevice* device,
 
     Q_ASSERT(xmlDevice);
 
+    // KDBX 3 databases are not broken down further, reading, decrypting
+    // and decompressing the payload is accounted to the XML phase
+    startPhase(PhaseTimings::Xml);
+    timer.restart();
+
     KdbxXmlReader xmlReader(KeePass2::FILE_VERSION_3_1);
     xmlReader.readDatabase(xmlDevice, db, &randomStream);
 
+    m_timings.add(PhaseTimings::Xml, timer.nsecsElapsed() - xmlReader.modelTime());
+    m_timings.add(PhaseTimings::Model, xmlReader.modelTime());
+
     if (xmlReader.hasError()) {
         raiseError(xmlReader.errorString());
         return false;
@@ -19,6 +19,7 @@
 #include "Kdbx3Writer.h"
 
 #include <QBuffer>
+#include <QElapsedTimer>
 
 #include "crypto/CryptoHash.h"
 #include "crypto/Random.h"
@@ -32,6 +33,7 @@ bool Kdbx3Writer::writeDatabase(QIODevice* device, Database* db)
 {
     m_error = false;
     m_errorStr.clear();
+    m_timings.clear();
 
     auto mode = SymmetricCipher::cipherUuidToMode(db->cipher());
     int ivSize = SymmetricCipher::defaultIvSize(mode);
@@ -51,7 +53,12 @@ bool Kdbx3Writer::writeDatabase(QIODevice* device, Database* db)
         return false;
     }
 
-    if (!db->setKey(db->key(), false, true)) {
+    startPhase(db, PhaseTimings::Kdf);
+    QElapsedTimer timer;
+    timer.start();
+    bool ok = db->setKey(db->key(), false, true);
+    m_timings.add(PhaseTimings::Kdf, timer.nsecsElapsed());
+    if (!ok) {
         raiseError(tr("Unable to calculate database key"));
         return false;
     }
@@ -137,6 +144,11 @@ bool Kdbx3Writer::writeDatabase(QIODevice* device, Database* db)
         return false;
     }
 
+    // KDBX 3 databases are not broken down further, compressing, encrypting
+    // and writing the payload is accounted to the XML phase
+    startPhase(db, PhaseTimings::Xml);
+    timer.restart();
+
     KdbxXmlWriter xmlWriter(db->formatVersion());
     xmlWriter.writeDatabase(outputDevice, db, &randomStream, headerHash);
 
@@ -153,6 +165,7 @@ bool Kdbx3Writer::writeDatabase(QIODevice* device, Database* db)
         raiseError(cipherStream.errorString());
         return false;
     }
+    m_timings.add(PhaseTimings::Xml, timer.nsecsElapsed());
 
     if (xmlWriter.hasError()) {
         raiseError(xmlWriter.errorString());
@@ -18,6 +18,7 @@
 #include "Kdbx4Reader.h"
 
 #include <QBuffer>
+#include <QElapsedTimer>
 #include <QJsonObject>
 
 #include "core/AsyncTask.h"
@@ -29,6 +30,7 @@
 #include "streams/HmacBlockStream.h"
 #include "streams/StoreDataStream.h"
 #include "streams/SymmetricCipherStream.h"
+#include "streams/TimedStream.h"
 #include "streams/qtiocompressor.h"
 
 bool Kdbx4Reader::readDatabaseImpl(QIODevice* device,
@@ -50,7 +52,11 @@ bool Kdbx4Reader::readDatabaseImpl(QIODevice* device,
         return false;
     }
 
+    startPhase(PhaseTimings::Kdf);
+    QElapsedTimer timer;
+    timer.start();
     bool ok = AsyncTask::runAndWaitForFuture([&] { return db->setKey(key, false, false); });
+    m_timings.add(PhaseTimings::Kdf, timer.nsecsElapsed());
     if (!ok) {
         raiseError(tr("Unable to calculate database key: %1").arg(db->keyError()));
         return false;
@@ -84,13 +90,15 @@ bool Kdbx4Reader::readDatabaseImpl(QIODevice* device,
         raiseError(hmacStream.errorString());
         return false;
     }
+    TimedStream timedHmacStream(&hmacStream);
+    timedHmacStream.open(QIODevice::ReadOnly);
 
     auto mode = SymmetricCipher::cipherUuidToMode(db->cipher());
     if (mode == SymmetricCipher::InvalidMode) {
         raiseError(tr("Unknown cipher"));
         return false;
     }
-    SymmetricCipherStream cipherStream(&hmacStream);
+    SymmetricCipherStream cipherStream(&timedHmacStream);
     if (!cipherStream.init(mode, SymmetricCipher::Decrypt, finalKey, m_encryptionIV)) {
         raiseError(cipherStream.errorString());
         return false;
@@ -100,24 +108,34 @@ bool Kdbx4Reader::readDatabaseImpl(QIODevice* device,
         return false;
     }
     // clang-format on
+    TimedStream timedCipherStream(&cipherStream);
+    timedCipherStream.open(QIODevice::ReadOnly);
 
-    QIODevice* xmlDevice = nullptr;
+    TimedStream* xmlDevice = nullptr;
     QScopedPointer<QtIOCompressor> ioCompressor;
+    QScopedPointer<TimedStream> timedCompressor;
 
     if (db->compressionAlgorithm() == Database::CompressionNone) {
-        xmlDevice = &cipherStream;
+        xmlDevice = &timedCipherStream;
     } else {
-        ioCompressor.reset(new QtIOCompressor(&cipherStream));
+        ioCompressor.reset(new QtIOCompressor(&timedCipherStream));
         ioCompressor->setStreamFormat(QtIOCompressor::GzipFormat);
         if (!ioCompressor->open(QIODevice::ReadOnly)) {
             raiseError(ioCompressor->errorString());
             return false;
         }
-        xmlDevice = ioCompressor.data();
+        timedCompressor.reset(new TimedStream(ioCompressor.data()));
+        timedCompressor->open(QIODevice::ReadOnly);
+        xmlDevice = timedCompressor.data();
     }
 
+    // The layers are read on demand, so the time spent in each layer is taken from the
+    // stream below it and only the remainder is attributed to the phase doing the reads
+    startPhase(PhaseTimings::Binaries);
+    timer.restart();
     while (readInnerHeaderField(xmlDevice) && !hasError()) {
     }
+    m_timings.add(PhaseTimings::Binaries, timer.nsecsElapsed() - xmlDevice->elapsed());
 
     if (hasError()) {
         return false;
@@ -143,9 +161,20 @@ bool Kdbx4Reader::readDatabaseImpl(QIODevice* device,
 
     Q_ASSERT(xmlDevice);
 
+    startPhase(PhaseTimings::Xml);
+    const qint64 binariesStreamTime = xmlDevice->elapsed();
+    timer.restart();
+
     KdbxXmlReader xmlReader(KeePass2::FILE_VERSION_4, binaryPool());
     xmlReader.readDatabase(xmlDevice, db, &randomStream);
 
+    m_timings.add(PhaseTimings::Xml,
+                  timer.nsecsElapsed() - (xmlDevice->elapsed() - binariesStreamTime) - xmlReader.modelTime());
+    m_timings.add(PhaseTimings::Model, xmlReader.modelTime());
+    m_timings.add(PhaseTimings::Read, timedHmacStream.elapsed());
+    m_timings.add(PhaseTimings::Decrypt, timedCipherStream.elapsed() - timedHmacStream.elapsed());
+    m_timings.add(PhaseTimings::Decompress, xmlDevice->elapsed() - timedCipherStream.elapsed());
+
     if (xmlReader.hasError()) {
         raiseError(xmlReader.errorString());
         return false;
@@ -18,6 +18,7 @@
 #include "Kdbx4Writer.h"
 
 #include <QBuffer>
+#include <QElapsedTimer>
 
 #include "config-keepassx.h"
 #include "crypto/CryptoHash.h"
@@ -29,12 +30,14 @@
 #endif
 #include "streams/HmacBlockStream.h"
 #include "streams/SymmetricCipherStream.h"
+#include "streams/TimedStream.h"
 #include "streams/qtiocompressor.h"
 
 bool Kdbx4Writer::writeDatabase(QIODevice* device, Database* db)
 {
     m_error = false;
     m_errorStr.clear();
+    m_timings.clear();
 
     auto mode = SymmetricCipher::cipherUuidToMode(db->cipher());
     if (mode == SymmetricCipher::InvalidMode) {
@@ -52,11 +55,19 @@ bool Kdbx4Writer::writeDatabase(QIODevice* device, Database* db)
     QByteArray protectedStreamKey = randomGen()->randomArray(64);
     QByteArray endOfHeader = "\r\n\r\n";
 
-    if (!db->setKey(db->key(), false, true)) {
+    startPhase(db, PhaseTimings::Kdf);
+    QElapsedTimer timer;
+    timer.start();
+    bool ok = db->setKey(db->key(), false, true);
+    m_timings.add(PhaseTimings::Kdf, timer.nsecsElapsed());
+    if (!ok) {
         raiseError(tr("Unable to calculate database key: %1").arg(db->keyError()));
         return false;
     }
 
+    startPhase(db, PhaseTimings::Header);
+    timer.restart();
+
     // generate transformed database key
     CryptoHash hash(CryptoHash::Sha256);
     hash.addData(masterSeed);
@@ -114,17 +125,24 @@ bool Kdbx4Writer::writeDatabase(QIODevice* device, Database* db)
         CryptoHash::hmac(headerData, HmacBlockStream::getHmacKey(UINT64_MAX, hmacKey), CryptoHash::Sha256);
     CHECK_RETURN_FALSE(writeData(device, headerHash));
     CHECK_RETURN_FALSE(writeData(device, headerHmac));
+    m_timings.add(PhaseTimings::Header, timer.nsecsElapsed());
 
+    // Each layer is wrapped in a TimedStream, the time spent in a layer is what remains
+    // after subtracting the time spent in the layer below it
     QScopedPointer<HmacBlockStream> hmacBlockStream;
+    QScopedPointer<TimedStream> timedHmacStream;
     QScopedPointer<SymmetricCipherStream> cipherStream;
+    QScopedPointer<TimedStream> timedCipherStream;
 
     hmacBlockStream.reset(new HmacBlockStream(device, hmacKey));
     if (!hmacBlockStream->open(QIODevice::WriteOnly)) {
         raiseError(hmacBlockStream->errorString());
         return false;
     }
+    timedHmacStream.reset(new TimedStream(hmacBlockStream.data()));
+    timedHmacStream->open(QIODevice::WriteOnly);
 
-    cipherStream.reset(new SymmetricCipherStream(hmacBlockStream.data()));
+    cipherStream.reset(new SymmetricCipherStream(timedHmacStream.data()));
 
     if (!cipherStream->init(mode, SymmetricCipher::Encrypt, finalKey, encryptionIV)) {
         raiseError(cipherStream->errorString());
@@ -134,24 +152,32 @@ bool Kdbx4Writer::writeDatabase(QIODevice* device, Database* db)
         raiseError(cipherStream->errorString());
         return false;
     }
+    timedCipherStream.reset(new TimedStream(cipherStream.data()));
+    timedCipherStream->open(QIODevice::WriteOnly);
 
-    QIODevice* outputDevice = nullptr;
+    TimedStream* outputDevice = nullptr;
     QScopedPointer<QtIOCompressor> ioCompressor;
+    QScopedPointer<TimedStream> timedCompressor;
 
     if (db->compressionAlgorithm() == Database::CompressionNone) {
-        outputDevice = cipherStream.data();
+        outputDevice = timedCipherStream.data();
     } else {
-        ioCompressor.reset(new QtIOCompressor(cipherStream.data()));
+        ioCompressor.reset(new QtIOCompressor(timedCipherStream.data()));
         ioCompressor->setStreamFormat(QtIOCompressor::GzipFormat);
         if (!ioCompressor->open(QIODevice::WriteOnly)) {
             raiseError(ioCompressor->errorString());
             return false;
         }
-        outputDevice = ioCompressor.data();
+        timedCompressor.reset(new TimedStream(ioCompressor.data()));
+        timedCompressor->open(QIODevice::WriteOnly);
+        outputDevice = timedCompressor.data();
     }
 
     Q_ASSERT(outputDevice);
 
+    startPhase(db, PhaseTimings::Binaries);
+    timer.restart();
+
     CHECK_RETURN_FALSE(writeInnerHeaderField(
         outputDevice,
         KeePass2::InnerHeaderFieldID::InnerRandomStreamID,
@@ -163,6 +189,7 @@ bool Kdbx4Writer::writeDatabase(QIODevice* device, Database* db)
     auto idxMap = writeAttachments(outputDevice, db);
 
     CHECK_RETURN_FALSE(writeInnerHeaderField(outputDevice, KeePass2::InnerHeaderFieldID::End, QByteArray()));
+    m_timings.add(PhaseTimings::Binaries, timer.nsecsElapsed() - outputDevice->elapsed());
 
     KeePass2RandomStream randomStream;
     if (!randomStream.init(SymmetricCipher::ChaCha20, protectedStreamKey)) {
@@ -170,23 +197,41 @@ bool Kdbx4Writer::writeDatabase(QIODevice* device, Database* db)
         return false;
     }
 
+    startPhase(db, PhaseTimings::Xml);
+    const qint64 binariesStreamTime = outputDevice->elapsed();
+    timer.restart();
+
     KdbxXmlWriter xmlWriter(db->formatVersion(), idxMap);
     xmlWriter.writeDatabase(outputDevice, db, &randomStream, headerHash);
 
+    m_timings.add(PhaseTimings::Xml, timer.nsecsElapsed() - (outputDevice->elapsed() - binariesStreamTime));
+
     // Explicitly close/reset streams so they are flushed and we can detect
     // errors. QIODevice::close() resets errorString() etc.
     if (ioCompressor) {
+        timer.restart();
         ioCompressor->close();
+        timedCompressor->addElapsed(timer.nsecsElapsed());
     }
-    if (!cipherStream->reset()) {
+    timer.restart();
+    ok = cipherStream->reset();
+    timedCipherStream->addElapsed(timer.nsecsElapsed());
+    if (!ok) {
         raiseError(cipherStream->errorString());
         return false;
     }
-    if (!hmacBlockStream->reset()) {
+    timer.restart();
+    ok = hmacBlockStream->reset();
+    timedHmacStream->addElapsed(timer.nsecsElapsed());
+    if (!ok) {
         raiseError(hmacBlockStream->errorString());
         return false;
     }
 
+    m_timings.add(PhaseTimings::Compress, outputDevice->elapsed() - timedCipherStream->elapsed());
+    m_timings.add(PhaseTimings::Encrypt, timedCipherStream->elapsed() - timedHmacStream->elapsed());
+    m_timings.add(PhaseTimings::Write, timedHmacStream->elapsed());
+
     if (xmlWriter.hasError()) {
         raiseError(xmlWriter.errorString());
         return false;
@@ -22,6 +22,8 @@
 #include "crypto/SymmetricCipher.h"
 #include "streams/StoreDataStream.h"
 
+#include <QElapsedTimer>
+
 #define UUID_LENGTH 16
 
 /**
@@ -73,6 +75,11 @@ bool KdbxReader::readDatabase(QIODevice* device, QSharedPointer<const CompositeK
     m_encryptionIV.clear();
     m_streamStartBytes.clear();
     m_protectedStreamKey.clear();
+    m_timings.clear();
+
+    startPhase(PhaseTimings::Header);
+    QElapsedTimer headerTimer;
+    headerTimer.start();
 
     StoreDataStream headerStream(device);
     headerStream.open(QIODevice::ReadOnly);
@@ -90,6 +97,7 @@ bool KdbxReader::readDatabase(QIODevice* device, QSharedPointer<const CompositeK
     }
 
     headerStream.close();
+    m_timings.add(PhaseTimings::Header, headerTimer.nsecsElapsed());
 
     if (hasError()) {
         return false;
@@ -119,6 +127,14 @@ KeePass2::ProtectedStreamAlgo KdbxReader::protectedStreamAlgo() const
     return m_irsAlgo;
 }
 
+/**
+ * @return time spent in the phases of the last read
+ */
+const PhaseTimings& KdbxReader::timings() const
+{
+    return m_timings;
+}
+
 /**
  * @param data stream cipher UUID as bytes
  */
@@ -262,3 +278,15 @@ void KdbxReader::raiseError(const QString& errorMessage)
     m_error = true;
     m_errorStr = errorMessage;
 }
+
+/**
+ * Announce the start of a phase to listeners of the database being read.
+ *
+ * @param phase name of the phase
+ */
+void KdbxReader::startPhase(const QString& phase)
+{
+    if (m_db) {
+        emit m_db->openPhaseStarted(phase);
+    }
+}
@@ -19,6 +19,7 @@
 #define KEEPASSXC_KDBXREADER_H
 
 #include "KeePass2.h"
+#include "core/PhaseTimings.h"
 
 #include <QCoreApplication>
 #include <QPointer>
@@ -46,6 +47,7 @@ public:
     QString errorString() const;
 
     KeePass2::ProtectedStreamAlgo protectedStreamAlgo() const;
+    const PhaseTimings& timings() const;
 
 protected:
     /**
@@ -82,12 +84,14 @@ protected:
     virtual void setInnerRandomStreamID(const QByteArray& data);
 
     void raiseError(const QString& errorMessage);
+    void startPhase(const QString& phase);
 
     QByteArray m_masterSeed;
     QByteArray m_encryptionIV;
     QByteArray m_streamStartBytes;
     QByteArray m_protectedStreamKey;
     KeePass2::ProtectedStreamAlgo m_irsAlgo = KeePass2::ProtectedStreamAlgo::InvalidProtectedStreamAlgo;
+    PhaseTimings m_timings;
 
 private:
     QPair<quint32, quint32> m_kdbxSignature;
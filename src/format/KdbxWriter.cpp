@@ -19,6 +19,7 @@
 
 #include <QBuffer>
 
+#include "core/Database.h"
 #include "format/KdbxXmlWriter.h"
 
 bool KdbxWriter::hasError() const
@@ -31,6 +32,14 @@ QString KdbxWriter::errorString() const
     return m_errorStr;
 }
 
+/**
+ * @return time spent in the phases of the last write
+ */
+const PhaseTimings& KdbxWriter::timings() const
+{
+    return m_timings;
+}
+
 /**
  * Write KDBX magic header numbers to a device.
  *
@@ -86,3 +95,14 @@ void KdbxWriter::raiseError(const QString& errorMessage)
     m_error = true;
     m_errorStr = errorMessage;
 }
+
+/**
+ * Announce the start of a phase to listeners of the database being written.
+ *
+ * @param db database being written
+ * @param phase name of the phase
+ */
+void KdbxWriter::startPhase(Database* db, const QString& phase)
+{
+    emit db->savePhaseStarted(phase);
+}
@@ -20,6 +20,7 @@
 
 #include "KeePass2.h"
 #include "core/Endian.h"
+#include "core/PhaseTimings.h"
 
 #include <QCoreApplication>
 
@@ -56,6 +57,7 @@ public:
 
     bool hasError() const;
     QString errorString() const;
+    const PhaseTimings& timings() const;
 
 protected:
     /**
@@ -83,9 +85,11 @@ protected:
 
     bool writeData(QIODevice* device, const QByteArray& data);
     void raiseError(const QString& errorMessage);
+    void startPhase(Database* db, const QString& phase);
 
     bool m_error = false;
     QString m_errorStr = "";
+    PhaseTimings m_timings;
 };
 
 #endif // KEEPASSXC_KDBXWRITER_H
@@ -25,10 +25,78 @@
 #include "streams/qtiocompressor.h"
 
 #include <QBuffer>
+#include <QElapsedTimer>
 #include <QFile>
+#include <QThread>
+#include <QtConcurrent>
+
+#include <algorithm>
+#include <limits>
 
 #define UUID_LENGTH 16
 
+namespace
+{
+    // Seconds between 0001-01-01 and 1970-01-01, the epochs of KDBX 4 and Unix timestamps
+    constexpr qint64 KdbxEpochOffset = Q_INT64_C(62135596800);
+
+    int base64Value(ushort c)
+    {
+        if (c >= 'A' && c <= 'Z') {
+            return c - 'A';
+        } else if (c >= 'a' && c <= 'z') {
+            return c - 'a' + 26;
+        } else if (c >= '0' && c <= '9') {
+            return c - '0' + 52;
+        } else if (c == '+') {
+            return 62;
+        } else if (c == '/') {
+            return 63;
+        }
+        return -1;
+    }
+
+    /**
+     * Decode strictly formatted base64 without allocating.
+     *
+     * Only the first maxSize bytes are stored in out, the remaining input is validated.
+     *
+     * @return size of the decoded data or -1 if the input is not valid base64
+     */
+    int decodeBase64(const QStringRef& str, char* out, int maxSize)
+    {
+        const int length = str.size();
+        if (length % 4 != 0) {
+            return -1;
+        }
+
+        const QChar* data = str.constData();
+        int size = 0;
+        for (int i = 0; i < length; i += 4) {
+            int values[4];
+            int padding = 0;
+            for (int j = 0; j < 4; ++j) {
+                const ushort c = data[i + j].unicode();
+                if (c == '=' && i + 4 == length && j >= 2) {
+                    values[j] = 0;
+                    ++padding;
+                } else if (padding > 0 || (values[j] = base64Value(c)) < 0) {
+                    return -1;
+                }
+            }
+
+            const quint32 triple = (values[0] << 18) | (values[1] << 12) | (values[2] << 6) | values[3];
+            for (int j = 0; j < 3 - padding; ++j) {
+                if (size < maxSize) {
+                    out[size] = static_cast<char>((triple >> (16 - 8 * j)) & 0xFF);
+                }
+                ++size;
+            }
+        }
+        return size;
+    }
+} // namespace
+
 /**
  * @param version KDBX version
  */
@@ -94,6 +162,8 @@ void KdbxXmlReader::readDatabase(QIODevice* device, Database* db, KeePass2Random
 
     m_randomStream = randomStream;
     m_headerHash.clear();
+    m_modelTime = 0;
+    m_pendingEntries.clear();
 
     m_tmpParent.reset(new Group());
 
@@ -121,6 +191,9 @@ void KdbxXmlReader::readDatabase(QIODevice* device, Database* db, KeePass2Random
         qWarning("KdbxXmlReader::readDatabase: found %d invalid entry reference(s)", m_tmpParent->children().size());
     }
 
+    QElapsedTimer modelTimer;
+    modelTimer.start();
+
     const QSet<QString> poolKeys = Tools::asSet(m_binaryPool.keys());
     const QSet<QString> entryKeys = Tools::asSet(m_binaryMap.keys());
     const QSet<QString> unmappedKeys = entryKeys - poolKeys;
@@ -156,6 +229,8 @@ void KdbxXmlReader::readDatabase(QIODevice* device, Database* db, KeePass2Random
             histEntry->setUpdateTimeinfo(true);
         }
     }
+
+    m_modelTime += modelTimer.nsecsElapsed();
 }
 
 bool KdbxXmlReader::strictMode() const
@@ -203,6 +278,15 @@ QByteArray KdbxXmlReader::headerHash() const
     return m_headerHash;
 }
 
+/**
+ * @return time spent creating the entries, attaching binaries and enabling time
+ *         info updates after parsing the document, in nanoseconds
+ */
+qint64 KdbxXmlReader::modelTime() const
+{
+    return m_modelTime;
+}
+
 bool KdbxXmlReader::parseKeePassFile()
 {
     Q_ASSERT(m_xml.isStartElement() && m_xml.name() == "KeePassFile");
@@ -418,10 +502,17 @@ void KdbxXmlReader::parseCustomData(CustomData* customData)
 
 void KdbxXmlReader::parseCustomDataItem(CustomData* customData)
 {
-    Q_ASSERT(m_xml.isStartElement() && m_xml.name() == "Item");
-
     QString key;
     CustomData::CustomDataItem item;
+    if (parseCustomDataItem(key, item)) {
+        customData->set(key, item);
+    }
+}
+
+bool KdbxXmlReader::parseCustomDataItem(QString& key, CustomData::CustomDataItem& item)
+{
+    Q_ASSERT(m_xml.isStartElement() && m_xml.name() == "Item");
+
     bool keySet = false;
     bool valueSet = false;
 
@@ -440,11 +531,11 @@ void KdbxXmlReader::parseCustomDataItem(CustomData* customData)
     }
 
     if (keySet && valueSet) {
-        customData->set(key, item);
-        return;
+        return true;
     }
 
     raiseError(tr("Missing custom data key or value"));
+    return false;
 }
 
 bool KdbxXmlReader::parseRoot()
@@ -463,6 +554,7 @@ bool KdbxXmlReader::parseRoot()
             }
 
             Group* rootGroup = parseGroup();
+            createEntries();
             if (rootGroup) {
                 auto oldRoot = m_db->setRootGroup(rootGroup);
                 delete oldRoot;
@@ -487,7 +579,7 @@ Group* KdbxXmlReader::parseGroup()
     auto group = new Group();
     group->setUpdateTimeinfo(false);
     QList<Group*> children;
-    QList<Entry*> entries;
+    QList<int> entryIndexes;
     while (!m_xml.hasError() && m_xml.readNextStartElement()) {
         if (m_xml.name() == "UUID") {
             QUuid uuid = readUuid();
@@ -585,10 +677,10 @@ Group* KdbxXmlReader::parseGroup()
             continue;
         }
         if (m_xml.name() == "Entry") {
-            Entry* newEntry = parseEntry(false);
-            if (newEntry) {
-                entries.append(newEntry);
-            }
+            PendingEntry pending;
+            parseEntry(pending.record, &pending.history);
+            entryIndexes.append(m_pendingEntries.size());
+            m_pendingEntries.append(std::move(pending));
             continue;
         }
         if (m_xml.name() == "CustomData") {
@@ -621,8 +713,9 @@ Group* KdbxXmlReader::parseGroup()
         child->setParent(group, -1, false);
     }
 
-    for (Entry* entry : asConst(entries)) {
-        entry->setGroup(group, false);
+    // The entries are created and added once the whole tree is known
+    for (int index : asConst(entryIndexes)) {
+        m_pendingEntries[index].group = group;
     }
 
     return group;
@@ -677,15 +770,10 @@ void KdbxXmlReader::parseDeletedObject()
     }
 }
 
-Entry* KdbxXmlReader::parseEntry(bool history)
+void KdbxXmlReader::parseEntry(EntryRecord& record, QList<EntryRecord>* history)
 {
     Q_ASSERT(m_xml.isStartElement() && m_xml.name() == "Entry");
 
-    auto entry = new Entry();
-    entry->setUpdateTimeinfo(false);
-    QList<Entry*> historyItems;
-    QList<StringPair> binaryRefs;
-
     while (!m_xml.hasError() && m_xml.readNextStartElement()) {
         if (m_xml.name() == "UUID") {
             QUuid uuid = readUuid();
@@ -693,10 +781,10 @@ Entry* KdbxXmlReader::parseEntry(bool history)
                 if (m_strictMode) {
                     raiseError(tr("Null entry uuid"));
                 } else {
-                    entry->setUuid(QUuid::createUuid());
+                    record.uuid = QUuid::createUuid();
                 }
             } else {
-                entry->setUuid(uuid);
+                record.uuid = uuid;
             }
             continue;
         }
@@ -708,120 +796,127 @@ Entry* KdbxXmlReader::parseEntry(bool history)
                 }
                 iconId = 0;
             }
-            entry->setIcon(iconId);
+            record.iconNumber = iconId;
+            record.customIcon = QUuid();
             continue;
         }
         if (m_xml.name() == "CustomIconUUID") {
             QUuid uuid = readUuid();
             if (!uuid.isNull()) {
-                entry->setIcon(uuid);
+                record.customIcon = uuid;
             }
             continue;
         }
         if (m_xml.name() == "ForegroundColor") {
-            entry->setForegroundColor(readColor());
+            record.foregroundColor = readColor();
             continue;
         }
         if (m_xml.name() == "BackgroundColor") {
-            entry->setBackgroundColor(readColor());
+            record.backgroundColor = readColor();
             continue;
         }
         if (m_xml.name() == "OverrideURL") {
-            entry->setOverrideUrl(readString());
+            record.overrideUrl = readString();
             continue;
         }
         if (m_xml.name() == "Tags") {
-            entry->setTags(readString());
+            record.tags = readString();
             continue;
         }
         if (m_xml.name() == "Times") {
-            entry->setTimeInfo(parseTimes());
+            record.timeInfo = parseTimes();
             continue;
         }
         if (m_xml.name() == "String") {
-            parseEntryString(entry);
+            parseEntryString(record);
             continue;
         }
         if (m_xml.name() == "QualityCheck") {
-            entry->setExcludeFromReports(!readBool());
+            record.excludeFromReports = !readBool();
             continue;
         }
         if (m_xml.name() == "Binary") {
-            QPair<QString, QString> ref = parseEntryBinary(entry);
+            QPair<QString, QString> ref = parseEntryBinary(record);
             if (!ref.first.isEmpty() && !ref.second.isEmpty()) {
-                binaryRefs.append(ref);
+                record.binaryRefs.append(ref);
             }
             continue;
         }
         if (m_xml.name() == "AutoType") {
-            parseAutoType(entry);
+            parseAutoType(record);
             continue;
         }
         if (m_xml.name() == "History") {
-            if (history) {
+            if (!history) {
                 raiseError(tr("History element in history entry"));
             } else {
-                historyItems = parseEntryHistory();
+                *history = parseEntryHistory();
             }
             continue;
         }
         if (m_xml.name() == "CustomData") {
-            parseCustomData(entry->customData());
-
-            // Upgrade pre-KDBX-4.1 password report exclude flag
-            if (entry->customData()->contains(CustomData::ExcludeFromReportsLegacy)) {
-                entry->setExcludeFromReports(entry->customData()->value(CustomData::ExcludeFromReportsLegacy)
-                                             == TRUE_STR);
-                entry->customData()->remove(CustomData::ExcludeFromReportsLegacy);
-            }
+            parseEntryCustomData(record);
             continue;
         }
         if (m_xml.name() == "PreviousParentGroup") {
-            entry->setPreviousParentGroupUuid(readUuid());
+            record.previousParentGroupUuid = readUuid();
             continue;
         }
         skipCurrentElement();
     }
 
-    if (entry->uuid().isNull() && !m_strictMode) {
-        entry->setUuid(QUuid::createUuid());
+    if (record.uuid.isNull() && !m_strictMode) {
+        record.uuid = QUuid::createUuid();
     }
 
-    if (!entry->uuid().isNull()) {
-        if (history) {
-            entry->setUpdateTimeinfo(false);
-        } else {
-            Entry* tmpEntry = entry;
-
-            entry = getEntry(tmpEntry->uuid());
-            entry->copyDataFrom(tmpEntry);
-            entry->setUpdateTimeinfo(false);
-
-            delete tmpEntry;
-        }
-    } else if (!hasError()) {
+    if (record.uuid.isNull() && !hasError()) {
         raiseError(tr("No entry uuid found"));
     }
 
-    for (Entry* historyItem : asConst(historyItems)) {
-        if (historyItem->uuid() != entry->uuid()) {
-            if (m_strictMode) {
-                raiseError(tr("History element with different uuid"));
-            } else {
-                historyItem->setUuid(entry->uuid());
+    if (history) {
+        for (EntryRecord& historyRecord : *history) {
+            if (historyRecord.uuid != record.uuid) {
+                if (m_strictMode) {
+                    raiseError(tr("History element with different uuid"));
+                } else {
+                    historyRecord.uuid = record.uuid;
+                }
             }
         }
-        entry->addHistoryItem(historyItem);
     }
+}
 
-    for (const StringPair& ref : asConst(binaryRefs)) {
-        m_binaryMap.insert(ref.first, qMakePair(entry, ref.second));
+void KdbxXmlReader::parseEntryCustomData(EntryRecord& record)
+{
+    Q_ASSERT(m_xml.isStartElement() && m_xml.name() == "CustomData");
+
+    while (!m_xml.hasError() && m_xml.readNextStartElement()) {
+        if (m_xml.name() == "Item") {
+            QString key;
+            CustomData::CustomDataItem item;
+            if (parseCustomDataItem(key, item)) {
+                record.customData.append(qMakePair(key, item));
+            }
+            continue;
+        }
+        skipCurrentElement();
     }
 
-    return entry;
+    // Upgrade pre-KDBX-4.1 password report exclude flag
+    for (int i = record.customData.size() - 1; i >= 0; --i) {
+        if (record.customData.at(i).first == CustomData::ExcludeFromReportsLegacy) {
+            record.excludeFromReports = record.customData.at(i).second.value == TRUE_STR;
+            break;
+        }
+    }
+    auto isLegacyItem = [](const QPair<QString, CustomData::CustomDataItem>& item) {
+        return item.first == CustomData::ExcludeFromReportsLegacy;
+    };
+    record.customData.erase(std::remove_if(record.customData.begin(), record.customData.end(), isLegacyItem),
+                            record.customData.end());
 }
 
-void KdbxXmlReader::parseEntryString(Entry* entry)
+void KdbxXmlReader::parseEntryString(EntryRecord& record)
 {
     Q_ASSERT(m_xml.isStartElement() && m_xml.name() == "String");
 
@@ -839,7 +934,6 @@ void KdbxXmlReader::parseEntryString(Entry* entry)
         }
 
         if (m_xml.name() == "Value") {
-            QXmlStreamAttributes attr = m_xml.attributes();
             bool isProtected;
             bool protectInMemory;
             value = readString(isProtected, protectInMemory);
@@ -852,19 +946,26 @@ void KdbxXmlReader::parseEntryString(Entry* entry)
     }
 
     if (keySet && valueSet) {
-        // the default attributes are always there so additionally check if it's empty
-        if (entry->attributes()->hasKey(key) && !entry->attributes()->value(key).isEmpty()) {
-            raiseError(tr("Duplicate custom attribute found"));
-            return;
+        // the default attributes are always there so only values that are not empty are duplicates
+        for (EntryRecord::Attribute& attribute : record.attributes) {
+            if (attribute.key == key) {
+                if (!attribute.value.isEmpty()) {
+                    raiseError(tr("Duplicate custom attribute found"));
+                    return;
+                }
+                attribute.value = value;
+                attribute.protect = protect;
+                return;
+            }
         }
-        entry->attributes()->set(key, value, protect);
+        record.attributes.append({key, value, protect});
         return;
     }
 
     raiseError(tr("Entry string key or value missing"));
 }
 
-QPair<QString, QString> KdbxXmlReader::parseEntryBinary(Entry* entry)
+QPair<QString, QString> KdbxXmlReader::parseEntryBinary(EntryRecord& record)
 {
     Q_ASSERT(m_xml.isStartElement() && m_xml.name() == "Binary");
 
@@ -899,13 +1000,16 @@ QPair<QString, QString> KdbxXmlReader::parseEntryBinary(Entry* entry)
     }
 
     if (keySet && valueSet) {
-        if (entry->attachments()->hasKey(key) && entry->attachments()->value(key) != value) {
-            // NOTE: This only impacts KDBX 3.x databases
-            // Prepend a random string to the key to make it unique and prevent data loss
-            key = key.prepend(QUuid::createUuid().toString().mid(1, 8) + "_");
-            qWarning("Duplicate attachment name found, renamed to: %s", qPrintable(key));
+        for (const auto& attachment : asConst(record.attachments)) {
+            if (attachment.first == key && attachment.second != value) {
+                // NOTE: This only impacts KDBX 3.x databases
+                // Prepend a random string to the key to make it unique and prevent data loss
+                key = key.prepend(QUuid::createUuid().toString().mid(1, 8) + "_");
+                qWarning("Duplicate attachment name found, renamed to: %s", qPrintable(key));
+                break;
+            }
         }
-        entry->attachments()->set(key, value);
+        record.attachments.append(qMakePair(key, value));
     } else {
         raiseError(tr("Entry binary key or value missing"));
     }
@@ -913,26 +1017,26 @@ QPair<QString, QString> KdbxXmlReader::parseEntryBinary(Entry* entry)
     return poolRef;
 }
 
-void KdbxXmlReader::parseAutoType(Entry* entry)
+void KdbxXmlReader::parseAutoType(EntryRecord& record)
 {
     Q_ASSERT(m_xml.isStartElement() && m_xml.name() == "AutoType");
 
     while (!m_xml.hasError() && m_xml.readNextStartElement()) {
         if (m_xml.name() == "Enabled") {
-            entry->setAutoTypeEnabled(readBool());
+            record.autoTypeEnabled = readBool();
         } else if (m_xml.name() == "DataTransferObfuscation") {
-            entry->setAutoTypeObfuscation(readNumber());
+            record.autoTypeObfuscation = readNumber();
         } else if (m_xml.name() == "DefaultSequence") {
-            entry->setDefaultAutoTypeSequence(readString());
+            record.defaultAutoTypeSequence = readString();
         } else if (m_xml.name() == "Association") {
-            parseAutoTypeAssoc(entry);
+            parseAutoTypeAssoc(record);
         } else {
             skipCurrentElement();
         }
     }
 }
 
-void KdbxXmlReader::parseAutoTypeAssoc(Entry* entry)
+void KdbxXmlReader::parseAutoTypeAssoc(EntryRecord& record)
 {
     Q_ASSERT(m_xml.isStartElement() && m_xml.name() == "Association");
 
@@ -953,27 +1057,29 @@ void KdbxXmlReader::parseAutoTypeAssoc(Entry* entry)
     }
 
     if (windowSet && sequenceSet) {
-        entry->autoTypeAssociations()->add(assoc);
+        record.autoTypeAssociations.append(assoc);
         return;
     }
     raiseError(tr("Auto-type association window or sequence missing"));
 }
 
-QList<Entry*> KdbxXmlReader::parseEntryHistory()
+QList<KdbxXmlReader::EntryRecord> KdbxXmlReader::parseEntryHistory()
 {
     Q_ASSERT(m_xml.isStartElement() && m_xml.name() == "History");
 
-    QList<Entry*> historyItems;
+    QList<EntryRecord> historyRecords;
 
     while (!m_xml.hasError() && m_xml.readNextStartElement()) {
         if (m_xml.name() == "Entry") {
-            historyItems.append(parseEntry(true));
+            EntryRecord historyRecord;
+            parseEntry(historyRecord, nullptr);
+            historyRecords.append(historyRecord);
         } else {
             skipCurrentElement();
         }
     }
 
-    return historyItems;
+    return historyRecords;
 }
 
 TimeInfo KdbxXmlReader::parseTimes()
@@ -1035,14 +1141,42 @@ QString KdbxXmlReader::readString(bool& isProtected, bool& protectInMemory)
     return value;
 }
 
+/**
+ * Read the text of a scalar element into a reused buffer.
+ *
+ * Protected values are decrypted through readString(). The returned reference is only
+ * valid until the next call.
+ */
+QStringRef KdbxXmlReader::readScalar()
+{
+    if (isTrueValue(m_xml.attributes().value("Protected"))) {
+        m_scalarBuffer = readString();
+        return QStringRef(&m_scalarBuffer);
+    }
+
+    // Resizing keeps the capacity, so no memory is allocated once the buffer has grown
+    m_scalarBuffer.resize(0);
+    while (m_xml.readNext() != QXmlStreamReader::EndElement) {
+        if (m_xml.isCharacters() || m_xml.isEntityReference()) {
+            m_scalarBuffer.append(m_xml.text());
+        } else if (m_xml.isStartElement()) {
+            m_xml.raiseError(tr("Expected character data."));
+            break;
+        } else if (m_xml.atEnd() || m_xml.hasError()) {
+            break;
+        }
+    }
+    return QStringRef(&m_scalarBuffer);
+}
+
 bool KdbxXmlReader::readBool()
 {
-    QString str = readString();
+    QStringRef str = readScalar();
 
-    if (str.compare("true", Qt::CaseInsensitive) == 0) {
+    if (str.compare(QLatin1String("true"), Qt::CaseInsensitive) == 0) {
         return true;
     }
-    if (str.compare("false", Qt::CaseInsensitive) == 0) {
+    if (str.compare(QLatin1String("false"), Qt::CaseInsensitive) == 0) {
         return false;
     }
     if (str.length() == 0) {
@@ -1054,14 +1188,21 @@ bool KdbxXmlReader::readBool()
 
 QDateTime KdbxXmlReader::readDateTime()
 {
-    QString str = readString();
-    if (Tools::isBase64(str.toLatin1())) {
-        QByteArray secsBytes = QByteArray::fromBase64(str.toUtf8()).leftJustified(8, '\0', true).left(8);
-        qint64 secs = Endian::bytesToSizedInt<quint64>(secsBytes, KeePass2::BYTEORDER);
+    QStringRef str = readScalar();
+
+    // KDBX 4 stores the seconds since 0001-01-01 as base64 encoded 64 bit integer
+    char secsBytes[8] = {};
+    if (decodeBase64(str, secsBytes, sizeof(secsBytes)) >= 0) {
+        QByteArray secsData = QByteArray::fromRawData(secsBytes, sizeof(secsBytes));
+        qint64 secs = Endian::bytesToSizedInt<quint64>(secsData, KeePass2::BYTEORDER);
+        // Stay clear of overflowing the millisecond conversion
+        if (secs >= 0 && secs < std::numeric_limits<qint64>::max() / 1000) {
+            return QDateTime::fromMSecsSinceEpoch((secs - KdbxEpochOffset) * 1000, Qt::UTC);
+        }
         return QDateTime(QDate(1, 1, 1), QTime(0, 0, 0, 0), Qt::UTC).addSecs(secs);
     }
 
-    QDateTime dt = Clock::parse(str, Qt::ISODate);
+    QDateTime dt = Clock::parse(m_scalarBuffer, Qt::ISODate);
     if (dt.isValid()) {
         return dt;
     }
@@ -1106,7 +1247,7 @@ QString KdbxXmlReader::readColor()
 int KdbxXmlReader::readNumber()
 {
     bool ok;
-    int result = readString().toInt(&ok);
+    int result = readScalar().toInt(&ok);
     if (!ok) {
         raiseError(tr("Invalid number value"));
     }
@@ -1115,7 +1256,28 @@ int KdbxXmlReader::readNumber()
 
 QUuid KdbxXmlReader::readUuid()
 {
-    QByteArray uuidBin = readBinary();
+    if (isTrueValue(m_xml.attributes().value("Protected"))) {
+        return uuidFromBinary(readBinary());
+    }
+
+    QStringRef str = readScalar();
+    char uuidBytes[UUID_LENGTH];
+    int size = decodeBase64(str, uuidBytes, UUID_LENGTH);
+    if (size < 0) {
+        // Not strictly formatted, decode it as leniently as other binaries
+        return uuidFromBinary(QByteArray::fromBase64(str.toLatin1()));
+    }
+    if (size != UUID_LENGTH) {
+        if (size > 0 && m_strictMode) {
+            raiseError(tr("Invalid uuid value"));
+        }
+        return {};
+    }
+    return QUuid::fromRfc4122(QByteArray::fromRawData(uuidBytes, UUID_LENGTH));
+}
+
+QUuid KdbxXmlReader::uuidFromBinary(const QByteArray& uuidBin)
+{
     if (uuidBin.isEmpty()) {
         return {};
     }
@@ -1205,6 +1367,134 @@ Entry* KdbxXmlReader::getEntry(const QUuid& uuid)
     return entry;
 }
 
+/**
+ * Create the entries read from the document and add them to their groups.
+ *
+ * Entries do not depend on each other, so they are created on all cores. Entries whose uuid
+ * is already in use by a forward reference or an earlier entry are merged into the existing
+ * object afterwards, in document order.
+ */
+void KdbxXmlReader::createEntries()
+{
+    QElapsedTimer timer;
+    timer.start();
+
+    QSet<QUuid> uuids;
+    for (PendingEntry& pending : m_pendingEntries) {
+        const QUuid& uuid = pending.record.uuid;
+        if (!uuid.isNull()) {
+            pending.merge = m_entries.contains(uuid) || uuids.contains(uuid);
+            uuids.insert(uuid);
+        }
+    }
+
+    QThread* thread = QThread::currentThread();
+    auto create = [this, thread](PendingEntry& pending) {
+        pending.entry = createEntry(pending.record);
+        for (const EntryRecord& record : asConst(pending.history)) {
+            pending.historyItems.append(createEntry(record));
+        }
+
+        if (!pending.merge) {
+            for (Entry* historyItem : asConst(pending.historyItems)) {
+                pending.entry->addHistoryItem(historyItem);
+            }
+        }
+
+        // Hand the new objects over to the thread reading the database
+        if (QThread::currentThread() != thread) {
+            pending.entry->moveToThread(thread);
+            for (Entry* historyItem : asConst(pending.historyItems)) {
+                historyItem->moveToThread(thread);
+            }
+        }
+    };
+
+    // Small databases are not worth the overhead of the thread pool
+    if (m_pendingEntries.size() < 64) {
+        for (PendingEntry& pending : m_pendingEntries) {
+            create(pending);
+        }
+    } else {
+        QtConcurrent::blockingMap(m_pendingEntries, create);
+    }
+
+    for (PendingEntry& pending : m_pendingEntries) {
+        Entry* entry = pending.entry;
+        if (pending.merge) {
+            entry = getEntry(pending.record.uuid);
+            entry->copyDataFrom(pending.entry);
+            entry->setUpdateTimeinfo(false);
+            delete pending.entry;
+
+            for (Entry* historyItem : asConst(pending.historyItems)) {
+                entry->addHistoryItem(historyItem);
+            }
+        } else if (!pending.record.uuid.isNull()) {
+            m_entries.insert(pending.record.uuid, entry);
+        }
+
+        // History items keep their own attachments
+        for (int i = 0; i < pending.history.size(); ++i) {
+            for (const StringPair& ref : asConst(pending.history[i].binaryRefs)) {
+                m_binaryMap.insert(ref.first, qMakePair(pending.historyItems[i], ref.second));
+            }
+        }
+        for (const StringPair& ref : asConst(pending.record.binaryRefs)) {
+            m_binaryMap.insert(ref.first, qMakePair(entry, ref.second));
+        }
+
+        Q_ASSERT(pending.group);
+        entry->setGroup(pending.group, false);
+    }
+
+    m_pendingEntries.clear();
+    m_modelTime += timer.nsecsElapsed();
+}
+
+/**
+ * Create an entry from its record, safe to call from any thread.
+ */
+Entry* KdbxXmlReader::createEntry(const EntryRecord& record) const
+{
+    auto entry = new Entry();
+    entry->setUpdateTimeinfo(false);
+
+    if (!record.uuid.isNull()) {
+        entry->setUuid(record.uuid);
+    }
+    if (!record.customIcon.isNull()) {
+        entry->setIcon(record.customIcon);
+    } else if (record.iconNumber >= 0) {
+        entry->setIcon(record.iconNumber);
+    }
+    entry->setForegroundColor(record.foregroundColor);
+    entry->setBackgroundColor(record.backgroundColor);
+    entry->setOverrideUrl(record.overrideUrl);
+    entry->setTags(record.tags);
+    entry->setTimeInfo(record.timeInfo);
+    entry->setExcludeFromReports(record.excludeFromReports);
+    entry->setAutoTypeEnabled(record.autoTypeEnabled);
+    entry->setAutoTypeObfuscation(record.autoTypeObfuscation);
+    entry->setDefaultAutoTypeSequence(record.defaultAutoTypeSequence);
+    entry->setPreviousParentGroupUuid(record.previousParentGroupUuid);
+
+    for (const EntryRecord::Attribute& attribute : record.attributes) {
+        entry->attributes()->set(attribute.key, attribute.value, attribute.protect);
+    }
+    for (const auto& attachment : record.attachments) {
+        entry->attachments()->set(attachment.first, attachment.second);
+    }
+    for (const AutoTypeAssociations::Association& assoc : record.autoTypeAssociations) {
+        entry->autoTypeAssociations()->add(assoc);
+    }
+    for (const auto& item : record.customData) {
+        entry->customData()->set(item.first, item.second);
+    }
+
+    return entry;
+}
+
 void KdbxXmlReader::skipCurrentElement()
 {
     qWarning("KdbxXmlReader::skipCurrentElement: skip element \"%s\"", qPrintable(m_xml.name().toString()));
@@ -18,8 +18,11 @@
 #ifndef KEEPASSXC_KDBXXMLREADER_H
 #define KEEPASSXC_KDBXXMLREADER_H
 
+#include "core/AutoTypeAssociations.h"
+#include "core/CustomData.h"
 #include "core/Database.h"
 #include "core/Metadata.h"
+#include "core/TimeInfo.h"
 
 #include <QCoreApplication>
 #include <QMultiHash>
@@ -29,7 +32,6 @@ class QIODevice;
 class Group;
 class Entry;
 class KeePass2RandomStream;
-class TimeInfo;
 
 /**
  * KDBX XML payload reader.
@@ -51,6 +53,7 @@ public:
     QString errorString() const;
 
     QByteArray headerHash() const;
+    qint64 modelTime() const;
 
     bool strictMode() const;
     void setStrictMode(bool strictMode);
@@ -58,6 +61,53 @@ public:
 protected:
     typedef QPair<QString, QString> StringPair;
 
+    /**
+     * Values of an entry as read from the document, turned into an Entry once parsing is done.
+     */
+    struct EntryRecord
+    {
+        struct Attribute
+        {
+            QString key;
+            QString value;
+            bool protect;
+        };
+
+        QUuid uuid;
+        int iconNumber = -1;
+        QUuid customIcon;
+        QString foregroundColor;
+        QString backgroundColor;
+        QString overrideUrl;
+        QString tags;
+        TimeInfo timeInfo;
+        bool excludeFromReports = false;
+        bool autoTypeEnabled = true;
+        int autoTypeObfuscation = 0;
+        QString defaultAutoTypeSequence;
+        QList<AutoTypeAssociations::Association> autoTypeAssociations;
+        QList<Attribute> attributes;
+        QList<QPair<QString, QByteArray>> attachments;
+        QList<StringPair> binaryRefs;
+        QList<QPair<QString, CustomData::CustomDataItem>> customData;
+        QUuid previousParentGroupUuid;
+    };
+
+    /**
+     * Entry of a group with its history, in document order.
+     */
+    struct PendingEntry
+    {
+        EntryRecord record;
+        QList<EntryRecord> history;
+        Group* group = nullptr;
+        // Entries that have to be merged into an existing object with the same uuid
+        bool merge = false;
+        Entry* entry = nullptr;
+        // Created from history, in the same order
+        QList<Entry*> historyItems;
+    };
+
     virtual bool parseKeePassFile();
     virtual void parseMeta();
     virtual void parseMemoryProtection();
@@ -66,25 +116,29 @@ protected:
     virtual void parseBinaries();
     virtual void parseCustomData(CustomData* customData);
     virtual void parseCustomDataItem(CustomData* customData);
+    virtual bool parseCustomDataItem(QString& key, CustomData::CustomDataItem& item);
     virtual bool parseRoot();
     virtual Group* parseGroup();
     virtual void parseDeletedObjects();
     virtual void parseDeletedObject();
-    virtual Entry* parseEntry(bool history);
-    virtual void parseEntryString(Entry* entry);
-    virtual QPair<QString, QString> parseEntryBinary(Entry* entry);
-    virtual void parseAutoType(Entry* entry);
-    virtual void parseAutoTypeAssoc(Entry* entry);
-    virtual QList<Entry*> parseEntryHistory();
+    virtual void parseEntryCustomData(EntryRecord& record);
+    virtual void parseEntry(EntryRecord& record, QList<EntryRecord>* history);
+    virtual void parseEntryString(EntryRecord& record);
+    virtual QPair<QString, QString> parseEntryBinary(EntryRecord& record);
+    virtual void parseAutoType(EntryRecord& record);
+    virtual void parseAutoTypeAssoc(EntryRecord& record);
+    virtual QList<EntryRecord> parseEntryHistory();
     virtual TimeInfo parseTimes();
 
     virtual QString readString();
     virtual QString readString(bool& isProtected, bool& protectInMemory);
+    virtual QStringRef readScalar();
     virtual bool readBool();
     virtual QDateTime readDateTime();
     virtual QString readColor();
     virtual int readNumber();
     virtual QUuid readUuid();
+    virtual QUuid uuidFromBinary(const QByteArray& uuidBin);
     virtual QByteArray readBinary();
     virtual QByteArray readCompressedBinary();
 
@@ -92,6 +146,8 @@ protected:
 
     virtual Group* getGroup(const QUuid& uuid);
     virtual Entry* getEntry(const QUuid& uuid);
+    virtual void createEntries();
+    Entry* createEntry(const EntryRecord& record) const;
 
     virtual bool isTrueValue(const QStringRef& value);
     virtual void raiseError(const QString& errorMessage);
@@ -108,10 +164,13 @@ protected:
     QScopedPointer<Group> m_tmpParent;
     QHash<QUuid, Group*> m_groups;
     QHash<QUuid, Entry*> m_entries;
+    QVector<PendingEntry> m_pendingEntries;
 
     QHash<QString, QByteArray> m_binaryPool;
     QMultiHash<QString, QPair<Entry*, QString>> m_binaryMap;
     QByteArray m_headerHash;
+    qint64 m_modelTime = 0;
+    QString m_scalarBuffer;
 
     bool m_error = false;
     QString m_errorStr = "";
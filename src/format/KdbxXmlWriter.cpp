@@ -106,7 +106,7 @@ void KdbxXmlWriter::fillBinaryIdxMap()
     QHash<QByteArray, qint64> writtenAttachments;
     qint64 nextIdx = 0;
 
-    for (Entry* entry : allEntries) {
+    for (const Entry* entry : allEntries) {
         const QList<QString> attachmentKeys = entry->attachments()->keys();
         for (const QString& key : attachmentKeys) {
             QByteArray data = entry->attachments()->value(key);
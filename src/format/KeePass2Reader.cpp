@@ -123,6 +123,14 @@ QSharedPointer<KdbxReader> KeePass2Reader::reader() const
     return m_reader;
 }
 
+/**
+ * @return time spent in the phases of reading the input file
+ */
+PhaseTimings KeePass2Reader::timings() const
+{
+    return !m_reader.isNull() ? m_reader->timings() : PhaseTimings();
+}
+
 /**
  * Raise an error. Use in case of an unexpected read error.
  *
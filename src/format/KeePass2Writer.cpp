@@ -194,3 +194,11 @@ quint32 KeePass2Writer::version() const
 {
     return m_version;
 }
+
+/**
+ * @return time spent in the phases of writing the output file
+ */
+PhaseTimings KeePass2Writer::timings() const
+{
+    return m_writer ? m_writer->timings() : PhaseTimings();
+}
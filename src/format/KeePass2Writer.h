@@ -37,6 +37,7 @@ public:
 
     QSharedPointer<KdbxWriter> writer() const;
     quint32 version() const;
+    PhaseTimings timings() const;
 
     bool hasError() const;
     QString errorString() const;
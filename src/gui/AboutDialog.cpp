@@ -24,6 +24,10 @@
 #include "crypto/Crypto.h"
 #include "gui/Icons.h"
 
+#ifdef WITH_XC_BROWSER
+#include "browser/BrowserService.h"
+#endif
+
 #include <QClipboard>
 
 static const QString aboutMaintainers = R"(
@@ -315,6 +319,12 @@ AboutDialog::AboutDialog(QWidget* parent)
     m_ui->iconLabel->setPixmap(icons()->applicationIcon().pixmap(48));
 
     QString debugInfo = Tools::debugInfo().append("\n").append(Crypto::debugInfo());
+#ifdef WITH_XC_BROWSER
+    const auto browserInfo = browserService()->debugInfo();
+    if (!browserInfo.isEmpty()) {
+        debugInfo.append("\n").append(browserInfo);
+    }
+#endif
     m_ui->debugInfo->setPlainText(debugInfo);
 
     m_ui->maintainers->setText(aboutMaintainers);
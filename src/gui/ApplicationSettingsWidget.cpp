@@ -27,6 +27,7 @@
 
 #include "autotype/AutoType.h"
 #include "core/Translator.h"
+#include "format/DatabaseOpenCache.h"
 #include "gui/Icons.h"
 #include "gui/MainWindow.h"
 #include "gui/osutils/OSUtils.h"
@@ -37,6 +38,9 @@
 #ifdef WITH_XC_BROWSER
 #include "browser/BrowserSettingsPage.h"
 #endif
+#ifdef WITH_XC_NETWORKING
+#include "core/HibpDownloader.h"
+#endif
 
 class ApplicationSettingsWidget::ExtraPage
 {
@@ -318,6 +322,9 @@ void ApplicationSettingsWidget::loadSettings()
     m_secUi->lockDatabaseOnScreenLockCheckBox->setChecked(
         config()->get(Config::Security_LockDatabaseScreenLock).toBool());
     m_secUi->fallbackToSearch->setChecked(config()->get(Config::Security_IconDownloadFallback).toBool());
+    m_secUi->persistPasswordHealthCheckBox->setChecked(config()->get(Config::Security_PersistPasswordHealth).toBool());
+    m_secUi->openCacheCheckBox->setChecked(config()->get(Config::Security_OpenCache).toBool());
+    m_secUi->hibpCacheCheckBox->setChecked(config()->get(Config::Security_HibpCache).toBool());
 
     m_secUi->passwordsHiddenCheckBox->setChecked(config()->get(Config::Security_PasswordsHidden).toBool());
     m_secUi->passwordShowDotsCheckBox->setChecked(config()->get(Config::Security_PasswordEmptyPlaceholder).toBool());
@@ -431,6 +438,17 @@ void ApplicationSettingsWidget::saveSettings()
     config()->set(Config::Security_LockDatabaseMinimize, m_secUi->lockDatabaseMinimizeCheckBox->isChecked());
     config()->set(Config::Security_LockDatabaseScreenLock, m_secUi->lockDatabaseOnScreenLockCheckBox->isChecked());
     config()->set(Config::Security_IconDownloadFallback, m_secUi->fallbackToSearch->isChecked());
+    config()->set(Config::Security_PersistPasswordHealth, m_secUi->persistPasswordHealthCheckBox->isChecked());
+    if (config()->get(Config::Security_OpenCache).toBool() && !m_secUi->openCacheCheckBox->isChecked()) {
+        DatabaseOpenCache::removeAll();
+    }
+    config()->set(Config::Security_OpenCache, m_secUi->openCacheCheckBox->isChecked());
+#ifdef WITH_XC_NETWORKING
+    if (config()->get(Config::Security_HibpCache).toBool() && !m_secUi->hibpCacheCheckBox->isChecked()) {
+        HibpDownloader::removeDefaultCache();
+    }
+#endif
+    config()->set(Config::Security_HibpCache, m_secUi->hibpCacheCheckBox->isChecked());
 
     config()->set(Config::Security_PasswordsHidden, m_secUi->passwordsHiddenCheckBox->isChecked());
     config()->set(Config::Security_PasswordEmptyPlaceholder, m_secUi->passwordShowDotsCheckBox->isChecked());
@@ -30,15 +30,25 @@
 #endif
 #include "quickunlock/QuickUnlockInterface.h"
 
+#include <QAction>
 #include <QCheckBox>
 #include <QCloseEvent>
 #include <QDesktopServices>
 #include <QFont>
+#include <QFutureWatcher>
+#include <QtConcurrent>
 
 namespace
 {
     constexpr int clearFormsDelay = 30000;
 
+    struct ReadResult
+    {
+        Database* db = nullptr;
+        bool ok = false;
+        QString error;
+    };
+
     bool isQuickUnlockAvailable()
     {
         if (config()->get(Config::Security_QuickUnlock).toBool()) {
@@ -87,6 +97,9 @@ DatabaseOpenWidget::DatabaseOpenWidget(QWidget* parent)
     connect(m_ui->buttonBox, SIGNAL(accepted()), SLOT(openDatabase()));
     connect(m_ui->buttonBox, SIGNAL(rejected()), SLOT(reject()));
 
+    m_cancelUnlockAction = new QAction(tr("Cancel"), this);
+    connect(m_cancelUnlockAction, &QAction::triggered, this, &DatabaseOpenWidget::cancelUnlock);
+
     connect(m_ui->addKeyFileLinkLabel, &QLabel::linkActivated, this, &DatabaseOpenWidget::browseKeyFile);
     connect(m_ui->keyFileLineEdit, &PasswordWidget::textChanged, this, [&](const QString& text) {
         bool state = !text.isEmpty();
@@ -246,6 +259,9 @@ void DatabaseOpenWidget::load(const QString& filename)
 
 void DatabaseOpenWidget::clearForms()
 {
+    // A running unlock would replace the database reset below
+    ++m_unlockId;
+    m_ui->messageWidget->removeAction(m_cancelUnlockAction);
     setUserInteractionLock(false);
     m_ui->editPassword->setText("");
     m_ui->editPassword->setShowPassword(false);
@@ -293,11 +309,33 @@ void DatabaseOpenWidget::openDatabase()
         return;
     }
 
-    QString error;
-    m_db.reset(new Database());
-    bool ok = m_db->open(m_filename, databaseKey, &error);
+    readDatabase(databaseKey, blockQuickUnlock);
+}
+
+/**
+ * Complete the unlock once the database was read on the worker thread.
+ *
+ * @param db database read from the file, owned by this widget from now on
+ * @param ok true if the database was read successfully
+ * @param error error message in case of failure
+ * @param databaseKey composite key used for unlocking the database
+ * @param blockQuickUnlock true if the key must not be stored for Quick Unlock
+ */
+void DatabaseOpenWidget::finishOpenDatabase(Database* db,
+                                            bool ok,
+                                            const QString& error,
+                                            const QSharedPointer<const CompositeKey>& databaseKey,
+                                            bool blockQuickUnlock)
+{
+    // Drop phase updates still queued for this unlock
+    ++m_unlockId;
+    m_ui->messageWidget->removeAction(m_cancelUnlockAction);
+    m_ui->messageWidget->hideMessage();
+    m_db.reset(db);
 
     if (ok) {
+        m_db->completeOpen();
+
         // Warn user about minor version mismatch to halt loading if necessary
         if (m_db->hasMinorVersionMismatch()) {
             QScopedPointer<QMessageBox> msgBox(new QMessageBox(this));
@@ -314,8 +352,9 @@ void DatabaseOpenWidget::openDatabase()
             msgBox->layout()->setSizeConstraint(QLayout::SetMinimumSize);
             msgBox->exec();
             if (msgBox->clickedButton() != btn) {
+                QString headerError;
                 m_db.reset(new Database());
-                m_db->open(m_filename, nullptr, &error);
+                m_db->open(m_filename, nullptr, &headerError);
 
                 m_ui->messageWidget->showMessage(tr("Database unlock canceled."), MessageWidget::MessageType::Error);
                 setUserInteractionLock(false);
@@ -448,8 +487,88 @@ QSharedPointer<CompositeKey> DatabaseOpenWidget::buildDatabaseKey()
     return databaseKey;
 }
 
+/**
+ * Read and decrypt the database on a worker thread. The event loop keeps running meanwhile,
+ * so other databases can be unlocked at the same time and the unlock can be canceled.
+ * The unlock is completed by finishOpenDatabase() as soon as the read is done, without
+ * waiting for unlocks started later. The result of a canceled unlock is discarded once
+ * the worker is done with it.
+ *
+ * @param key composite key for unlocking the database
+ * @param blockQuickUnlock true if the key must not be stored for Quick Unlock
+ */
+void DatabaseOpenWidget::readDatabase(const QSharedPointer<const CompositeKey>& key, bool blockQuickUnlock)
+{
+    QPointer<DatabaseOpenWidget> self(this);
+    auto* guiThread = thread();
+    const int unlockId = ++m_unlockId;
+    auto future = QtConcurrent::run([filename = m_filename, key, guiThread, self, unlockId] {
+        // The database is created on the worker thread so all objects read from the file belong to it,
+        // then the whole tree is handed over to the GUI thread
+        ReadResult result;
+        result.db = new Database();
+        // Phases are reported on this thread and queued to the GUI thread, where they are
+        // dropped once this unlock is finished or canceled
+        QObject::connect(result.db, &Database::openPhaseStarted, qApp, [self, unlockId](const QString& phase) {
+            if (self && self->m_unlockId == unlockId) {
+                self->showUnlockPhase(phase);
+            }
+        });
+        result.ok = result.db->read(filename, key, &result.error);
+        result.db->moveDataToThread(guiThread);
+        return result;
+    });
+
+    // The watcher outlives this widget, so the result is freed even if the widget is gone
+    auto* watcher = new QFutureWatcher<ReadResult>();
+    connect(watcher, &QFutureWatcherBase::finished, watcher, [watcher, self, unlockId, key, blockQuickUnlock] {
+        watcher->deleteLater();
+        const auto result = watcher->result();
+        if (!self || self->m_unlockId != unlockId) {
+            delete result.db;
+            return;
+        }
+        self->finishOpenDatabase(result.db, result.ok, result.error, key, blockQuickUnlock);
+    });
+    watcher->setFuture(future);
+
+    m_ui->messageWidget->addAction(m_cancelUnlockAction);
+    m_ui->messageWidget->showMessage(
+        tr("Unlocking database…"), MessageWidget::Information, MessageWidget::DisableAutoHide);
+}
+
+/**
+ * Cancel the running unlock. The database read so far is discarded by readDatabase().
+ */
+void DatabaseOpenWidget::cancelUnlock()
+{
+    ++m_unlockId;
+    m_ui->messageWidget->removeAction(m_cancelUnlockAction);
+    m_ui->messageWidget->showMessage(tr("Database unlock canceled."), MessageWidget::MessageType::Error);
+    setUserInteractionLock(false);
+}
+
+/**
+ * Show the phase of the running unlock in the message widget.
+ *
+ * @param phase phase reported by Database::openPhaseStarted()
+ */
+void DatabaseOpenWidget::showUnlockPhase(const QString& phase)
+{
+    if (phase == PhaseTimings::Kdf) {
+        m_ui->messageWidget->setText(tr("Unlocking database: transforming key…"));
+    } else if (phase == PhaseTimings::Binaries) {
+        m_ui->messageWidget->setText(tr("Unlocking database: decrypting…"));
+    } else if (phase == PhaseTimings::Xml || phase == PhaseTimings::Model) {
+        m_ui->messageWidget->setText(tr("Unlocking database: loading entries…"));
+    }
+}
+
 void DatabaseOpenWidget::reject()
 {
+    // Discard a running unlock, its database must not be handed out after rejecting
+    ++m_unlockId;
+    m_ui->messageWidget->removeAction(m_cancelUnlockAction);
     emit dialogFinished(false);
 }
 
@@ -31,6 +31,7 @@
 
 class CompositeKey;
 class Database;
+class QAction;
 class QFile;
 
 namespace Ui
@@ -83,6 +84,15 @@ private slots:
     void hardwareKeyResponse(bool found);
 
 private:
+    void readDatabase(const QSharedPointer<const CompositeKey>& key, bool blockQuickUnlock);
+    void finishOpenDatabase(Database* db,
+                            bool ok,
+                            const QString& error,
+                            const QSharedPointer<const CompositeKey>& databaseKey,
+                            bool blockQuickUnlock);
+    void cancelUnlock();
+    void showUnlockPhase(const QString& phase);
+
 #ifdef WITH_XC_YUBIKEY
     QPointer<DeviceListener> m_deviceListener;
 #endif
@@ -92,6 +102,8 @@ private:
     bool m_unlockingDatabase = false;
     QTimer m_hideTimer;
     QTimer m_hideNoHardwareKeysFoundTimer;
+    QAction* m_cancelUnlockAction;
+    int m_unlockId = 0;
 
     Q_DISABLE_COPY(DatabaseOpenWidget)
 };
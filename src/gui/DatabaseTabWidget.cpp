@@ -293,7 +293,10 @@ DatabaseWidget* DatabaseTabWidget::importFile()
                 if (group) {
                     // Extract the root group from the import database
                     auto importGroup = db->setRootGroup(new Group());
+                    auto targetDb = dbWidget->database();
+                    targetDb->beginBatchUpdate();
                     importGroup->setParent(group);
+                    targetDb->endBatchUpdate();
                     setCurrentIndex(i);
                     return dbWidget;
                 }
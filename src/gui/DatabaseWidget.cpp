@@ -575,11 +575,13 @@ void DatabaseWidget::restoreSelectedEntries()
         selectedEntries.append(m_entryView->entryFromIndex(index));
     }
 
+    m_db->beginBatchUpdate();
     for (auto* entry : selectedEntries) {
         if (entry->previousParentGroup()) {
             entry->setGroup(entry->previousParentGroup());
         }
     }
+    m_db->endBatchUpdate();
 }
 
 void DatabaseWidget::deleteEntries(QList<Entry*> selectedEntries, bool confirm)
@@ -756,9 +758,11 @@ void DatabaseWidget::setTag(QAction* action)
 {
     auto tag = action->text();
     auto state = action->isChecked();
+    m_db->beginBatchUpdate();
     for (auto entry : m_entryView->selectedEntries()) {
         state ? entry->addTag(tag) : entry->removeTag(tag);
     }
+    m_db->endBatchUpdate();
 }
 
 void DatabaseWidget::showTotpKeyQrCode()
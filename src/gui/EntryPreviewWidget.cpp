@@ -413,7 +413,7 @@ void EntryPreviewWidget::updateEntryAdvancedTab()
     const EntryAttributes* attributes = m_currentEntry->attributes();
     const QStringList customAttributes = attributes->customKeys();
     const bool hasAttributes = !customAttributes.isEmpty();
-    const bool hasAttachments = !m_currentEntry->attachments()->isEmpty();
+    const bool hasAttachments = !asConst(*m_currentEntry).attachments()->isEmpty();
     m_ui->entryAttributesTable->setRowCount(customAttributes.size());
     m_ui->entryAttributesTable->setColumnCount(3);
 
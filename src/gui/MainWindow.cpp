@@ -706,13 +706,20 @@ MainWindow::~MainWindow()
 void MainWindow::restoreConfigState()
 {
     if (config()->get(Config::OpenPreviousDatabasesOnStartup).toBool()) {
+        // Open the unlock prompts of all databases up front. Each tab reads its database on a
+        // worker thread once unlocked, so the databases load concurrently and in any order.
         const QStringList fileNames = config()->get(Config::LastOpenedDatabases).toStringList();
+        QString lastRestoredFile;
         for (const QString& filename : fileNames) {
             if (!filename.isEmpty() && QFile::exists(filename)) {
-                openDatabase(filename);
+                m_ui->tabWidget->addDatabaseTab(filename, true);
+                lastRestoredFile = filename;
             }
         }
         auto lastActiveFile = config()->get(Config::LastActiveDatabase).toString();
+        if (lastActiveFile.isEmpty()) {
+            lastActiveFile = lastRestoredFile;
+        }
         if (!lastActiveFile.isEmpty()) {
             openDatabase(lastActiveFile);
         }
@@ -213,7 +213,7 @@ void DatabaseSettingsWidgetBrowser::removeStoredPermissions()
             return;
         }
 
-        if (entry->customData()->contains(BrowserService::KEEPASSXCBROWSER_NAME)) {
+        if (asConst(*entry).customData()->contains(BrowserService::KEEPASSXCBROWSER_NAME)) {
             entry->beginUpdate();
             entry->customData()->remove(BrowserService::KEEPASSXCBROWSER_NAME);
             entry->endUpdate();
@@ -26,6 +26,7 @@
 #include "core/Group.h"
 #include "core/Metadata.h"
 #include "core/PasswordHealth.h"
+#include "core/Tools.h"
 #include "gui/DatabaseIcons.h"
 #include "gui/Icons.h"
 #include "gui/styles/StateColorPalette.h"
@@ -62,30 +63,24 @@ void EntryModel::setGroup(Group* group)
         return;
     }
 
-    beginResetModel();
-
     severConnections();
 
     m_group = group;
     m_allGroups.clear();
-    m_entries = group->entries();
     m_orgEntries.clear();
+    updateEntries(group->entries());
 
     makeConnections(group);
-
-    endResetModel();
 }
 
 void EntryModel::setEntries(const QList<Entry*>& entries)
 {
-    beginResetModel();
-
     severConnections();
 
     m_group = nullptr;
     m_allGroups.clear();
-    m_entries = entries;
     m_orgEntries = entries;
+    updateEntries(entries);
 
     for (const auto entry : asConst(m_entries)) {
         if (entry->group()) {
@@ -96,8 +91,93 @@ void EntryModel::setEntries(const QList<Entry*>& entries)
     for (const auto group : m_allGroups) {
         makeConnections(group);
     }
+}
+
+/**
+ * Replace the displayed entries, emitting only the row removals and insertions
+ * needed to get from the current list to the new one. This keeps selection and
+ * sorting state in attached views, e.g. when a search is refreshed.
+ *
+ * @param entries new list of entries
+ */
+void EntryModel::updateEntries(const QList<Entry*>& entries)
+{
+    const auto oldEntries = Tools::asSet(m_entries);
+    const auto newEntries = Tools::asSet(entries);
+
+    // The entries kept must appear in the same relative order in both lists
+    int kept = 0;
+    int matched = 0;
+    for (const auto entry : m_entries) {
+        if (newEntries.contains(entry)) {
+            ++kept;
+        }
+    }
+    for (const auto entry : entries) {
+        if (matched < m_entries.size() && oldEntries.contains(entry)) {
+            while (matched < m_entries.size() && !newEntries.contains(m_entries.at(matched))) {
+                ++matched;
+            }
+            if (matched < m_entries.size() && m_entries.at(matched) != entry) {
+                kept = 0;
+                break;
+            }
+            ++matched;
+        }
+    }
+
+    // Count the contiguous runs of rows to remove and to insert
+    int runs = 0;
+    for (int row = 0; kept > 0 && row < m_entries.size(); ++row) {
+        if (!newEntries.contains(m_entries.at(row)) && (row == 0 || newEntries.contains(m_entries.at(row - 1)))) {
+            ++runs;
+        }
+    }
+    for (int row = 0; kept > 0 && row < entries.size(); ++row) {
+        if (!oldEntries.contains(entries.at(row)) && (row == 0 || oldEntries.contains(entries.at(row - 1)))) {
+            ++runs;
+        }
+    }
 
-    endResetModel();
+    // Without common entries in the same order, or when the changes are scattered over
+    // many runs (e.g. interleaved search results), a reset is cheaper than emitting every run
+    if (kept == 0 || runs > MaxUpdateRuns) {
+        beginResetModel();
+        m_entries = entries;
+        endResetModel();
+        return;
+    }
+
+    // Remove rows that are gone, bottom up in contiguous runs
+    for (int row = m_entries.size() - 1; row >= 0; --row) {
+        if (newEntries.contains(m_entries.at(row))) {
+            continue;
+        }
+        int last = row;
+        while (row > 0 && !newEntries.contains(m_entries.at(row - 1))) {
+            --row;
+        }
+        beginRemoveRows(QModelIndex(), row, last);
+        m_entries.erase(m_entries.begin() + row, m_entries.begin() + last + 1);
+        endRemoveRows();
+    }
+
+    // Insert the new rows, top down in contiguous runs
+    for (int row = 0; row < entries.size(); ++row) {
+        if (oldEntries.contains(entries.at(row))) {
+            continue;
+        }
+        int last = row;
+        while (last + 1 < entries.size() && !oldEntries.contains(entries.at(last + 1))) {
+            ++last;
+        }
+        beginInsertRows(QModelIndex(), row, last);
+        m_entries = m_entries.mid(0, row) + entries.mid(row, last - row + 1) + m_entries.mid(row);
+        endInsertRows();
+        row = last;
+    }
+
+    Q_ASSERT(m_entries == entries);
 }
 
 int EntryModel::rowCount(const QModelIndex& parent) const
@@ -203,7 +283,7 @@ QVariant EntryModel::data(const QModelIndex& index, int role) const
             return result;
         case Attachments: {
             // Display comma-separated list of attachments
-            QList<QString> attachments = entry->attachments()->keys();
+            QList<QString> attachments = asConst(*entry).attachments()->keys();
             for (const auto& attachment : attachments) {
                 if (result.isEmpty()) {
                     result.append(attachment);
@@ -266,7 +346,7 @@ QVariant EntryModel::data(const QModelIndex& index, int role) const
         case Paperclip:
             // Display entries with attachments above those without when
             // sorting ascendingly (and vice versa when sorting descendingly)
-            return !entry->attachments()->isEmpty();
+            return !asConst(*entry).attachments()->isEmpty();
         case Totp:
             return entry->hasTotp();
         case Size:
@@ -286,7 +366,7 @@ QVariant EntryModel::data(const QModelIndex& index, int role) const
         case Title:
             return Icons::entryIconPixmap(entry);
         case Paperclip:
-            if (!entry->attachments()->isEmpty()) {
+            if (!asConst(*entry).attachments()->isEmpty()) {
                 return icons()->icon("paperclip");
             }
             break;
@@ -505,13 +585,32 @@ QMimeData* EntryModel::mimeData(const QModelIndexList& indexes) const
     }
 }
 
+/**
+ * Row changes during a batch are reported as a single model reset when it ends.
+ *
+ * @return true if the change is part of the reset and must not be reported on its own
+ */
+bool EntryModel::deferRowChange()
+{
+    if (!m_batchUpdate) {
+        return false;
+    }
+    if (!m_batchReset) {
+        beginResetModel();
+        m_batchReset = true;
+    }
+    return true;
+}
+
 void EntryModel::entryAboutToAdd(Entry* entry)
 {
     if (!m_group && !m_orgEntries.contains(entry)) {
         return;
     }
 
-    beginInsertRows(QModelIndex(), m_entries.size(), m_entries.size());
+    if (!deferRowChange()) {
+        beginInsertRows(QModelIndex(), m_entries.size(), m_entries.size());
+    }
     if (!m_group) {
         m_entries.append(entry);
     }
@@ -526,12 +625,16 @@ void EntryModel::entryAdded(Entry* entry)
     if (m_group) {
         m_entries = m_group->entries();
     }
-    endInsertRows();
+    if (!m_batchReset) {
+        endInsertRows();
+    }
 }
 
 void EntryModel::entryAboutToRemove(Entry* entry)
 {
-    beginRemoveRows(QModelIndex(), m_entries.indexOf(entry), m_entries.indexOf(entry));
+    if (!deferRowChange()) {
+        beginRemoveRows(QModelIndex(), m_entries.indexOf(entry), m_entries.indexOf(entry));
+    }
     if (!m_group) {
         m_entries.removeAll(entry);
     }
@@ -542,12 +645,16 @@ void EntryModel::entryRemoved()
     if (m_group) {
         m_entries = m_group->entries();
     }
-    endRemoveRows();
+    if (!m_batchReset) {
+        endRemoveRows();
+    }
 }
 
 void EntryModel::entryAboutToMoveUp(int row)
 {
-    beginMoveRows(QModelIndex(), row, row, QModelIndex(), row - 1);
+    if (!deferRowChange()) {
+        beginMoveRows(QModelIndex(), row, row, QModelIndex(), row - 1);
+    }
     if (m_group) {
         m_entries.move(row, row - 1);
     }
@@ -558,12 +665,16 @@ void EntryModel::entryMovedUp()
     if (m_group) {
         m_entries = m_group->entries();
     }
-    endMoveRows();
+    if (!m_batchReset) {
+        endMoveRows();
+    }
 }
 
 void EntryModel::entryAboutToMoveDown(int row)
 {
-    beginMoveRows(QModelIndex(), row, row, QModelIndex(), row + 2);
+    if (!deferRowChange()) {
+        beginMoveRows(QModelIndex(), row, row, QModelIndex(), row + 2);
+    }
     if (m_group) {
         m_entries.move(row, row + 1);
     }
@@ -574,15 +685,59 @@ void EntryModel::entryMovedDown()
     if (m_group) {
         m_entries = m_group->entries();
     }
-    endMoveRows();
+    if (!m_batchReset) {
+        endMoveRows();
+    }
 }
 
 void EntryModel::entryDataChanged(Entry* entry)
 {
+    if (m_batchUpdate) {
+        m_batchChangedEntries.insert(entry);
+        return;
+    }
+
     int row = m_entries.indexOf(entry);
     emit dataChanged(index(row, 0), index(row, columnCount() - 1));
 }
 
+void EntryModel::batchUpdateStarted()
+{
+    m_batchUpdate = true;
+}
+
+void EntryModel::batchUpdateFinished()
+{
+    m_batchUpdate = false;
+    if (m_batchReset) {
+        // The reset covers the changed entries as well
+        m_batchReset = false;
+        m_batchChangedEntries.clear();
+        endResetModel();
+        return;
+    }
+    if (m_batchChangedEntries.isEmpty()) {
+        return;
+    }
+
+    // Report all entries changed during the batch as a single range
+    int firstRow = -1;
+    int lastRow = -1;
+    for (int row = 0; row < m_entries.size(); ++row) {
+        if (m_batchChangedEntries.contains(m_entries.at(row))) {
+            if (firstRow == -1) {
+                firstRow = row;
+            }
+            lastRow = row;
+        }
+    }
+    m_batchChangedEntries.clear();
+
+    if (firstRow != -1) {
+        emit dataChanged(index(firstRow, 0), index(lastRow, columnCount() - 1));
+    }
+}
+
 void EntryModel::onConfigChanged(Config::ConfigKey key)
 {
     switch (key) {
@@ -606,6 +761,20 @@ void EntryModel::severConnections()
     for (const Group* group : asConst(m_allGroups)) {
         disconnect(group, nullptr, this, nullptr);
     }
+
+    for (const auto& db : asConst(m_databases)) {
+        if (db) {
+            disconnect(db.data(), nullptr, this, nullptr);
+        }
+    }
+    m_databases.clear();
+
+    m_batchUpdate = false;
+    m_batchChangedEntries.clear();
+    if (m_batchReset) {
+        m_batchReset = false;
+        endResetModel();
+    }
 }
 
 void EntryModel::makeConnections(const Group* group)
@@ -619,6 +788,14 @@ void EntryModel::makeConnections(const Group* group)
     connect(group, SIGNAL(entryAboutToMoveDown(int)), SLOT(entryAboutToMoveDown(int)));
     connect(group, SIGNAL(entryMovedDown()), SLOT(entryMovedDown()));
     connect(group, SIGNAL(entryDataChanged(Entry*)), SLOT(entryDataChanged(Entry*)));
+
+    auto db = group->database();
+    if (db && !m_databases.contains(db)) {
+        m_databases.append(db);
+        connect(db, &Database::batchUpdateStarted, this, &EntryModel::batchUpdateStarted);
+        connect(db, &Database::batchUpdateFinished, this, &EntryModel::batchUpdateFinished);
+        m_batchUpdate = m_batchUpdate || db->isBatchUpdating();
+    }
 }
 void EntryModel::setBackgroundColorVisible(bool visible)
 {
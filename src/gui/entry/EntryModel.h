@@ -20,10 +20,12 @@
 
 #include <QAbstractTableModel>
 #include <QPixmap>
+#include <QPointer>
 #include <QSet>
 
 #include "core/Config.h"
 
+class Database;
 class Entry;
 class Group;
 
@@ -80,20 +82,30 @@ private slots:
     void entryAboutToMoveDown(int row);
     void entryMovedDown();
     void entryDataChanged(Entry* entry);
+    void batchUpdateStarted();
+    void batchUpdateFinished();
 
     void onConfigChanged(Config::ConfigKey key);
 
 private:
     void severConnections();
     void makeConnections(const Group* group);
+    void updateEntries(const QList<Entry*>& entries);
+    bool deferRowChange();
 
     bool m_backgroundColorVisible = true;
     Group* m_group;
     QList<Entry*> m_entries;
     QList<Entry*> m_orgEntries;
     QSet<const Group*> m_allGroups;
+    QList<QPointer<const Database>> m_databases;
+    bool m_batchUpdate = false;
+    bool m_batchReset = false;
+    QSet<const Entry*> m_batchChangedEntries;
 
     const QString HiddenContentDisplay;
+    // Above this many row runs, updateEntries() resets the model instead
+    static constexpr int MaxUpdateRuns = 32;
 };
 
 #endif // KEEPASSX_ENTRYMODEL_H
@@ -36,6 +36,11 @@ GroupModel::GroupModel(Database* db, QObject* parent)
 
 void GroupModel::changeDatabase(Database* newDb)
 {
+    if (m_batchReset) {
+        m_batchReset = false;
+        endResetModel();
+    }
+
     beginResetModel();
 
     m_db = newDb;
@@ -48,8 +53,13 @@ void GroupModel::changeDatabase(Database* newDb)
     connect(m_db, SIGNAL(groupRemoved()), SLOT(groupRemoved()));
     connect(m_db, SIGNAL(groupAboutToMove(Group*,Group*,int)), SLOT(groupAboutToMove(Group*,Group*,int)));
     connect(m_db, SIGNAL(groupMoved()), SLOT(groupMoved()));
+    connect(m_db, SIGNAL(batchUpdateStarted()), SLOT(batchUpdateStarted()));
+    connect(m_db, SIGNAL(batchUpdateFinished()), SLOT(batchUpdateFinished()));
     // clang-format on
 
+    m_batchUpdate = m_db && m_db->isBatchUpdating();
+    m_batchChangedGroups.clear();
+
     endResetModel();
 }
 
@@ -277,6 +287,9 @@ bool GroupModel::dropMimeData(const QMimeData* data,
             return false;
         }
 
+        // Moving many entries is reported to the models as a whole
+        auto targetDb = parentGroup->database();
+        targetDb->beginBatchUpdate();
         while (!stream.atEnd()) {
             QUuid dbUuid;
             QUuid entryUuid;
@@ -314,6 +327,7 @@ bool GroupModel::dropMimeData(const QMimeData* data,
 
             entry->setGroup(parentGroup);
         }
+        targetDb->endBatchUpdate();
     }
 
     return true;
@@ -364,13 +378,38 @@ QMimeData* GroupModel::mimeData(const QModelIndexList& indexes) const
 
 void GroupModel::groupDataChanged(Group* group)
 {
+    if (m_batchUpdate) {
+        m_batchChangedGroups.insert(group, group);
+        return;
+    }
+
     QModelIndex ix = index(group);
     emit dataChanged(ix, ix);
 }
 
+/**
+ * Row changes during a batch are reported as a single model reset when it ends.
+ *
+ * @return true if the change is part of the reset and must not be reported on its own
+ */
+bool GroupModel::deferRowChange()
+{
+    if (!m_batchUpdate) {
+        return false;
+    }
+    if (!m_batchReset) {
+        beginResetModel();
+        m_batchReset = true;
+    }
+    return true;
+}
+
 void GroupModel::groupAboutToRemove(Group* group)
 {
     Q_ASSERT(group->parentGroup());
+    if (deferRowChange()) {
+        return;
+    }
 
     QModelIndex parentIndex = parent(group);
     Q_ASSERT(parentIndex.isValid());
@@ -382,12 +421,17 @@ void GroupModel::groupAboutToRemove(Group* group)
 
 void GroupModel::groupRemoved()
 {
-    endRemoveRows();
+    if (!m_batchReset) {
+        endRemoveRows();
+    }
 }
 
 void GroupModel::groupAboutToAdd(Group* group, int index)
 {
     Q_ASSERT(group->parentGroup());
+    if (deferRowChange()) {
+        return;
+    }
 
     QModelIndex parentIndex = parent(group);
 
@@ -396,12 +440,17 @@ void GroupModel::groupAboutToAdd(Group* group, int index)
 
 void GroupModel::groupAdded()
 {
-    endInsertRows();
+    if (!m_batchReset) {
+        endInsertRows();
+    }
 }
 
 void GroupModel::groupAboutToMove(Group* group, Group* toGroup, int pos)
 {
     Q_ASSERT(group->parentGroup());
+    if (deferRowChange()) {
+        return;
+    }
 
     QModelIndex oldParentIndex = parent(group);
     QModelIndex newParentIndex = index(toGroup);
@@ -419,7 +468,36 @@ void GroupModel::groupAboutToMove(Group* group, Group* toGroup, int pos)
 
 void GroupModel::groupMoved()
 {
-    endMoveRows();
+    if (!m_batchReset) {
+        endMoveRows();
+    }
+}
+
+void GroupModel::batchUpdateStarted()
+{
+    m_batchUpdate = true;
+}
+
+void GroupModel::batchUpdateFinished()
+{
+    m_batchUpdate = false;
+    if (m_batchReset) {
+        // The reset covers the changed groups as well
+        m_batchReset = false;
+        m_batchChangedGroups.clear();
+        endResetModel();
+        return;
+    }
+
+    // Report each group changed during the batch once, skipping deleted ones
+    const auto changedGroups = m_batchChangedGroups;
+    m_batchChangedGroups.clear();
+    for (const auto& group : changedGroups) {
+        if (group && group->database() == m_db) {
+            QModelIndex ix = index(group);
+            emit dataChanged(ix, ix);
+        }
+    }
 }
 
 void GroupModel::sortChildren(Group* rootGroup, bool reverse)
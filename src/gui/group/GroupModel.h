@@ -19,6 +19,8 @@
 #define KEEPASSX_GROUPMODEL_H
 
 #include <QAbstractItemModel>
+#include <QHash>
+#include <QPointer>
 
 class Database;
 class Group;
@@ -50,6 +52,7 @@ public:
 private:
     QModelIndex parent(Group* group) const;
     void collectIndexesRecursively(QList<QModelIndex>& indexes, QList<Group*> groups);
+    bool deferRowChange();
 
 private slots:
     void groupDataChanged(Group* group);
@@ -59,9 +62,14 @@ private slots:
     void groupAdded();
     void groupAboutToMove(Group* group, Group* toGroup, int pos);
     void groupMoved();
+    void batchUpdateStarted();
+    void batchUpdateFinished();
 
 private:
     Database* m_db;
+    bool m_batchUpdate = false;
+    bool m_batchReset = false;
+    QHash<const Group*, QPointer<Group>> m_batchChangedGroups;
 };
 
 #endif // KEEPASSX_GROUPMODEL_H
@@ -19,7 +19,6 @@
 #include "ui_ReportsWidgetBrowserStatistics.h"
 
 #include "browser/BrowserService.h"
-#include "core/AsyncTask.h"
 #include "core/Group.h"
 #include "core/Metadata.h"
 #include "gui/GuiTools.h"
@@ -83,8 +82,9 @@ BrowserStatistics::BrowserStatistics(QSharedPointer<Database> db)
                 continue;
             }
 
-            auto hasUrls = !entry->getAllUrls().isEmpty();
-            auto hasSettings = entry->customData()->contains(BrowserService::KEEPASSXCBROWSER_NAME);
+            // Placeholders are only resolved for the rows that are displayed
+            auto hasUrls = entry->hasUrls();
+            auto hasSettings = asConst(*entry).customData()->contains(BrowserService::KEEPASSXCBROWSER_NAME);
 
             const auto item = QSharedPointer<Item>(new Item(group, entry, hasUrls, hasSettings));
             m_items.append(item);
@@ -195,9 +195,8 @@ void ReportsWidgetBrowserStatistics::calculateBrowserStatistics()
 {
     m_referencesModel->clear();
 
-    // Perform the statistics check
-    const QScopedPointer<BrowserStatistics> browserStatistics(
-        AsyncTask::runAndWaitForFuture([this] { return new BrowserStatistics(m_db); }));
+    // Perform the statistics check, this only reads plain entry data and is fast enough for the GUI thread
+    const QScopedPointer<BrowserStatistics> browserStatistics(new BrowserStatistics(m_db));
 
     const auto showExpired = m_ui->showExpired->isChecked();
     const auto showEntriesWithUrlOnly = m_ui->showEntriesWithUrlOnlyCheckBox->isChecked();
@@ -218,7 +217,7 @@ void ReportsWidgetBrowserStatistics::calculateBrowserStatistics()
 
         // Exclude this entry if it doesn't have any Browser Integration settings
         if (showOnlyEntriesWithSettings
-            && !item->entry->customData()->contains(BrowserService::KEEPASSXCBROWSER_NAME)) {
+            && !asConst(*item->entry).customData()->contains(BrowserService::KEEPASSXCBROWSER_NAME)) {
             continue;
         }
 
@@ -341,7 +340,7 @@ QMap<QString, QStringList> ReportsWidgetBrowserStatistics::getBrowserConfigFromE
 {
     QMap<QString, QStringList> configList;
 
-    auto config = entry->customData()->value(BrowserService::KEEPASSXCBROWSER_NAME);
+    auto config = asConst(*entry).customData()->value(BrowserService::KEEPASSXCBROWSER_NAME);
     if (!config.isEmpty()) {
         QJsonDocument doc = QJsonDocument::fromJson(config.toUtf8());
         if (!doc.isNull()) {
@@ -19,6 +19,7 @@
 #include "ui_ReportsWidgetHibp.h"
 
 #include "config-keepassx.h"
+#include "core/Config.h"
 #include "core/Group.h"
 #include "core/Metadata.h"
 #include "gui/GuiTools.h"
@@ -52,6 +53,15 @@ namespace
             return QSortFilterProxyModel::lessThan(left, right);
         }
     };
+
+#ifdef WITH_XC_NETWORKING
+    // Range responses are only kept on disk if enabled, they tell which passwords were checked
+    void configureCache(HibpDownloader& downloader)
+    {
+        const bool enabled = config()->get(Config::Security_HibpCache).toBool();
+        downloader.setCacheDirectory(enabled ? HibpDownloader::defaultCacheDirectory() : QString());
+    }
+#endif
 } // namespace
 
 ReportsWidgetHibp::ReportsWidgetHibp(QWidget* parent)
@@ -270,6 +280,7 @@ void ReportsWidgetHibp::startValidation()
     m_ui->progressBar->setMaximum(m_downloader.passwordsToValidate());
     m_ui->validationButton->setEnabled(false);
 
+    configureCache(m_downloader);
     m_downloader.validate();
 #endif
 }
@@ -347,6 +358,7 @@ void ReportsWidgetHibp::refreshAfterEdit()
     // Validate the new password against HIBP
 #ifdef WITH_XC_NETWORKING
     m_downloader.add(m_editedEntry->password());
+    configureCache(m_downloader);
     m_downloader.validate();
 #endif
 
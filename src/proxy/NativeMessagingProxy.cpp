@@ -17,11 +17,13 @@
 
 #include "NativeMessagingProxy.h"
 #include "browser/BrowserShared.h"
+#include "core/Global.h"
 
 #include <QCoreApplication>
-#include <QFuture>
 #include <QtConcurrent/qtconcurrentrun.h>
 
+#include <cctype>
+#include <cstdio>
 #include <iostream>
 
 #ifdef Q_OS_WIN
@@ -57,41 +59,50 @@ void NativeMessagingProxy::setupStandardInput()
 #endif
 #endif
 
+    // Standard input cannot be watched by the event loop on every platform, so it is read
+    // on a separate thread that blocks until the next message frame has arrived completely
     QtConcurrent::run([this] {
-        while (std::cin.good()) {
-            if (std::cin.peek() != EOF) {
-                uint length = 0;
-                for (uint i = 0; i < sizeof(uint); ++i) {
-                    length |= getchar() << (i * 8);
-                }
-
-                QString msg;
-                msg.reserve(length);
-                for (uint i = 0; i < length; ++i) {
-                    msg.append(getchar());
-                }
-
-                if (msg.length() > 0) {
-                    emit stdinMessage(msg);
-                }
+        quint32 length = 0;
+        while (std::fread(&length, sizeof(length), 1, stdin) == 1) {
+            if (length == 0) {
+                continue;
             }
-            QThread::msleep(100);
+            if (length > static_cast<quint32>(BrowserShared::NATIVEMSG_MAX_LENGTH)) {
+                qWarning("Invalid native message length %u", length);
+                break;
+            }
+
+            QByteArray msg(static_cast<int>(length), Qt::Uninitialized);
+            if (std::fread(msg.data(), 1, length, stdin) != length) {
+                break;
+            }
+            emit stdinMessage(msg);
         }
-        QCoreApplication::quit();
+        QMetaObject::invokeMethod(QCoreApplication::instance(), "quit", Qt::QueuedConnection);
     });
 }
 
-void NativeMessagingProxy::transferStdinMessage(const QString& msg)
+void NativeMessagingProxy::transferStdinMessage(const QByteArray& msg)
 {
-    if (m_localSocket && m_localSocket->state() == QLocalSocket::ConnectedState) {
-        m_localSocket->write(msg.toUtf8(), msg.length());
+    if (!m_localSocket) {
+        return;
+    }
+
+    if (m_localSocket->state() == QLocalSocket::ConnectedState) {
+        m_localSocket->write(msg);
         m_localSocket->flush();
+    } else if (m_localSocket->state() == QLocalSocket::ConnectingState) {
+        m_pendingMessages.append(msg);
     }
 }
 
 void NativeMessagingProxy::setupLocalSocket()
 {
     m_localSocket.reset(new QLocalSocket());
+    connect(m_localSocket.data(), SIGNAL(connected()), this, SLOT(socketConnected()));
+    connect(m_localSocket.data(), SIGNAL(readyRead()), this, SLOT(transferSocketMessage()));
+    connect(m_localSocket.data(), SIGNAL(disconnected()), this, SLOT(socketDisconnected()));
+
     m_localSocket->connectToServer(BrowserShared::localServerPath());
     m_localSocket->setReadBufferSize(BrowserShared::NATIVEMSG_MAX_LENGTH);
     int socketDesc = m_localSocket->socketDescriptor();
@@ -99,22 +110,48 @@ void NativeMessagingProxy::setupLocalSocket()
         int max = BrowserShared::NATIVEMSG_MAX_LENGTH;
         setsockopt(socketDesc, SOL_SOCKET, SO_SNDBUF, reinterpret_cast<char*>(&max), sizeof(max));
     }
+}
 
-    connect(m_localSocket.data(), SIGNAL(readyRead()), this, SLOT(transferSocketMessage()));
-    connect(m_localSocket.data(), SIGNAL(disconnected()), this, SLOT(socketDisconnected()));
+void NativeMessagingProxy::socketConnected()
+{
+    for (const auto& msg : asConst(m_pendingMessages)) {
+        m_localSocket->write(msg);
+    }
+    m_pendingMessages.clear();
+    m_localSocket->flush();
 }
 
 void NativeMessagingProxy::transferSocketMessage()
 {
-    auto msg = m_localSocket->readAll();
-    if (!msg.isEmpty()) {
-        // Explicitly write the message length as 1 byte chunks
-        uint len = msg.size();
-        std::cout.write(reinterpret_cast<char*>(&len), sizeof(len));
-
-        // Write the message and flush the stream
-        std::cout << msg.toStdString() << std::flush;
+    m_socketBuffer.append(m_localSocket->readAll());
+
+    // Forward every complete message on its own, replies may arrive back-to-back
+    int offset = 0;
+    int length = 0;
+    while ((length = BrowserShared::jsonMessageLength(m_socketBuffer, offset)) > 0) {
+        writeStdoutMessage(m_socketBuffer.constData() + offset, length);
+        offset += length;
+    }
+
+    // Skip whitespace between messages and pass on anything that never completes as is
+    while (offset < m_socketBuffer.size() && std::isspace(static_cast<uchar>(m_socketBuffer.at(offset)))) {
+        ++offset;
     }
+    if (m_socketBuffer.size() - offset > BrowserShared::NATIVEMSG_MAX_LENGTH) {
+        writeStdoutMessage(m_socketBuffer.constData() + offset, m_socketBuffer.size() - offset);
+        offset = m_socketBuffer.size();
+    }
+    m_socketBuffer.remove(0, offset);
+
+    std::cout.flush();
+}
+
+void NativeMessagingProxy::writeStdoutMessage(const char* data, int length)
+{
+    // Native messaging frames start with the message length in native byte order
+    quint32 len = static_cast<quint32>(length);
+    std::cout.write(reinterpret_cast<char*>(&len), sizeof(len));
+    std::cout.write(data, length);
 }
 
 void NativeMessagingProxy::socketDisconnected()
@@ -19,6 +19,7 @@
 #define NATIVEMESSAGINGPROXY_H
 
 #include <QLocalSocket>
+#include <QList>
 
 class QWinEventNotifier;
 class QSocketNotifier;
@@ -31,19 +32,23 @@ public:
     ~NativeMessagingProxy() override = default;
 
 signals:
-    void stdinMessage(QString msg);
+    void stdinMessage(const QByteArray& msg);
 
 public slots:
     void transferSocketMessage();
-    void transferStdinMessage(const QString& msg);
+    void transferStdinMessage(const QByteArray& msg);
+    void socketConnected();
     void socketDisconnected();
 
 private:
     void setupStandardInput();
     void setupLocalSocket();
+    void writeStdoutMessage(const char* data, int length);
 
 private:
     QScopedPointer<QLocalSocket> m_localSocket;
+    QByteArray m_socketBuffer;
+    QList<QByteArray> m_pendingMessages;
 
     Q_DISABLE_COPY(NativeMessagingProxy)
 };
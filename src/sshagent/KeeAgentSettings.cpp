@@ -370,7 +370,7 @@ bool KeeAgentSettings::fromEntry(const Entry* entry)
 void KeeAgentSettings::toEntry(Entry* entry) const
 {
     if (isDefault()) {
-        if (entry->attachments()->hasKey("KeeAgent.settings")) {
+        if (asConst(*entry).attachments()->hasKey("KeeAgent.settings")) {
             entry->attachments()->remove("KeeAgent.settings");
         }
     } else {
@@ -27,6 +27,7 @@
 #include <QFileInfo>
 #include <QLocalSocket>
 #include <QThread>
+#include <QtConcurrent>
 
 #ifdef Q_OS_WIN
 #include <QtEndian>
@@ -172,7 +173,50 @@ bool SSHAgent::sendMessage(const QByteArray& in, QByteArray& out)
 #endif
 }
 
+bool SSHAgent::sendMessages(const QList<QByteArray>& in, QList<QByteArray>& out)
+{
+#ifdef Q_OS_WIN
+    if (usePageant()) {
+        out.clear();
+        for (const auto& message : in) {
+            QByteArray response;
+            if (!sendMessagePageant(message, response)) {
+                return false;
+            }
+            out.append(response);
+        }
+    }
+    if (useOpenSSH() && !sendMessagesOpenSSH(in, out)) {
+        return false;
+    }
+    return true;
+#else
+    return sendMessagesOpenSSH(in, out);
+#endif
+}
+
 bool SSHAgent::sendMessageOpenSSH(const QByteArray& in, QByteArray& out)
+{
+    QList<QByteArray> responses;
+    if (!sendMessagesOpenSSH({in}, responses)) {
+        return false;
+    }
+
+    out = responses.first();
+    return true;
+}
+
+/**
+ * Send a batch of messages over a single agent connection.
+ *
+ * All requests are written before reading any response,
+ * the agent answers them in the order they were sent.
+ *
+ * @param in requests to send
+ * @param out responses, one per request
+ * @return true on success
+ */
+bool SSHAgent::sendMessagesOpenSSH(const QList<QByteArray>& in, QList<QByteArray>& out)
 {
     QLocalSocket socket;
     BinaryStream stream(&socket);
@@ -183,12 +227,19 @@ bool SSHAgent::sendMessageOpenSSH(const QByteArray& in, QByteArray& out)
         return false;
     }
 
-    stream.writeString(in);
+    for (const auto& message : in) {
+        stream.writeString(message);
+    }
     stream.flush();
 
-    if (!stream.readString(out)) {
-        m_error = tr("Agent protocol error.");
-        return false;
+    out.clear();
+    for (int i = 0; i < in.size(); ++i) {
+        QByteArray response;
+        if (!stream.readString(response)) {
+            m_error = tr("Agent protocol error.");
+            return false;
+        }
+        out.append(response);
     }
 
     socket.close();
@@ -280,6 +331,16 @@ bool SSHAgent::addIdentity(OpenSSHKey& key, const KeeAgentSettings& settings, co
         return false;
     }
 
+    QByteArray responseData;
+    if (!sendMessage(addIdentityRequest(key, settings), responseData)) {
+        return false;
+    }
+
+    return addIdentityResponse(key, settings, databaseUuid, responseData);
+}
+
+QByteArray SSHAgent::addIdentityRequest(OpenSSHKey& key, const KeeAgentSettings& settings)
+{
     QByteArray requestData;
     BinaryStream request(&requestData);
     bool isSecurityKey = key.type().startsWith("sk-");
@@ -305,11 +366,14 @@ bool SSHAgent::addIdentity(OpenSSHKey& key, const KeeAgentSettings& settings, co
         request.writeString(securityKeyProvider());
     }
 
-    QByteArray responseData;
-    if (!sendMessage(requestData, responseData)) {
-        return false;
-    }
+    return requestData;
+}
 
+bool SSHAgent::addIdentityResponse(const OpenSSHKey& key,
+                                   const KeeAgentSettings& settings,
+                                   const QUuid& databaseUuid,
+                                   const QByteArray& responseData)
+{
     if (responseData.length() < 1 || static_cast<quint8>(responseData[0]) != SSH_AGENT_SUCCESS) {
         m_error =
             tr("Agent refused this identity. Possible reasons include:") + "\n" + tr("The key has already been added.");
@@ -322,7 +386,7 @@ bool SSHAgent::addIdentity(OpenSSHKey& key, const KeeAgentSettings& settings, co
             m_error += "\n" + tr("A confirmation request is not supported by the agent (check options).");
         }
 
-        if (isSecurityKey) {
+        if (key.type().startsWith("sk-")) {
             m_error +=
                 "\n" + tr("Security keys are not supported by the agent or the security key provider is unavailable.");
         }
@@ -514,30 +578,91 @@ void SSHAgent::databaseUnlocked(const QSharedPointer<Database>& db)
         return;
     }
 
+    struct PendingIdentity
+    {
+        KeeAgentSettings settings;
+        QString username;
+        QString password;
+        const EntryAttachments* attachments;
+        QSharedPointer<OpenSSHKey> key;
+    };
+
+    QList<PendingIdentity> pending;
     for (auto entry : db->rootGroup()->entriesRecursive()) {
         if (entry->isRecycled()) {
             continue;
         }
 
-        KeeAgentSettings settings;
+        PendingIdentity identity;
 
-        if (!settings.fromEntry(entry)) {
+        if (!identity.settings.fromEntry(entry)) {
             continue;
         }
 
-        if (!settings.allowUseOfSshKey() || !settings.addAtDatabaseOpen()) {
+        if (!identity.settings.allowUseOfSshKey() || !identity.settings.addAtDatabaseOpen()) {
             continue;
         }
 
-        OpenSSHKey key;
+        identity.username = entry->username();
+        identity.password = entry->password();
+        identity.attachments = asConst(*entry).attachments();
+        identity.key.reset(new OpenSSHKey());
+        pending.append(identity);
+    }
+
+    if (pending.isEmpty()) {
+        return;
+    }
+
+    // Decrypting keys may run an expensive KDF, spread them across all cores.
+    // The GUI thread is blocked without processing events, so the entries can not change meanwhile.
+    const auto databasePath = db->filePath();
+    QtConcurrent::blockingMap(pending, [&databasePath](PendingIdentity& identity) {
+        if (!identity.settings.toOpenSSHKey(
+                identity.username, identity.password, databasePath, identity.attachments, *identity.key, true)) {
+            identity.key.reset();
+        }
+    });
+
+    QList<QByteArray> requests;
+    QList<const PendingIdentity*> requested;
+    for (const auto& identity : asConst(pending)) {
+        if (!identity.key) {
+            continue;
+        }
 
-        if (!settings.toOpenSSHKey(entry, key, true)) {
+        // Ignore keys owned by another database, like addIdentity does for previously added keys
+        if (m_addedKeys.contains(*identity.key) && m_addedKeys[*identity.key].first != db->uuid()) {
             continue;
         }
 
+        requests.append(addIdentityRequest(*identity.key, identity.settings));
+        requested.append(&identity);
+    }
+
+    if (requests.isEmpty()) {
+        return;
+    }
+
+    if (!isAgentRunning()) {
+        m_error = tr("No agent running, cannot add identity.");
+        emit error(m_error);
+        return;
+    }
+
+    // Pipeline all identities over a single agent connection
+    QList<QByteArray> responses;
+    if (!sendMessages(requests, responses)) {
+        emit error(m_error);
+        return;
+    }
+
+    for (int i = 0; i < requested.size(); ++i) {
+        const auto identity = requested.at(i);
+
         // Add key to agent; ignore errors if we have previously added the key
-        bool known_key = m_addedKeys.contains(key);
-        if (!addIdentity(key, settings, db->uuid()) && !known_key) {
+        bool known_key = m_addedKeys.contains(*identity->key);
+        if (!addIdentityResponse(*identity->key, identity->settings, db->uuid(), responses.at(i)) && !known_key) {
             emit error(m_error);
         }
     }
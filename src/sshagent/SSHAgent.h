@@ -80,7 +80,9 @@ private:
     const quint8 SSH_AGENT_CONSTRAIN_EXTENSION = 255;
 
     bool sendMessage(const QByteArray& in, QByteArray& out);
+    bool sendMessages(const QList<QByteArray>& in, QList<QByteArray>& out);
     bool sendMessageOpenSSH(const QByteArray& in, QByteArray& out);
+    bool sendMessagesOpenSSH(const QList<QByteArray>& in, QList<QByteArray>& out);
 #ifdef Q_OS_WIN
     bool sendMessagePageant(const QByteArray& in, QByteArray& out);
 
@@ -88,6 +90,12 @@ private:
     const quint32 AGENT_COPYDATA_ID = 0x804e50ba;
 #endif
 
+    QByteArray addIdentityRequest(OpenSSHKey& key, const KeeAgentSettings& settings);
+    bool addIdentityResponse(const OpenSSHKey& key,
+                             const KeeAgentSettings& settings,
+                             const QUuid& databaseUuid,
+                             const QByteArray& responseData);
+
     QHash<OpenSSHKey, QPair<QUuid, bool>> m_addedKeys;
     QString m_error;
 };
@@ -17,11 +17,19 @@
 
 #include "SymmetricCipherStream.h"
 
+namespace
+{
+    // Data is processed in chunks of this size to keep the number of cipher calls low,
+    // it has to be a multiple of the block size of all supported ciphers
+    constexpr int ChunkSize = 64 * 1024;
+} // namespace
+
 SymmetricCipherStream::SymmetricCipherStream(QIODevice* baseDevice)
     : LayeredStream(baseDevice)
     , m_cipher(new SymmetricCipher())
     , m_bufferPos(0)
-    , m_bufferFilling(false)
+    , m_bufferEnd(0)
+    , m_eof(false)
     , m_error(false)
     , m_isInitialized(false)
     , m_dataWritten(false)
@@ -52,7 +60,8 @@ void SymmetricCipherStream::resetInternalState()
 {
     m_buffer.clear();
     m_bufferPos = 0;
-    m_bufferFilling = false;
+    m_bufferEnd = 0;
+    m_eof = false;
     m_error = false;
     m_dataWritten = false;
     m_cipher->reset();
@@ -99,7 +108,7 @@ qint64 SymmetricCipherStream::readData(char* data, qint64 maxSize)
     qint64 offset = 0;
 
     while (bytesRemaining > 0) {
-        if ((m_bufferPos == m_buffer.size()) || m_bufferFilling) {
+        if (m_bufferPos == m_bufferEnd) {
             if (!readBlock()) {
                 if (m_error) {
                     return -1;
@@ -109,7 +118,7 @@ qint64 SymmetricCipherStream::readData(char* data, qint64 maxSize)
             }
         }
 
-        int bytesToCopy = qMin(bytesRemaining, static_cast<qint64>(m_buffer.size() - m_bufferPos));
+        int bytesToCopy = qMin(bytesRemaining, static_cast<qint64>(m_bufferEnd - m_bufferPos));
 
         memcpy(data + offset, m_buffer.constData() + m_bufferPos, bytesToCopy);
 
@@ -121,49 +130,77 @@ qint64 SymmetricCipherStream::readData(char* data, qint64 maxSize)
     return maxSize;
 }
 
+/**
+ * Read and decrypt the next chunk from the base device.
+ *
+ * The buffer holds the decrypted data up to m_bufferEnd, followed by the last block
+ * of ciphertext. Block ciphers hold it back until the end of the base device is known,
+ * as the final block has to be finished including its padding.
+ *
+ * @return true if new data is available
+ */
 bool SymmetricCipherStream::readBlock()
 {
-    QByteArray newData;
-
-    if (m_bufferFilling) {
-        newData.resize(blockSize() - m_buffer.size());
-    } else {
-        m_buffer.clear();
-        newData.resize(blockSize());
+    if (m_eof) {
+        return false;
     }
 
-    int readResult = m_baseDevice->read(newData.data(), newData.size());
+    // Move the held back ciphertext to the front and fill up the rest of the chunk
+    int size = m_buffer.size() - m_bufferEnd;
+    if (size > 0 && m_bufferEnd > 0) {
+        memmove(m_buffer.data(), m_buffer.constData() + m_bufferEnd, size);
+    }
+    m_buffer.reserve(ChunkSize);
+    m_buffer.resize(ChunkSize);
+    m_bufferPos = 0;
+    m_bufferEnd = 0;
 
-    if (readResult == -1) {
-        m_error = true;
-        setErrorString(m_baseDevice->errorString());
-        return false;
-    } else {
-        m_buffer.append(newData.left(readResult));
+    bool atEnd = false;
+    while (size < ChunkSize) {
+        qint64 readResult = m_baseDevice->read(m_buffer.data() + size, ChunkSize - size);
+        if (readResult == -1) {
+            m_error = true;
+            setErrorString(m_baseDevice->errorString());
+            return false;
+        } else if (readResult == 0) {
+            atEnd = true;
+            break;
+        }
+        size += static_cast<int>(readResult);
     }
+    atEnd = atEnd || m_baseDevice->atEnd();
+    m_buffer.resize(size);
 
-    if (!m_streamCipher && m_buffer.size() != blockSize()) {
-        m_bufferFilling = true;
-        return false;
+    if (m_streamCipher) {
+        m_eof = atEnd;
+        m_bufferEnd = size;
+        if (size > 0 && !m_cipher->process(m_buffer.data(), size)) {
+            m_error = true;
+            setErrorString(m_cipher->errorString());
+            return false;
+        }
+    } else if (atEnd) {
+        m_eof = true;
+        if (size == 0) {
+            return false;
+        }
+        if (!m_cipher->finish(m_buffer)) {
+            m_error = true;
+            setErrorString(m_cipher->errorString());
+            return false;
+        }
+        m_bufferEnd = m_buffer.size();
     } else {
-        m_bufferPos = 0;
-        m_bufferFilling = false;
-
-        if (!m_streamCipher && m_baseDevice->atEnd()) {
-            if (!m_cipher->finish(m_buffer)) {
-                m_error = true;
-                setErrorString(m_cipher->errorString());
-                return false;
-            }
-        } else if (m_buffer.size() > 0) {
-            if (!m_cipher->process(m_buffer)) {
-                m_error = true;
-                setErrorString(m_cipher->errorString());
-                return false;
-            }
+        // The chunk is full, so it consists of whole blocks
+        m_bufferEnd = size - blockSize();
+        if (!m_cipher->process(m_buffer.data(), m_bufferEnd)) {
+            m_error = true;
+            setErrorString(m_cipher->errorString());
+            return false;
         }
-        return m_buffer.size() > 0;
     }
+
+    return m_bufferEnd > 0;
 }
 
 qint64 SymmetricCipherStream::writeData(const char* data, qint64 maxSize)
@@ -174,19 +211,23 @@ qint64 SymmetricCipherStream::writeData(const char* data, qint64 maxSize)
         return -1;
     }
 
-    m_dataWritten = true;
+    if (!m_dataWritten) {
+        m_buffer.reserve(ChunkSize);
+        m_dataWritten = true;
+    }
+
     qint64 bytesRemaining = maxSize;
     qint64 offset = 0;
 
     while (bytesRemaining > 0) {
-        int bytesToCopy = qMin(bytesRemaining, static_cast<qint64>(blockSize() - m_buffer.size()));
+        int bytesToCopy = qMin(bytesRemaining, static_cast<qint64>(ChunkSize - m_buffer.size()));
 
         m_buffer.append(data + offset, bytesToCopy);
 
         offset += bytesToCopy;
         bytesRemaining -= bytesToCopy;
 
-        if (m_buffer.size() == blockSize()) {
+        if (m_buffer.size() == ChunkSize) {
             if (!writeBlock(false)) {
                 if (m_error) {
                     return -1;
@@ -200,18 +241,23 @@ qint64 SymmetricCipherStream::writeData(const char* data, qint64 maxSize)
     return maxSize;
 }
 
+/**
+ * Encrypt the buffered data in place and write it to the base device.
+ *
+ * @param lastBlock finish the cipher, adding the padding for block ciphers
+ * @return true on success
+ */
 bool SymmetricCipherStream::writeBlock(bool lastBlock)
 {
-    Q_ASSERT(m_streamCipher || lastBlock || (m_buffer.size() == blockSize()));
+    Q_ASSERT(lastBlock || (m_buffer.size() == ChunkSize));
 
     if (lastBlock && !m_streamCipher) {
-        QByteArray end;
         if (!m_cipher->finish(m_buffer)) {
             m_error = true;
             setErrorString(m_cipher->errorString());
             return false;
         }
-    } else if (!m_cipher->process(m_buffer)) {
+    } else if (!m_buffer.isEmpty() && !m_cipher->process(m_buffer)) {
         m_error = true;
         setErrorString(m_cipher->errorString());
         return false;
@@ -222,15 +268,13 @@ bool SymmetricCipherStream::writeBlock(bool lastBlock)
         setErrorString(m_baseDevice->errorString());
         return false;
     } else {
-        m_buffer.clear();
+        // Keep the allocated capacity for the next chunk
+        m_buffer.resize(0);
         return true;
     }
 }
 
 int SymmetricCipherStream::blockSize() const
 {
-    if (m_streamCipher) {
-        return 1024;
-    }
     return m_cipher->blockSize(m_cipher->mode());
 }
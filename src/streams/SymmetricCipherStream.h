@@ -50,7 +50,8 @@ private:
     const QScopedPointer<SymmetricCipher> m_cipher;
     QByteArray m_buffer;
     int m_bufferPos;
-    bool m_bufferFilling;
+    int m_bufferEnd;
+    bool m_eof;
     bool m_error;
     bool m_isInitialized;
     bool m_dataWritten;
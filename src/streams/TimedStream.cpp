@@ -0,0 +1,80 @@
+/*
+ *  Copyright (C) 2024 KeePassXC Team <team@keepassxc.org>
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 2 or (at your option)
+ *  version 3 of the License.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "TimedStream.h"
+
+#include <QElapsedTimer>
+
+TimedStream::TimedStream(QIODevice* baseDevice)
+    : LayeredStream(baseDevice)
+{
+}
+
+bool TimedStream::atEnd() const
+{
+    return m_baseDevice->atEnd();
+}
+
+qint64 TimedStream::bytesAvailable() const
+{
+    return LayeredStream::bytesAvailable() + m_baseDevice->bytesAvailable();
+}
+
+/**
+ * @return time spent in the base device in nanoseconds
+ */
+qint64 TimedStream::elapsed() const
+{
+    return m_elapsed;
+}
+
+/**
+ * Account time spent in the base device outside of read and write calls,
+ * e.g. when flushing it.
+ *
+ * @param nsecs time in nanoseconds
+ */
+void TimedStream::addElapsed(qint64 nsecs)
+{
+    m_elapsed += nsecs;
+}
+
+qint64 TimedStream::readData(char* data, qint64 maxSize)
+{
+    QElapsedTimer timer;
+    timer.start();
+    qint64 bytesRead = LayeredStream::readData(data, maxSize);
+    m_elapsed += timer.nsecsElapsed();
+
+    if (bytesRead == -1) {
+        setErrorString(m_baseDevice->errorString());
+    }
+    return bytesRead;
+}
+
+qint64 TimedStream::writeData(const char* data, qint64 maxSize)
+{
+    QElapsedTimer timer;
+    timer.start();
+    qint64 bytesWritten = LayeredStream::writeData(data, maxSize);
+    m_elapsed += timer.nsecsElapsed();
+
+    if (bytesWritten == -1) {
+        setErrorString(m_baseDevice->errorString());
+    }
+    return bytesWritten;
+}
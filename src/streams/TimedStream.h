@@ -0,0 +1,48 @@
+/*
+ *  Copyright (C) 2024 KeePassXC Team <team@keepassxc.org>
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 2 or (at your option)
+ *  version 3 of the License.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef KEEPASSXC_TIMEDSTREAM_H
+#define KEEPASSXC_TIMEDSTREAM_H
+
+#include "streams/LayeredStream.h"
+
+/**
+ * Pass-through stream that measures the time spent reading from
+ * or writing to the base device, including all layers below it.
+ */
+class TimedStream : public LayeredStream
+{
+    Q_OBJECT
+
+public:
+    explicit TimedStream(QIODevice* baseDevice);
+
+    bool atEnd() const override;
+    qint64 bytesAvailable() const override;
+
+    qint64 elapsed() const;
+    void addElapsed(qint64 nsecs);
+
+protected:
+    qint64 readData(char* data, qint64 maxSize) override;
+    qint64 writeData(const char* data, qint64 maxSize) override;
+
+private:
+    qint64 m_elapsed = 0;
+};
+
+#endif // KEEPASSXC_TIMEDSTREAM_H
@@ -17,13 +17,17 @@
 
 #include "TestBrowser.h"
 
+#include "browser/BrowserHost.h"
 #include "browser/BrowserMessageBuilder.h"
 #include "browser/BrowserSettings.h"
+#include "browser/BrowserShared.h"
 #include "core/Group.h"
 #include "core/Tools.h"
 #include "crypto/Crypto.h"
 
 #include <QJsonObject>
+#include <QLocalSocket>
+#include <QTemporaryDir>
 #include <QTest>
 
 #include <botan/sodium.h>
@@ -740,3 +744,59 @@ void TestBrowser::testRestrictBrowserKey()
     QCOMPARE(sorted[2]->url(), QString("https://example.com/2"));
     QCOMPARE(sorted[3]->url(), QString("https://example.com/0"));
 }
+
+void TestBrowser::testHostMessageFraming()
+{
+#ifdef Q_OS_WIN
+    QSKIP("The browser socket location cannot be redirected on Windows.");
+#endif
+    QTemporaryDir runtimeDir;
+    QVERIFY(runtimeDir.isValid());
+    const auto oldRuntimeDir = qgetenv("XDG_RUNTIME_DIR");
+    const auto oldTempDir = qgetenv("TMPDIR");
+    qputenv("XDG_RUNTIME_DIR", runtimeDir.path().toLocal8Bit());
+    qputenv("TMPDIR", runtimeDir.path().toLocal8Bit());
+
+    BrowserHost host;
+    host.start();
+
+    QLocalSocket client;
+    client.connectToServer(BrowserShared::localServerPath());
+    QVERIFY(client.waitForConnected(5000));
+    QByteArray replies;
+    connect(&client, &QLocalSocket::readyRead, [&] { replies += client.readAll(); });
+
+    // Reply with the nonce, spinning a nested event loop for the first message like a dialog would
+    QStringList handled;
+    connect(&host, &BrowserHost::clientMessageReceived, [&](QLocalSocket* socket, const QJsonObject& json) {
+        const auto nonce = json.value("nonce").toString();
+        if (nonce == "1") {
+            QTest::qWait(50);
+        }
+        handled << nonce;
+        host.sendClientMessage(socket, {{"action", json.value("action")}, {"nonce", nonce}});
+    });
+
+    // Two messages in one write, the third one split across writes
+    client.write(R"({"action":"test","nonce":"1"}{"action":"test","nonce":"2"}{"action":"te)");
+    client.flush();
+    QTest::qWait(10);
+    client.write(R"(st","nonce":"3"})");
+    client.flush();
+
+    QTRY_COMPARE(handled.size(), 3);
+    QCOMPARE(handled, QStringList({"1", "2", "3"}));
+
+    QTRY_COMPARE(replies,
+                 QByteArray(R"({"action":"test","nonce":"1"}{"action":"test","nonce":"2"}{"action":"test","nonce":"3"})"));
+
+    const auto latencies = host.actionLatencies();
+    QVERIFY(latencies.contains("test"));
+    QCOMPARE(latencies.value("test").count, 3);
+    QVERIFY(latencies.value("test").maxNsecs >= 50 * 1000 * 1000);
+
+    client.disconnectFromServer();
+    host.stop();
+    qputenv("XDG_RUNTIME_DIR", oldRuntimeDir);
+    qputenv("TMPDIR", oldTempDir);
+}
@@ -1036,6 +1036,17 @@ void TestCli::testInfo()
     QCOMPARE(m_stdout->readLine(), QByteArray("Cipher: AES 256-bit\n"));
     QCOMPARE(m_stdout->readLine(), QByteArray("KDF: AES (6000 rounds)\n"));
     QCOMPARE(m_stdout->readLine(), QByteArray("Recycle bin is enabled.\n"));
+
+    // Test with timings option.
+    setInput("a");
+    execCmd(infoCmd, {"db-info", "-q", "--timings", m_dbFile->fileName()});
+    QCOMPARE(m_stderr->readAll(), QByteArray());
+    auto output = m_stdout->readAll();
+    QVERIFY(output.contains("Average password length: 11 characters\nOpen timings:\n"));
+    QVERIFY(output.contains("\n  kdf: "));
+    QVERIFY(output.contains("\n  xml: "));
+    QVERIFY(output.endsWith(" ms\n"));
+    QVERIFY(output.contains("\n  total: "));
 }
 
 void TestCli::testDiceware()
@@ -1269,6 +1280,28 @@ void TestCli::testEstimate()
     }
 }
 
+void TestCli::testEstimateStdin()
+{
+    const QStringList passwords{"password", "sdfgsdfg", "", "E*!%.Qw{t.X,&bafw)\"Q!ah$%;U/"};
+
+    Estimate estimateCmd;
+    setInput(passwords);
+    execCmd(estimateCmd, {"estimate", "-s"});
+
+    // One result per password, in the order of the input
+    const auto lines = QString(m_stdout->readAll()).split('\n', Qt::SkipEmptyParts);
+    QCOMPARE(lines.size(), passwords.size());
+    for (int i = 0; i < passwords.size(); ++i) {
+        const auto e = ZxcvbnMatch(passwords[i].toUtf8(), nullptr, nullptr);
+        QVERIFY(lines[i].startsWith(QString("Length %1\t").arg(passwords[i].length())));
+        QVERIFY(lines[i].contains(QString("Entropy %1").arg(e, 0, 'f', 3)));
+    }
+
+    // A password argument can't be combined with the option
+    QCOMPARE(execCmd(estimateCmd, {"estimate", "-s", "password"}), EXIT_FAILURE);
+    QVERIFY(m_stderr->readAll().contains("--stdin"));
+}
+
 void TestCli::testExport()
 {
     Export exportCmd;
@@ -59,6 +59,7 @@ private slots:
     void testEdit();
     void testEstimate_data();
     void testEstimate();
+    void testEstimateStdin();
     void testExport();
     void testGenerate_data();
     void testGenerate();
@@ -17,7 +17,9 @@
 
 #include "TestConfig.h"
 
+#include <QSettings>
 #include <QTest>
+#include <QTextStream>
 
 #include "config-keepassx-tests.h"
 #include "util/TemporaryFile.h"
@@ -40,3 +42,81 @@ void TestConfig::testUpgrade()
 
     tempFile.remove();
 }
+
+void TestConfig::testCachedValues()
+{
+    TemporaryFile tempFile;
+    QVERIFY(tempFile.open());
+    QTextStream stream(&tempFile);
+    stream << "[General]\nConfigVersion=2\nAutoTypeDelay=42\nMinimizeOnCopy=false\n";
+    stream.flush();
+    tempFile.close();
+
+    Config::createConfigFromFile(tempFile.fileName(), tempFile.fileName());
+
+    // Values from the file are converted to the type of their default
+    QCOMPARE(config()->get(Config::AutoTypeDelay), QVariant(42));
+    QCOMPARE(config()->get(Config::MinimizeOnCopy), QVariant(false));
+    QCOMPARE(config()->get(Config::AutoTypeStartDelay), config()->getDefault(Config::AutoTypeStartDelay));
+
+    config()->set(Config::AutoTypeDelay, 10);
+    QCOMPARE(config()->get(Config::AutoTypeDelay).toInt(), 10);
+    config()->remove(Config::AutoTypeDelay);
+    QCOMPARE(config()->get(Config::AutoTypeDelay), config()->getDefault(Config::AutoTypeDelay));
+
+    // Changes made to the file by another instance are picked up on sync
+    config()->sync();
+    {
+        QSettings settings(tempFile.fileName(), QSettings::IniFormat);
+        settings.setValue("AutoTypeDelay", 7);
+    }
+    config()->sync();
+    QCOMPARE(config()->get(Config::AutoTypeDelay).toInt(), 7);
+
+    config()->resetToDefaults();
+    QCOMPARE(config()->get(Config::AutoTypeDelay), config()->getDefault(Config::AutoTypeDelay));
+    QCOMPARE(config()->get(Config::MinimizeOnCopy), config()->getDefault(Config::MinimizeOnCopy));
+}
+
+void TestConfig::benchmarkGet()
+{
+    QByteArray env = qgetenv("BENCHMARK");
+    if (env.isEmpty() || env == "0" || env == "no") {
+        QSKIP("Benchmark skipped. Set env variable BENCHMARK=1 to enable.");
+    }
+
+    Config::createTempFileInstance();
+    config()->set(Config::GUI_HidePasswords, false);
+
+    int hidden = 0;
+    QBENCHMARK
+    {
+        for (int i = 0; i < 10000; ++i) {
+            hidden += config()->get(Config::GUI_HidePasswords).toBool() ? 1 : 0;
+        }
+    }
+    QCOMPARE(hidden, 0);
+}
+
+void TestConfig::benchmarkSettingsValue()
+{
+    QByteArray env = qgetenv("BENCHMARK");
+    if (env.isEmpty() || env == "0" || env == "no") {
+        QSKIP("Benchmark skipped. Set env variable BENCHMARK=1 to enable.");
+    }
+
+    // Reading through QSettings directly, as Config::get used to do
+    TemporaryFile tempFile;
+    QVERIFY(tempFile.open());
+    QSettings settings(tempFile.fileName(), QSettings::IniFormat);
+    settings.setValue("GUI/HidePasswords", false);
+
+    int hidden = 0;
+    QBENCHMARK
+    {
+        for (int i = 0; i < 10000; ++i) {
+            hidden += settings.value("GUI/HidePasswords", true).toBool() ? 1 : 0;
+        }
+    }
+    QCOMPARE(hidden, 0);
+}
@@ -25,6 +25,9 @@ class TestConfig : public QObject
     Q_OBJECT
 private slots:
     void testUpgrade();
+    void testCachedValues();
+    void benchmarkGet();
+    void benchmarkSettingsValue();
 };
 
 #endif // KEEPASSX_TESTCONFIG_H
@@ -20,13 +20,22 @@
 
 #include <QRegularExpression>
 #include <QSignalSpy>
+#include <QStandardPaths>
 #include <QTest>
+#include <QtConcurrent>
 
 #include "config-keepassx-tests.h"
+#include "core/Clock.h"
+#include "core/Config.h"
+#include "core/DatabaseQueryExecutor.h"
+#include "core/DatabaseStats.h"
 #include "core/Group.h"
 #include "core/Metadata.h"
+#include "core/PasswordHealth.h"
 #include "core/Tools.h"
 #include "crypto/Crypto.h"
+#include "format/DatabaseOpenCache.h"
+#include "format/KeePass2Reader.h"
 #include "format/KeePass2Writer.h"
 #include "util/TemporaryFile.h"
 
@@ -42,6 +51,7 @@ static QString dbFileName = QStringLiteral(KEEPASSX_TEST_DATA_DIR).append("/NewD
 void TestDatabase::initTestCase()
 {
     QVERIFY(Crypto::init());
+    Config::createTempFileInstance();
 }
 
 void TestDatabase::testOpen()
@@ -63,6 +73,63 @@ void TestDatabase::testOpen()
     QVERIFY(db->isModified());
 }
 
+void TestDatabase::testOpenOnWorkerThread()
+{
+    auto key = QSharedPointer<CompositeKey>::create();
+    key->addKey(QSharedPointer<PasswordKey>::create("a"));
+
+    auto* mainThread = QThread::currentThread();
+    auto future = QtConcurrent::run([key, mainThread] {
+        auto* db = new Database();
+        if (!db->read(dbFileName, key)) {
+            delete db;
+            return static_cast<Database*>(nullptr);
+        }
+        db->rootGroup()->entriesRecursive().first()->addHistoryItem(new Entry());
+        db->moveDataToThread(mainThread);
+        return db;
+    });
+    QScopedPointer<Database> db(future.result());
+    QVERIFY(db);
+
+    // All objects read on the worker thread now belong to this thread
+    QCOMPARE(db->thread(), mainThread);
+    QCOMPARE(db->metadata()->thread(), mainThread);
+    QVERIFY(!db->rootGroup()->entriesRecursive().isEmpty());
+    for (const auto* group : db->rootGroup()->groupsRecursive(true)) {
+        QCOMPARE(group->thread(), mainThread);
+    }
+    for (const auto* entry : db->rootGroup()->entriesRecursive(true)) {
+        QCOMPARE(entry->thread(), mainThread);
+    }
+
+    // Opening is only complete once announced on this thread
+    QSignalSpy spyOpened(db.data(), SIGNAL(databaseOpened()));
+    db->completeOpen();
+    QCOMPARE(spyOpened.count(), 1);
+    QVERIFY(db->isInitialized());
+    QVERIFY(!db->isModified());
+
+    // The modified timer moved with the database
+    db->metadata()->setName("test");
+    QVERIFY(db->isModified());
+    QSignalSpy spyModified(db.data(), SIGNAL(modified()));
+    QTRY_COMPARE(spyModified.count(), 1);
+
+    // The key is derived on the worker thread itself, so reading does not wait for a free pool thread
+    auto* pool = QThreadPool::globalInstance();
+    const int maxThreadCount = pool->maxThreadCount();
+    pool->setMaxThreadCount(1);
+    auto singleThreadFuture = QtConcurrent::run([key] {
+        Database db;
+        return db.read(dbFileName, key);
+    });
+    const bool finished = QTest::qWaitFor([&] { return singleThreadFuture.isFinished(); }, 10000);
+    pool->setMaxThreadCount(maxThreadCount);
+    QVERIFY(finished);
+    QVERIFY(singleThreadFuture.result());
+}
+
 void TestDatabase::testSave()
 {
     TemporaryFile tempFile;
@@ -138,6 +205,82 @@ void TestDatabase::testSaveAs()
     QCOMPARE(error, QString("Could not save, database has not been initialized!"));
 }
 
+void TestDatabase::testPhaseTimings()
+{
+    TemporaryFile tempFile;
+    QVERIFY(tempFile.copyFromFile(dbFileName));
+
+    auto db = QSharedPointer<Database>::create();
+    auto key = QSharedPointer<CompositeKey>::create();
+    key->addKey(QSharedPointer<PasswordKey>::create("a"));
+
+    QSignalSpy spyOpenPhase(db.data(), SIGNAL(openPhaseStarted(const QString&)));
+    QString error;
+    QVERIFY(db->open(tempFile.fileName(), key, &error));
+
+    auto timings = db->openTimings();
+    QVERIFY(!timings.isEmpty());
+    QCOMPARE(timings.phases().first().name, PhaseTimings::Header);
+    QVERIFY(timings.value(PhaseTimings::Kdf) > 0);
+    QVERIFY(timings.value(PhaseTimings::Xml) > 0);
+    qint64 sum = 0;
+    for (const auto& phase : timings.phases()) {
+        QVERIFY(phase.nsecs >= 0);
+        sum += phase.nsecs;
+    }
+    QCOMPARE(timings.total(), sum);
+    QVERIFY(spyOpenPhase.count() >= 3);
+    QCOMPARE(spyOpenPhase.first().first().toString(), PhaseTimings::Header);
+    QVERIFY(db->saveTimings().isEmpty());
+
+    // Saving as KDBX 4 records all phases of the stream layers
+    auto kdf = KeePass2::uuidToKdf(KeePass2::KDF_ARGON2D);
+    kdf->setRounds(1);
+    kdf->processParameters({{KeePass2::KDFPARAM_ARGON2_MEMORY, 1024}, {KeePass2::KDFPARAM_ARGON2_PARALLELISM, 1}});
+    QVERIFY(db->changeKdf(kdf));
+
+    QSignalSpy spySavePhase(db.data(), SIGNAL(savePhaseStarted(const QString&)));
+    QVERIFY2(db->save(Database::Atomic, {}, &error), error.toLatin1());
+
+    timings = db->saveTimings();
+    QStringList phases;
+    for (const auto& phase : timings.phases()) {
+        QVERIFY(phase.nsecs >= 0);
+        phases << phase.name;
+    }
+    QCOMPARE(phases,
+             QStringList({PhaseTimings::Kdf,
+                          PhaseTimings::Header,
+                          PhaseTimings::Binaries,
+                          PhaseTimings::Xml,
+                          PhaseTimings::Compress,
+                          PhaseTimings::Encrypt,
+                          PhaseTimings::Write,
+                          PhaseTimings::Commit}));
+    QVERIFY(timings.value(PhaseTimings::Xml) > 0);
+    QVERIFY(timings.value(PhaseTimings::Commit) > 0);
+    QCOMPARE(spySavePhase.last().first().toString(), PhaseTimings::Commit);
+
+    auto db2 = QSharedPointer<Database>::create();
+    QVERIFY(db2->open(tempFile.fileName(), key, &error));
+    timings = db2->openTimings();
+    phases.clear();
+    for (const auto& phase : timings.phases()) {
+        QVERIFY(phase.nsecs >= 0);
+        phases << phase.name;
+    }
+    QCOMPARE(phases,
+             QStringList({PhaseTimings::Header,
+                          PhaseTimings::Kdf,
+                          PhaseTimings::Binaries,
+                          PhaseTimings::Xml,
+                          PhaseTimings::Model,
+                          PhaseTimings::Read,
+                          PhaseTimings::Decrypt,
+                          PhaseTimings::Decompress}));
+    QVERIFY(timings.value(PhaseTimings::Read) > 0);
+}
+
 void TestDatabase::testSignals()
 {
     TemporaryFile tempFile;
@@ -268,3 +411,585 @@ void TestDatabase::testCustomIcons()
     QCOMPARE(iconData.name, QString("Test"));
     QCOMPARE(iconData.lastModified, date);
 }
+
+void TestDatabase::testTagIndex()
+{
+    Database db;
+    QSignalSpy spyTagListUpdated(&db, SIGNAL(tagListUpdated()));
+
+    auto entry1 = new Entry();
+    entry1->setUuid(QUuid::createUuid());
+    entry1->setTags("a,b");
+    entry1->setGroup(db.rootGroup());
+
+    auto group = new Group();
+    group->setUuid(QUuid::createUuid());
+    group->setParent(db.rootGroup());
+    auto entry2 = new Entry();
+    entry2->setUuid(QUuid::createUuid());
+    entry2->setTags("b;c");
+    entry2->setGroup(group);
+
+    // Tag list is refreshed with the modified signal
+    QTRY_VERIFY(spyTagListUpdated.count() > 0);
+    QCOMPARE(db.tagList(), QStringList({"a", "b", "c"}));
+
+    // Tags still used by another entry remain
+    entry2->setTags("c");
+    db.updateTagList();
+    QCOMPARE(db.tagList(), QStringList({"a", "b", "c"}));
+    entry1->removeTag("b");
+    db.updateTagList();
+    QCOMPARE(db.tagList(), QStringList({"a", "c"}));
+
+    // Recycled entries do not contribute tags
+    db.metadata()->setRecycleBinEnabled(true);
+    db.recycleEntry(entry1);
+    db.updateTagList();
+    QCOMPARE(db.tagList(), QStringList({"c"}));
+
+    // Neither do entries in recycled groups, until they are moved back out
+    db.recycleGroup(group);
+    db.updateTagList();
+    QCOMPARE(db.tagList(), QStringList());
+    group->setParent(db.rootGroup());
+    db.updateTagList();
+    QCOMPARE(db.tagList(), QStringList({"c"}));
+
+    // Deleted entries and groups moved to another database are removed
+    entry1->setGroup(db.rootGroup());
+    db.updateTagList();
+    QCOMPARE(db.tagList(), QStringList({"a", "c"}));
+    delete entry1;
+    db.updateTagList();
+    QCOMPARE(db.tagList(), QStringList({"c"}));
+
+    Database db2;
+    group->setParent(db2.rootGroup());
+    db.updateTagList();
+    db2.updateTagList();
+    QCOMPARE(db.tagList(), QStringList());
+    QCOMPARE(db2.tagList(), QStringList({"c"}));
+}
+
+void TestDatabase::testUsernameIndex()
+{
+    Database db;
+
+    auto addEntry = [&db](const QString& username) {
+        auto entry = new Entry();
+        entry->setUuid(QUuid::createUuid());
+        entry->setUsername(username);
+        entry->setGroup(db.rootGroup());
+        return entry;
+    };
+
+    auto bob = addEntry("bob");
+    addEntry("alice");
+    addEntry("bob");
+    addEntry("alice");
+    addEntry("alice");
+    addEntry("");
+    addEntry(QString("{REF:U@I:%1}").arg(bob->uuidToHex()));
+
+    db.updateCommonUsernames();
+    QCOMPARE(db.commonUsernames(), QStringList({"alice", "bob"}));
+    db.updateCommonUsernames(1);
+    QCOMPARE(db.commonUsernames(), QStringList({"alice"}));
+
+    // Changing usernames updates the frequencies
+    bob->setUsername("carol");
+    db.updateCommonUsernames();
+    QCOMPARE(db.commonUsernames(), QStringList({"alice", "bob", "carol"}));
+    delete bob;
+    db.updateCommonUsernames();
+    QCOMPARE(db.commonUsernames(), QStringList({"alice", "bob"}));
+
+    // Same result as counting the usernames of all entries
+    QCOMPARE(db.commonUsernames(), QStringList(db.rootGroup()->usernamesRecursive(10)));
+}
+
+void TestDatabase::testStatistics()
+{
+    auto db = QSharedPointer<Database>::create();
+    auto group = new Group();
+    group->setUuid(QUuid::createUuid());
+    group->setParent(db->rootGroup());
+
+    auto addEntry = [&db](Group* parent, const QString& password) {
+        auto entry = new Entry();
+        entry->setUuid(QUuid::createUuid());
+        entry->setPassword(password);
+        entry->setGroup(parent);
+        return entry;
+    };
+
+    const QString longPassword("correct horse battery staple cheese");
+    auto short1 = addEntry(db->rootGroup(), "abc");
+    auto short2 = addEntry(db->rootGroup(), "abc");
+    auto strong = addEntry(group, longPassword);
+    addEntry(db->rootGroup(), "");
+    auto reference = addEntry(group, QString("{REF:P@I:%1}").arg(strong->uuidToHex()));
+
+    {
+        DatabaseStats stats(db);
+        QCOMPARE(stats.groupCount, 2);
+        QCOMPARE(stats.entryCount, 5);
+        QCOMPARE(stats.expiredEntries, 0);
+        QCOMPARE(stats.excludedEntries, 0);
+        QCOMPARE(stats.uniquePasswords, 2);
+        QCOMPARE(stats.reusedPasswords, 2);
+        QCOMPARE(stats.shortPasswords, 2);
+        QCOMPARE(stats.weakPasswords, 2);
+        QCOMPARE(stats.totalPasswordLength, 6 + 2 * longPassword.size());
+        QCOMPARE(stats.maxPwdReuse(), 2);
+    }
+
+    // Changes are applied to the statistics right away
+    strong->setExpires(true);
+    strong->setExpiryTime(Clock::currentDateTimeUtc().addDays(-1));
+    short1->setPassword("abcdefgh1");
+    short1->setExcludeFromReports(true);
+    db->recycleEntry(short2);
+    {
+        DatabaseStats stats(db);
+        QCOMPARE(stats.groupCount, 2);
+        QCOMPARE(stats.entryCount, 4);
+        QCOMPARE(stats.expiredEntries, 1);
+        QCOMPARE(stats.excludedEntries, 1);
+        QCOMPARE(stats.uniquePasswords, 2);
+        QCOMPARE(stats.reusedPasswords, 1);
+        QCOMPARE(stats.shortPasswords, 0);
+        QCOMPARE(stats.weakPasswords, 1);
+    }
+
+    // References follow their target
+    strong->setPassword("abc");
+    {
+        DatabaseStats stats(db);
+        QCOMPARE(stats.uniquePasswords, 2);
+        QCOMPARE(stats.reusedPasswords, 1);
+        QCOMPARE(stats.shortPasswords, 2);
+        QCOMPARE(stats.weakPasswords, 3);
+        QCOMPARE(stats.totalPasswordLength, 9 + 3 + 3);
+    }
+
+    delete reference;
+    db->emptyRecycleBin();
+    {
+        DatabaseStats stats(db);
+        QCOMPARE(stats.entryCount, 3);
+        QCOMPARE(stats.uniquePasswords, 2);
+        QCOMPARE(stats.reusedPasswords, 0);
+        QCOMPARE(stats.weakPasswords, 2);
+        QCOMPARE(stats.maxPwdReuse(), 1);
+    }
+}
+
+void TestDatabase::benchmarkTagIndex()
+{
+    QByteArray env = qgetenv("BENCHMARK");
+    if (env.isEmpty() || env == "0" || env == "no") {
+        QSKIP("Benchmark skipped. Set env variable BENCHMARK=1 to enable.");
+    }
+
+    Database db;
+    for (int i = 0; i < 50000; ++i) {
+        auto entry = new Entry();
+        entry->setUuid(QUuid::createUuid());
+        entry->setUsername(QString("user%1").arg(i % 100));
+        entry->setTags(QString("tag%1,common").arg(i % 500));
+        entry->setGroup(db.rootGroup());
+    }
+    auto entry = db.rootGroup()->entries().first();
+
+    // A single entry edit must not be proportional to the size of the database
+    int i = 0;
+    QBENCHMARK
+    {
+        entry->setTags(QString("edited%1").arg(++i % 2));
+        entry->setUsername(QString("edited%1").arg(i % 2));
+        db.updateTagList();
+        db.updateCommonUsernames();
+    }
+    QCOMPARE(db.tagList().size(), 502);
+}
+
+void TestDatabase::testQueryExecutor()
+{
+    QList<QSharedPointer<Database>> databases;
+    for (int i = 0; i < 4; ++i) {
+        auto db = QSharedPointer<Database>::create();
+        for (int j = 0; j < 3; ++j) {
+            auto entry = new Entry();
+            entry->setTitle(QString("%1-%2").arg(i).arg(2 - j));
+            entry->setGroup(db->rootGroup());
+        }
+        databases << db;
+    }
+
+    auto titles = [](const QSharedPointer<Database>& db) {
+        QStringList result;
+        for (const auto* entry : db->rootGroup()->entries()) {
+            result << entry->title();
+        }
+        return result;
+    };
+
+    // Results keep the order of the databases
+    auto results = DatabaseQueryExecutor::run<QString>(databases, titles);
+    QCOMPARE(results.size(), 12);
+    QCOMPARE(results.mid(0, 3), QList<QString>({"0-2", "0-1", "0-0"}));
+    QCOMPARE(results.mid(9, 3), QList<QString>({"3-2", "3-1", "3-0"}));
+
+    QCOMPARE(DatabaseQueryExecutor::run<QString>(databases.mid(1, 1), titles), QList<QString>({"1-2", "1-1", "1-0"}));
+    QVERIFY(DatabaseQueryExecutor::run<QString>({}, titles).isEmpty());
+}
+
+void TestDatabase::testPasswordHealthCache()
+{
+    TemporaryFile tempFile;
+    QVERIFY(tempFile.copyFromFile(dbFileName));
+
+    auto key = QSharedPointer<CompositeKey>::create();
+    key->addKey(QSharedPointer<PasswordKey>::create("a"));
+
+    QString error;
+    auto db = QSharedPointer<Database>::create();
+    QVERIFY(db->open(tempFile.fileName(), key, &error));
+
+    auto entry = new Entry();
+    entry->setUuid(QUuid::createUuid());
+    entry->setPassword("correct horse battery staple");
+    entry->setGroup(db->rootGroup());
+    const auto entropy = entry->passwordHealth()->entropy();
+    QCOMPARE(db->passwordHealthCache()->size(), 1);
+
+    // Editing the entry does not estimate the same password again
+    entry->setTitle("Cached");
+    entry->setPassword("correct horse battery staple");
+    QCOMPARE(entry->passwordHealth()->entropy(), entropy);
+    QCOMPARE(db->passwordHealthCache()->size(), 1);
+
+    // Not stored unless enabled
+    QVERIFY2(db->save(Database::Atomic, {}, &error), error.toLatin1());
+    QVERIFY(!db->metadata()->customData()->contains(CustomData::PasswordHealthCache));
+
+    config()->set(Config::Security_PersistPasswordHealth, true);
+    QVERIFY2(db->save(Database::Atomic, {}, &error), error.toLatin1());
+    QVERIFY(db->metadata()->customData()->contains(CustomData::PasswordHealthCache));
+    QVERIFY(!db->isModified());
+
+    // The estimates are available right after opening
+    auto reopened = QSharedPointer<Database>::create();
+    QVERIFY(reopened->open(tempFile.fileName(), key, &error));
+    QCOMPARE(reopened->passwordHealthCache()->size(), 1);
+    auto reopenedEntry = reopened->rootGroup()->findEntryByUuid(entry->uuid());
+    QVERIFY(reopenedEntry);
+    QCOMPARE(reopenedEntry->passwordHealth()->entropy(), entropy);
+    QCOMPARE(reopened->passwordHealthCache()->size(), 1);
+
+    // Only the passwords still in use are stored
+    reopenedEntry->setPassword("Tr0ub4dor&3");
+    reopenedEntry->passwordHealth();
+    QCOMPARE(reopened->passwordHealthCache()->size(), 2);
+    QVERIFY2(reopened->save(Database::Atomic, {}, &error), error.toLatin1());
+    PasswordHealthCache restored;
+    QVERIFY(restored.restore(reopened->metadata()->customData()->value(CustomData::PasswordHealthCache)));
+    QCOMPARE(restored.size(), 1);
+    QVERIFY(!restored.restore("invalid"));
+    QCOMPARE(restored.size(), 1);
+
+    // Disabling the cache removes it from the database
+    config()->set(Config::Security_PersistPasswordHealth, false);
+    QVERIFY2(reopened->save(Database::Atomic, {}, &error), error.toLatin1());
+    QVERIFY(!reopened->metadata()->customData()->contains(CustomData::PasswordHealthCache));
+}
+
+void TestDatabase::testOpenCache()
+{
+    QStandardPaths::setTestModeEnabled(true);
+    DatabaseOpenCache::removeAll();
+
+    TemporaryFile tempFile;
+    QVERIFY(tempFile.copyFromFile(dbFileName));
+
+    auto key = QSharedPointer<CompositeKey>::create();
+    key->addKey(QSharedPointer<PasswordKey>::create("a"));
+
+    QString error;
+    auto db = QSharedPointer<Database>::create();
+    QVERIFY(db->open(tempFile.fileName(), key, &error));
+
+    // Only KDBX 4 files are cached
+    config()->set(Config::Security_OpenCache, true);
+    DatabaseOpenCache openCache(tempFile.fileName());
+    auto reopened = QSharedPointer<Database>::create();
+    QVERIFY(reopened->open(tempFile.fileName(), key, &error));
+    QVERIFY(!QFile::exists(openCache.fileName()));
+
+    auto kdf = KeePass2::uuidToKdf(KeePass2::KDF_ARGON2D);
+    kdf->setRounds(1);
+    kdf->processParameters({{KeePass2::KDFPARAM_ARGON2_MEMORY, 1024}, {KeePass2::KDFPARAM_ARGON2_PARALLELISM, 1}});
+    QVERIFY(db->changeKdf(kdf));
+
+    const auto iconUuid = QUuid::createUuid();
+    db->metadata()->addCustomIcon(iconUuid, QByteArray("icon"), "Icon");
+    db->metadata()->setRecycleBinEnabled(true);
+    auto entry = new Entry();
+    entry->setUuid(QUuid::createUuid());
+    entry->setTitle("Cached");
+    entry->setPassword("secret");
+    entry->setIcon(iconUuid);
+    entry->attributes()->set("Protected", "value", true);
+    entry->attachments()->set("attachment", QByteArray("data"));
+    entry->setGroup(db->rootGroup());
+    entry->setPassword("new secret");
+    entry->beginUpdate();
+    entry->attachments()->set("added later", QByteArray("more data"));
+    QVERIFY(entry->endUpdate());
+    db->recycleEntry(db->rootGroup()->entries().first());
+    auto deleted = new Entry();
+    deleted->setUuid(QUuid::createUuid());
+    deleted->setGroup(db->rootGroup());
+    delete deleted;
+    QVERIFY(!db->deletedObjects().isEmpty());
+
+    // Saving stores the cache for the next open
+    QVERIFY2(db->save(Database::Atomic, {}, &error), error.toLatin1());
+    QVERIFY(QFile::exists(openCache.fileName()));
+    QVERIFY(db->saveTimings().value(PhaseTimings::Cache) > 0);
+
+    reopened = QSharedPointer<Database>::create();
+    QVERIFY(reopened->open(tempFile.fileName(), key, &error));
+    auto timings = reopened->openTimings();
+    QVERIFY(timings.value(PhaseTimings::Kdf) > 0);
+    QVERIFY(timings.value(PhaseTimings::Model) > 0);
+    QCOMPARE(timings.value(PhaseTimings::Xml), 0);
+    QVERIFY(!reopened->isModified());
+
+    QCOMPARE(reopened->formatVersion(), db->formatVersion());
+    QCOMPARE(reopened->metadata()->name(), db->metadata()->name());
+    QCOMPARE(reopened->metadata()->customIcon(iconUuid).name, QString("Icon"));
+    QVERIFY(reopened->metadata()->recycleBin());
+    QCOMPARE(reopened->metadata()->recycleBin()->uuid(), db->metadata()->recycleBin()->uuid());
+    QCOMPARE(reopened->deletedObjects().size(), db->deletedObjects().size());
+    const auto entries = db->rootGroup()->entriesRecursive(true);
+    QCOMPARE(reopened->rootGroup()->entriesRecursive(true).size(), entries.size());
+    for (const auto* original : entries) {
+        auto cached = reopened->rootGroup()->findEntryByUuid(original->uuid());
+        QVERIFY(cached);
+        QVERIFY(cached->equals(original, CompareItemIgnoreMilliseconds));
+        QCOMPARE(cached->group()->uuid(), original->group()->uuid());
+    }
+    auto cachedEntry = reopened->rootGroup()->findEntryByUuid(entry->uuid());
+    QCOMPARE(cachedEntry->attachments()->value("attachment"), QByteArray("data"));
+    QVERIFY(cachedEntry->attributes()->isProtected("Protected"));
+    QCOMPARE(cachedEntry->historyItems().size(), entry->historyItems().size());
+    QCOMPARE(cachedEntry->iconUuid(), iconUuid);
+
+    // The cache yields exactly what reading the XML yields
+    Database xmlDb;
+    QVERIFY(KeePass2Reader().readDatabase(tempFile.fileName(), key, &xmlDb));
+    const auto* cachedMeta = reopened->metadata();
+    const auto* xmlMeta = xmlDb.metadata();
+    QCOMPARE(cachedMeta->generator(), xmlMeta->generator());
+    QCOMPARE(cachedMeta->name(), xmlMeta->name());
+    QCOMPARE(cachedMeta->nameChanged(), xmlMeta->nameChanged());
+    QCOMPARE(cachedMeta->description(), xmlMeta->description());
+    QCOMPARE(cachedMeta->descriptionChanged(), xmlMeta->descriptionChanged());
+    QCOMPARE(cachedMeta->defaultUserName(), xmlMeta->defaultUserName());
+    QCOMPARE(cachedMeta->defaultUserNameChanged(), xmlMeta->defaultUserNameChanged());
+    QCOMPARE(cachedMeta->settingsChanged(), xmlMeta->settingsChanged());
+    QCOMPARE(cachedMeta->maintenanceHistoryDays(), xmlMeta->maintenanceHistoryDays());
+    QCOMPARE(cachedMeta->color(), xmlMeta->color());
+    QCOMPARE(cachedMeta->protectTitle(), xmlMeta->protectTitle());
+    QCOMPARE(cachedMeta->protectUsername(), xmlMeta->protectUsername());
+    QCOMPARE(cachedMeta->protectPassword(), xmlMeta->protectPassword());
+    QCOMPARE(cachedMeta->protectUrl(), xmlMeta->protectUrl());
+    QCOMPARE(cachedMeta->protectNotes(), xmlMeta->protectNotes());
+    QCOMPARE(cachedMeta->recycleBinEnabled(), xmlMeta->recycleBinEnabled());
+    QCOMPARE(cachedMeta->recycleBin()->uuid(), xmlMeta->recycleBin()->uuid());
+    QCOMPARE(cachedMeta->recycleBinChanged(), xmlMeta->recycleBinChanged());
+    QCOMPARE(!cachedMeta->entryTemplatesGroup(), !xmlMeta->entryTemplatesGroup());
+    QCOMPARE(cachedMeta->entryTemplatesGroupChanged(), xmlMeta->entryTemplatesGroupChanged());
+    QCOMPARE(!cachedMeta->lastSelectedGroup(), !xmlMeta->lastSelectedGroup());
+    QCOMPARE(!cachedMeta->lastTopVisibleGroup(), !xmlMeta->lastTopVisibleGroup());
+    QCOMPARE(cachedMeta->databaseKeyChanged(), xmlMeta->databaseKeyChanged());
+    QCOMPARE(cachedMeta->databaseKeyChangeRec(), xmlMeta->databaseKeyChangeRec());
+    QCOMPARE(cachedMeta->databaseKeyChangeForce(), xmlMeta->databaseKeyChangeForce());
+    QCOMPARE(cachedMeta->historyMaxItems(), xmlMeta->historyMaxItems());
+    QCOMPARE(cachedMeta->historyMaxSize(), xmlMeta->historyMaxSize());
+    QVERIFY(*cachedMeta->customData() == *xmlMeta->customData());
+
+    QCOMPARE(cachedMeta->customIconsOrder(), xmlMeta->customIconsOrder());
+    for (const auto& uuid : xmlMeta->customIconsOrder()) {
+        const auto& cachedIcon = cachedMeta->customIcon(uuid);
+        const auto& xmlIcon = xmlMeta->customIcon(uuid);
+        QCOMPARE(cachedIcon.data, xmlIcon.data);
+        QCOMPARE(cachedIcon.name, xmlIcon.name);
+        QCOMPARE(cachedIcon.lastModified, xmlIcon.lastModified);
+    }
+
+    QCOMPARE(reopened->deletedObjects().size(), xmlDb.deletedObjects().size());
+    for (int i = 0; i < xmlDb.deletedObjects().size(); ++i) {
+        QCOMPARE(reopened->deletedObjects().at(i).uuid, xmlDb.deletedObjects().at(i).uuid);
+        QCOMPARE(reopened->deletedObjects().at(i).deletionTime, xmlDb.deletedObjects().at(i).deletionTime);
+    }
+
+    const auto xmlGroups = xmlDb.rootGroup()->groupsRecursive(true);
+    QCOMPARE(reopened->rootGroup()->groupsRecursive(true).size(), xmlGroups.size());
+    for (const auto* xmlGroup : xmlGroups) {
+        auto cachedGroup = reopened->rootGroup()->findGroupByUuid(xmlGroup->uuid());
+        QVERIFY(cachedGroup);
+        QCOMPARE(cachedGroup->name(), xmlGroup->name());
+        QCOMPARE(cachedGroup->notes(), xmlGroup->notes());
+        QCOMPARE(cachedGroup->tags(), xmlGroup->tags());
+        QCOMPARE(cachedGroup->iconNumber(), xmlGroup->iconNumber());
+        QCOMPARE(cachedGroup->iconUuid(), xmlGroup->iconUuid());
+        QCOMPARE(cachedGroup->isExpanded(), xmlGroup->isExpanded());
+        QCOMPARE(cachedGroup->defaultAutoTypeSequence(), xmlGroup->defaultAutoTypeSequence());
+        QCOMPARE(cachedGroup->autoTypeEnabled(), xmlGroup->autoTypeEnabled());
+        QCOMPARE(cachedGroup->searchingEnabled(), xmlGroup->searchingEnabled());
+        QCOMPARE(cachedGroup->previousParentGroupUuid(), xmlGroup->previousParentGroupUuid());
+        QVERIFY(cachedGroup->timeInfo().equals(xmlGroup->timeInfo()));
+        QVERIFY(*asConst(*cachedGroup).customData() == *xmlGroup->customData());
+        QCOMPARE(!cachedGroup->lastTopVisibleEntry(), !xmlGroup->lastTopVisibleEntry());
+        QCOMPARE(!cachedGroup->parentGroup(), !xmlGroup->parentGroup());
+        if (xmlGroup->parentGroup()) {
+            QCOMPARE(cachedGroup->parentGroup()->uuid(), xmlGroup->parentGroup()->uuid());
+        }
+    }
+
+    const auto xmlEntries = xmlDb.rootGroup()->entriesRecursive(true);
+    QCOMPARE(reopened->rootGroup()->entriesRecursive(true).size(), xmlEntries.size());
+    for (const auto* xmlEntry : xmlEntries) {
+        auto cached = reopened->rootGroup()->findEntryByUuid(xmlEntry->uuid());
+        QVERIFY(cached);
+        QVERIFY(cached->equals(xmlEntry, CompareItemDefault));
+        QCOMPARE(cached->historyItems().size(), xmlEntry->historyItems().size());
+        for (int i = 0; i < xmlEntry->historyItems().size(); ++i) {
+            const auto* cachedItem = asConst(*cached->historyItems().at(i)).attachments();
+            const auto* xmlItem = asConst(*xmlEntry->historyItems().at(i)).attachments();
+            QCOMPARE(cachedItem->keys(), xmlItem->keys());
+            for (const auto& attachmentKey : xmlItem->keys()) {
+                QCOMPARE(cachedItem->value(attachmentKey), xmlItem->value(attachmentKey));
+            }
+        }
+    }
+    const auto* historyItem = cachedEntry->historyItems().last();
+    QCOMPARE(asConst(*historyItem).attachments()->value("attachment"), QByteArray("data"));
+    QVERIFY(!asConst(*historyItem).attachments()->hasKey("added later"));
+
+    // The cache is not used with a wrong key
+    auto wrongKey = QSharedPointer<CompositeKey>::create();
+    wrongKey->addKey(QSharedPointer<PasswordKey>::create("b"));
+    auto wrong = QSharedPointer<Database>::create();
+    QVERIFY(!wrong->open(tempFile.fileName(), wrongKey, &error));
+    QVERIFY(error.contains("Invalid credentials"));
+
+    // A file changed behind our back is read again and cached anew
+    db->metadata()->setName("Changed");
+    {
+        QFile file(tempFile.fileName());
+        QVERIFY(file.open(QIODevice::WriteOnly | QIODevice::Truncate));
+        KeePass2Writer writer;
+        QVERIFY(writer.writeDatabase(&file, db.data()));
+    }
+    reopened = QSharedPointer<Database>::create();
+    QVERIFY(reopened->open(tempFile.fileName(), key, &error));
+    QVERIFY(reopened->openTimings().value(PhaseTimings::Xml) > 0);
+    QVERIFY(reopened->openTimings().value(PhaseTimings::Cache) > 0);
+    QCOMPARE(reopened->metadata()->name(), QString("Changed"));
+
+    reopened = QSharedPointer<Database>::create();
+    QVERIFY(reopened->open(tempFile.fileName(), key, &error));
+    QCOMPARE(reopened->openTimings().value(PhaseTimings::Xml), 0);
+    QCOMPARE(reopened->metadata()->name(), QString("Changed"));
+
+    // A corrupt cache is ignored
+    {
+        QFile file(openCache.fileName());
+        QVERIFY(file.open(QIODevice::ReadWrite));
+        QVERIFY(file.seek(file.size() - 1));
+        char last;
+        QVERIFY(file.getChar(&last));
+        QVERIFY(file.seek(file.size() - 1));
+        QVERIFY(file.putChar(static_cast<char>(~last)));
+    }
+    reopened = QSharedPointer<Database>::create();
+    QVERIFY(reopened->open(tempFile.fileName(), key, &error));
+    QVERIFY(reopened->openTimings().value(PhaseTimings::Xml) > 0);
+    QCOMPARE(reopened->metadata()->name(), QString("Changed"));
+
+    // Saving to another file moves the cache along
+    TemporaryFile otherFile;
+    QVERIFY(otherFile.open());
+    otherFile.close();
+    DatabaseOpenCache otherCache(otherFile.fileName());
+    QVERIFY2(db->saveAs(otherFile.fileName(), Database::Atomic, {}, &error), error.toLatin1());
+    QVERIFY(QFile::exists(otherCache.fileName()));
+    QVERIFY(!QFile::exists(openCache.fileName()));
+
+    // Disabling the cache removes it
+    config()->set(Config::Security_OpenCache, false);
+    reopened = QSharedPointer<Database>::create();
+    QVERIFY(reopened->open(tempFile.fileName(), key, &error));
+    QVERIFY(!QFile::exists(openCache.fileName()));
+}
+
+void TestDatabase::benchmarkOpenCache_data()
+{
+    QTest::addColumn<bool>("cache");
+    QTest::newRow("xml") << false;
+    QTest::newRow("cache") << true;
+}
+
+void TestDatabase::benchmarkOpenCache()
+{
+    QByteArray env = qgetenv("BENCHMARK");
+    if (env.isEmpty() || env == "0" || env == "no") {
+        QSKIP("Benchmark skipped. Set env variable BENCHMARK=1 to enable.");
+    }
+
+    QFETCH(bool, cache);
+    QStandardPaths::setTestModeEnabled(true);
+
+    TemporaryFile tempFile;
+    QVERIFY(tempFile.open());
+    tempFile.close();
+
+    auto key = QSharedPointer<CompositeKey>::create();
+    key->addKey(QSharedPointer<PasswordKey>::create("a"));
+
+    Database db;
+    auto kdf = KeePass2::uuidToKdf(KeePass2::KDF_ARGON2D);
+    kdf->setRounds(1);
+    kdf->processParameters({{KeePass2::KDFPARAM_ARGON2_MEMORY, 1024}, {KeePass2::KDFPARAM_ARGON2_PARALLELISM, 1}});
+    QVERIFY(db.changeKdf(kdf));
+    db.setKey(key);
+    for (int i = 0; i < 20000; ++i) {
+        auto entry = new Entry();
+        entry->setUuid(QUuid::createUuid());
+        entry->setTitle(QString("Entry %1").arg(i));
+        entry->setUsername(QString("user%1").arg(i % 100));
+        entry->setPassword(QString("password%1").arg(i));
+        entry->setUrl(QString("https://example%1.com").arg(i));
+        entry->setNotes(QString("Notes of entry %1").arg(i));
+        entry->setGroup(db.rootGroup());
+    }
+
+    config()->set(Config::Security_OpenCache, cache);
+    QString error;
+    QVERIFY2(db.saveAs(tempFile.fileName(), Database::Atomic, {}, &error), error.toLatin1());
+
+    QBENCHMARK
+    {
+        Database reopened;
+        QVERIFY(reopened.open(tempFile.fileName(), key, &error));
+        QCOMPARE(reopened.openTimings().value(PhaseTimings::Xml) == 0, cache);
+    }
+
+    DatabaseOpenCache(tempFile.fileName()).remove();
+    config()->set(Config::Security_OpenCache, false);
+}
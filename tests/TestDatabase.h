@@ -28,14 +28,25 @@ class TestDatabase : public QObject
 private slots:
     void initTestCase();
     void testOpen();
+    void testOpenOnWorkerThread();
     void testSave();
     void testSaveAs();
+    void testPhaseTimings();
     void testSignals();
     void testEmptyRecycleBinOnDisabled();
     void testEmptyRecycleBinOnNotCreated();
     void testEmptyRecycleBinOnEmpty();
     void testEmptyRecycleBinWithHierarchicalData();
     void testCustomIcons();
+    void testTagIndex();
+    void testUsernameIndex();
+    void testStatistics();
+    void benchmarkTagIndex();
+    void testQueryExecutor();
+    void testPasswordHealthCache();
+    void testOpenCache();
+    void benchmarkOpenCache_data();
+    void benchmarkOpenCache();
 };
 
 #endif // KEEPASSX_TESTDATABASE_H
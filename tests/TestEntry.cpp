@@ -16,7 +16,13 @@
  *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
  */
 
+#include <QSignalSpy>
 #include <QTest>
+#include <QtConcurrent>
+
+#ifdef __GLIBC__
+#include <malloc.h>
+#endif
 
 #include "TestEntry.h"
 #include "core/Clock.h"
@@ -27,6 +33,20 @@
 
 QTEST_GUILESS_MAIN(TestEntry)
 
+namespace
+{
+    // Bytes currently allocated on the heap, -1 if the platform can not tell
+    qint64 heapInUse()
+    {
+#ifdef __GLIBC__
+#if __GLIBC_PREREQ(2, 33)
+        return static_cast<qint64>(mallinfo2().uordblks);
+#endif
+#endif
+        return -1;
+    }
+} // namespace
+
 void TestEntry::initTestCase()
 {
     QVERIFY(Crypto::init());
@@ -771,3 +791,200 @@ void TestEntry::testPreviousParentGroup()
     QVERIFY(entry->previousParentGroupUuid() == group1->uuid());
     QVERIFY(entry->previousParentGroup() == group1);
 }
+
+void TestEntry::testTimeInfo()
+{
+    TimeInfo timeInfo;
+
+    // Times before the epoch and with milliseconds are kept as they are
+    const QDateTime early(QDate(1, 1, 1), QTime(0, 0, 0), Qt::UTC);
+    const QDateTime precise(QDate(2024, 2, 29), QTime(12, 30, 15, 999), Qt::UTC);
+    timeInfo.setCreationTime(early);
+    timeInfo.setLastModificationTime(precise);
+    QCOMPARE(timeInfo.creationTime(), early);
+    QCOMPARE(timeInfo.creationTime().timeSpec(), Qt::UTC);
+    QCOMPARE(timeInfo.lastModificationTime(), precise);
+    QCOMPARE(timeInfo.lastModificationMSecs(), precise.toMSecsSinceEpoch());
+
+    timeInfo.setLastAccessTime(QDateTime());
+    QVERIFY(!timeInfo.lastAccessTime().isValid());
+
+    // Milliseconds are only ignored on request, also before the epoch
+    TimeInfo other = timeInfo;
+    QVERIFY(other == timeInfo);
+    other.setLastModificationTime(precise.addMSecs(-999));
+    QVERIFY(other != timeInfo);
+    QVERIFY(other.equals(timeInfo, CompareItemIgnoreMilliseconds));
+    other.setLastModificationTime(precise.addMSecs(1));
+    QVERIFY(!other.equals(timeInfo, CompareItemIgnoreMilliseconds));
+
+    other = timeInfo;
+    other.setCreationTime(early.addMSecs(-1));
+    QVERIFY(!other.equals(timeInfo, CompareItemIgnoreMilliseconds));
+    timeInfo.setCreationTime(early.addMSecs(-1000));
+    QVERIFY(other.equals(timeInfo, CompareItemIgnoreMilliseconds));
+}
+
+void TestEntry::testExpiry()
+{
+    Entry entry;
+    TimeInfo timeInfo = entry.timeInfo();
+    const QDateTime now = Clock::currentDateTimeUtc();
+
+    timeInfo.setExpiryTime(now.addSecs(-60));
+    entry.setTimeInfo(timeInfo);
+    QVERIFY(!entry.isExpired());
+    QVERIFY(!entry.willExpireInDays(1));
+
+    timeInfo.setExpires(true);
+    entry.setTimeInfo(timeInfo);
+    QVERIFY(entry.isExpired());
+    QVERIFY(entry.isExpired(now.toMSecsSinceEpoch()));
+    QVERIFY(!entry.isExpired(now.addSecs(-120).toMSecsSinceEpoch()));
+
+    timeInfo.setExpiryTime(now.addDays(2));
+    entry.setTimeInfo(timeInfo);
+    QVERIFY(!entry.isExpired());
+    QVERIFY(!entry.willExpireInDays(1));
+    QVERIFY(entry.willExpireInDays(3));
+}
+
+void TestEntry::benchmarkTimeInfo()
+{
+    QByteArray env = qgetenv("BENCHMARK");
+    if (env.isEmpty() || env == "0" || env == "no") {
+        QSKIP("Benchmark skipped. Set env variable BENCHMARK=1 to enable.");
+    }
+
+    const QDateTime base = Clock::currentDateTimeUtc();
+    QList<TimeInfo> timeInfos;
+    for (int i = 0; i < 100000; ++i) {
+        TimeInfo timeInfo;
+        timeInfo.setLastModificationTime(base.addSecs(-((i * 7919) % 100000)));
+        timeInfo.setExpiryTime(base.addSecs(i % 2 == 0 ? -i : i));
+        timeInfo.setExpires(i % 3 == 0);
+        timeInfos.append(timeInfo);
+    }
+    qDebug("TimeInfo: %d bytes", static_cast<int>(sizeof(TimeInfo)));
+
+    int expired = 0;
+    int equal = 0;
+    QBENCHMARK
+    {
+        // Expiry checks share one point in time, like a search or the statistics do
+        const qint64 now = Clock::currentMilliSecondsSinceEpoch();
+        expired = 0;
+        for (const auto& timeInfo : timeInfos) {
+            if (timeInfo.expiresBefore(now)) {
+                ++expired;
+            }
+        }
+
+        // Merging compares the times of every entry with its counterpart
+        equal = 0;
+        for (int i = 1; i < timeInfos.size(); ++i) {
+            if (timeInfos.at(i).equals(timeInfos.at(i - 1), CompareItemIgnoreMilliseconds)) {
+                ++equal;
+            }
+        }
+
+        // Sorting by modification time
+        auto sorted = timeInfos;
+        std::sort(sorted.begin(), sorted.end(), [](const TimeInfo& lhs, const TimeInfo& rhs) {
+            return lhs.lastModificationMSecs() < rhs.lastModificationMSecs();
+        });
+        QVERIFY(sorted.first().lastModificationTime() <= sorted.last().lastModificationTime());
+    }
+    QVERIFY(expired > 0);
+    QCOMPARE(equal, 0);
+}
+
+void TestEntry::testChildContainers()
+{
+    Entry entry;
+    const Entry* constEntry = &entry;
+    QCOMPARE(entry.findChildren<QObject*>(QString(), Qt::FindDirectChildrenOnly).size(), 1);
+
+    // Reading does not create the containers
+    QVERIFY(constEntry->attachments()->isEmpty());
+    QVERIFY(constEntry->customData()->isEmpty());
+    QCOMPARE(constEntry->autoTypeAssociations()->size(), 0);
+    QCOMPARE(entry.findChildren<QObject*>(QString(), Qt::FindDirectChildrenOnly).size(), 1);
+
+    QSignalSpy spyModified(&entry, &Entry::modified);
+    entry.customData()->set("key", "value");
+    QCOMPARE(spyModified.count(), 1);
+    QCOMPARE(entry.findChildren<QObject*>(QString(), Qt::FindDirectChildrenOnly).size(), 2);
+    QCOMPARE(constEntry->customData()->value("key"), QString("value"));
+
+    // Containers are only carried over if there is something to copy
+    QScopedPointer<Entry> clone(entry.clone(Entry::CloneNoFlags));
+    QCOMPARE(clone->findChildren<QObject*>(QString(), Qt::FindDirectChildrenOnly).size(), 2);
+    QVERIFY(clone->equals(&entry, CompareItemDefault));
+
+    Entry empty;
+    empty.setUuid(entry.uuid());
+    QVERIFY(!empty.equals(&entry, CompareItemDefault));
+    empty.copyDataFrom(&entry);
+    QVERIFY(empty.equals(&entry, CompareItemDefault));
+
+    entry.beginUpdate();
+    entry.attachments()->set("attachment", QByteArray("data"));
+    QVERIFY(entry.endUpdate());
+    QCOMPARE(entry.historyItems().size(), 1);
+    QVERIFY(entry.historyItems().first()->attachments()->isEmpty());
+    QCOMPARE(entry.attachments()->keys(), QStringList() << "attachment");
+
+    // Entries without a container share empty ones that belong to the application thread,
+    // also when they are read from another thread
+    Entry other;
+    const Entry* constOther = &other;
+    QCOMPARE(constOther->autoTypeAssociations()->thread(), QCoreApplication::instance()->thread());
+    const auto* attachments = QtConcurrent::run([constOther] { return constOther->attachments(); }).result();
+    QCOMPARE(attachments, constOther->attachments());
+    QCOMPARE(attachments->thread(), QCoreApplication::instance()->thread());
+    QCOMPARE(constEntry->autoTypeAssociations(), constOther->autoTypeAssociations());
+}
+
+void TestEntry::benchmarkEntryMemory()
+{
+    QByteArray env = qgetenv("BENCHMARK");
+    if (env.isEmpty() || env == "0" || env == "no") {
+        QSKIP("Benchmark skipped. Set env variable BENCHMARK=1 to enable.");
+    }
+
+    // Typical entries: the default attributes, no attachments or custom data and a short history
+    const int count = 10000;
+    auto createEntries = [count] {
+        QList<Entry*> entries;
+        for (int i = 0; i < count; ++i) {
+            auto entry = new Entry();
+            entry->setUuid(QUuid::createUuid());
+            entry->setTitle(QString("Entry %1").arg(i));
+            entry->setUsername("user");
+            entry->setPassword(QString("password %1").arg(i));
+            entry->setUrl("https://example.com");
+            for (int j = 0; j < 2; ++j) {
+                entry->beginUpdate();
+                entry->setPassword(QString("password %1 %2").arg(i).arg(j));
+                entry->endUpdate();
+            }
+            entries.append(entry);
+        }
+        return entries;
+    };
+
+    const qint64 before = heapInUse();
+    QList<Entry*> entries = createEntries();
+    const qint64 after = heapInUse();
+    if (before >= 0 && after >= 0) {
+        qDebug("Entry with two history items: %lld bytes", (after - before) / count);
+    }
+    qDeleteAll(entries);
+
+    QBENCHMARK
+    {
+        entries = createEntries();
+        qDeleteAll(entries);
+    }
+}
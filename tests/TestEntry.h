@@ -40,6 +40,11 @@ private slots:
     void testIsRecycled();
     void testMoveUpDown();
     void testPreviousParentGroup();
+    void testTimeInfo();
+    void testExpiry();
+    void benchmarkTimeInfo();
+    void testChildContainers();
+    void benchmarkEntryMemory();
 };
 
 #endif // KEEPASSX_TESTENTRY_H
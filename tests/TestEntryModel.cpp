@@ -18,9 +18,11 @@
 #include "TestEntryModel.h"
 
 #include <QSignalSpy>
+#include <QSortFilterProxyModel>
 #include <QTest>
 
 #include "core/Entry.h"
+#include "core/EntrySearcher.h"
 #include "core/Group.h"
 #include "crypto/Crypto.h"
 #include "gui/DatabaseIcons.h"
@@ -376,3 +378,215 @@ void TestEntryModel::testDatabaseDelete()
     delete modelTest;
     delete model;
 }
+
+void TestEntryModel::testBatchUpdate()
+{
+    auto model = new EntryModel(this);
+    auto modelTest = new ModelTest(model, this);
+
+    auto db = new Database();
+    QList<Entry*> entries;
+    for (int i = 0; i < 5; ++i) {
+        auto entry = new Entry();
+        entry->setGroup(db->rootGroup());
+        entries << entry;
+    }
+
+    model->setGroup(db->rootGroup());
+    QCOMPARE(model->rowCount(), 5);
+
+    QSignalSpy spyDataChanged(model, SIGNAL(dataChanged(QModelIndex, QModelIndex)));
+
+    db->beginBatchUpdate();
+    entries[1]->setTitle("batch1");
+    entries[3]->setTitle("batch3");
+    entries[3]->setUsername("batch3");
+    QCOMPARE(spyDataChanged.count(), 0);
+    db->endBatchUpdate();
+
+    // All changes are reported at once, covering the changed rows
+    QCOMPARE(spyDataChanged.count(), 1);
+    QCOMPARE(spyDataChanged.first().at(0).toModelIndex().row(), 1);
+    QCOMPARE(spyDataChanged.first().at(1).toModelIndex().row(), 3);
+    QCOMPARE(model->data(model->index(1, 1)).toString(), QString("batch1"));
+
+    // Outside of a batch every change is reported on its own
+    entries[0]->setTitle("single");
+    QCOMPARE(spyDataChanged.count(), 2);
+
+    delete db;
+    delete modelTest;
+    delete model;
+}
+
+void TestEntryModel::testIncrementalUpdate()
+{
+    auto model = new EntryModel(this);
+    auto modelTest = new ModelTest(model, this);
+
+    QScopedPointer<Database> db(new Database());
+    QList<Entry*> entries;
+    for (int i = 0; i < 10; ++i) {
+        auto entry = new Entry();
+        entry->setGroup(db->rootGroup());
+        entry->setTitle(QString("Entry %1").arg(i));
+        entries << entry;
+    }
+
+    model->setEntries(entries.mid(0, 6));
+    QCOMPARE(model->rowCount(), 6);
+
+    QSignalSpy spyReset(model, SIGNAL(modelReset()));
+    QSignalSpy spyRemoved(model, SIGNAL(rowsRemoved(QModelIndex, int, int)));
+    QSignalSpy spyInserted(model, SIGNAL(rowsInserted(QModelIndex, int, int)));
+
+    // Refreshing with the same results does not touch the rows
+    model->setEntries(entries.mid(0, 6));
+    QCOMPARE(spyReset.count(), 0);
+    QCOMPARE(spyRemoved.count(), 0);
+    QCOMPARE(spyInserted.count(), 0);
+
+    // Entries 1 and 2 removed as one run, entry 4 removed, entries 6 to 8 inserted as one run
+    QList<Entry*> refined{entries[0], entries[3], entries[5], entries[6], entries[7], entries[8]};
+    model->setEntries(refined);
+    QCOMPARE(spyReset.count(), 0);
+    QCOMPARE(spyRemoved.count(), 2);
+    QCOMPARE(spyInserted.count(), 1);
+    QCOMPARE(spyInserted.first().at(1).toInt(), 3);
+    QCOMPARE(spyInserted.first().at(2).toInt(), 5);
+    QCOMPARE(model->rowCount(), refined.size());
+    for (int row = 0; row < refined.size(); ++row) {
+        QCOMPARE(model->entryFromIndex(model->index(row, 1)), refined[row]);
+    }
+
+    // Changing the order of the kept entries resets the model
+    model->setEntries({entries[3], entries[0]});
+    QCOMPARE(spyReset.count(), 1);
+    QCOMPARE(model->rowCount(), 2);
+
+    // Switching to a group keeps the shared rows
+    model->setEntries({entries[0], entries[3]});
+    QCOMPARE(spyReset.count(), 2);
+    model->setGroup(db->rootGroup());
+    QCOMPARE(spyReset.count(), 2);
+    QCOMPARE(model->rowCount(), entries.size());
+
+    // Changes scattered over many runs reset the model instead
+    QList<Entry*> scattered;
+    for (int i = 0; i < 200; ++i) {
+        auto entry = new Entry();
+        entry->setGroup(db->rootGroup());
+        scattered << entry;
+    }
+    QList<Entry*> interleaved;
+    for (int i = 0; i < scattered.size(); i += 2) {
+        interleaved << scattered[i];
+    }
+    model->setEntries(scattered);
+    spyReset.clear();
+    spyRemoved.clear();
+    model->setEntries(interleaved);
+    QCOMPARE(spyReset.count(), 1);
+    QCOMPARE(spyRemoved.count(), 0);
+    QCOMPARE(model->rowCount(), interleaved.size());
+
+    delete modelTest;
+    delete model;
+}
+
+void TestEntryModel::benchmarkSearchRefresh_data()
+{
+    QTest::addColumn<bool>("reset");
+
+    QTest::newRow("Update") << false;
+    QTest::newRow("Reset") << true;
+}
+
+void TestEntryModel::benchmarkSearchRefresh()
+{
+    QFETCH(bool, reset);
+
+    QByteArray env = qgetenv("BENCHMARK");
+
+    if (env.isEmpty() || env == "0" || env == "no") {
+        QSKIP("Benchmark skipped. Set env variable BENCHMARK=1 to enable.");
+    }
+
+    QScopedPointer<Database> db(new Database());
+    for (int i = 0; i < 50000; ++i) {
+        auto entry = new Entry();
+        entry->setGroup(db->rootGroup());
+        entry->setTitle(QString("Entry %1").arg(i));
+        entry->setUsername(QString("user%1").arg(i % 100));
+    }
+
+    auto model = new EntryModel(this);
+    QSortFilterProxyModel proxy;
+    proxy.setSourceModel(model);
+    proxy.sort(EntryModel::Title);
+
+    EntrySearcher searcher;
+    model->setEntries(searcher.search("user1", db->rootGroup()));
+
+    // Alternate between a broad and a narrower search as typing would do. The results
+    // interleave, so compare the incremental update against clearing the model first.
+    bool narrow = false;
+    QBENCHMARK
+    {
+        narrow = !narrow;
+        const auto results = searcher.search(narrow ? "user12" : "user1", db->rootGroup());
+        if (reset) {
+            model->setEntries({});
+        }
+        model->setEntries(results);
+    }
+
+    delete model;
+}
+
+void TestEntryModel::testBatchUpdateRows()
+{
+    auto model = new EntryModel(this);
+    auto modelTest = new ModelTest(model, this);
+
+    auto db = new Database();
+    auto group = db->rootGroup();
+    auto other = new Group();
+    other->setParent(group);
+    QList<Entry*> entries;
+    for (int i = 0; i < 3; ++i) {
+        auto entry = new Entry();
+        entry->setGroup(group);
+        entries << entry;
+    }
+
+    model->setGroup(group);
+    QCOMPARE(model->rowCount(), 3);
+
+    QSignalSpy spyReset(model, SIGNAL(modelReset()));
+    QSignalSpy spyInserted(model, SIGNAL(rowsInserted(QModelIndex, int, int)));
+    QSignalSpy spyRemoved(model, SIGNAL(rowsRemoved(QModelIndex, int, int)));
+    QSignalSpy spyDataChanged(model, SIGNAL(dataChanged(QModelIndex, QModelIndex)));
+
+    db->beginBatchUpdate();
+    for (int i = 0; i < 5; ++i) {
+        auto entry = new Entry();
+        entry->setGroup(group);
+        entry->setTitle(QString("Entry %1").arg(i));
+    }
+    entries[0]->setGroup(other);
+    entries[1]->setTitle("changed");
+    QCOMPARE(spyReset.count(), 0);
+    db->endBatchUpdate();
+
+    // Row changes are reported as a single reset that covers data changes too
+    QCOMPARE(spyReset.count(), 1);
+    QCOMPARE(spyInserted.count(), 0);
+    QCOMPARE(spyRemoved.count(), 0);
+    QCOMPARE(spyDataChanged.count(), 0);
+    QCOMPARE(model->rowCount(), 7);
+
+    delete db;
+    delete modelTest;
+    delete model;
+}
@@ -34,6 +34,11 @@ private slots:
     void testAutoTypeAssociationsModel();
     void testProxyModel();
     void testDatabaseDelete();
+    void testBatchUpdate();
+    void testBatchUpdateRows();
+    void testIncrementalUpdate();
+    void benchmarkSearchRefresh_data();
+    void benchmarkSearchRefresh();
 };
 
 #endif // KEEPASSX_TESTENTRYMODEL_H
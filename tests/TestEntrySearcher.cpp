@@ -394,3 +394,81 @@ void TestEntrySearcher::testUUIDSearch()
     m_searchResult = m_entrySearcher.search("uuid:" + Tools::uuidToHex(uuid1), m_rootGroup);
     QCOMPARE(m_searchResult.count(), 1);
 }
+
+void TestEntrySearcher::testSearchPlan()
+{
+    auto entry = new Entry();
+    entry->setGroup(m_rootGroup);
+    entry->setTitle("Example.com Login");
+    entry->setUsername("alice");
+    entry->setNotes("first line\nsecond line");
+    entry->setTags("work;Mail");
+    entry->attributes()->set("custom", "value (1)");
+
+    // Literal terms are matched as plain text and ordered by cost
+    m_entrySearcher.searchEntries("example.com +user:alice notes:line -tag:home", {entry});
+    QCOMPARE(m_entrySearcher.searchPlan(),
+             QStringList({R"(notes contains "line" (cost 1))",
+                          R"(tag not equals "home" (cost 1))",
+                          R"(username equals "alice" (cost 2))",
+                          R"(any contains "example.com" (cost 8))"}));
+    QCOMPARE(m_entrySearcher.searchEntries("example.com +user:alice notes:line -tag:home", {entry}).size(), 1);
+
+    // Wildcards and regular expressions fall back to regex matching
+    m_entrySearcher.searchEntries("exa*le *title:^Example", {entry});
+    auto plan = m_entrySearcher.searchPlan();
+    QCOMPARE(plan.size(), 2);
+    QVERIFY(plan[0].startsWith("title matches"));
+    QVERIFY(plan[1].startsWith("any matches"));
+    QCOMPARE(m_entrySearcher.searchEntries("exa*le *title:^Example", {entry}).size(), 1);
+    QCOMPARE(m_entrySearcher.searchEntries("*title:^Login", {entry}).size(), 0);
+
+    // Plain text matching keeps the semantics of the regex it replaces
+    QCOMPARE(m_entrySearcher.searchEntries("EXAMPLE.COM", {entry}).size(), 1);
+    QCOMPARE(m_entrySearcher.searchEntries("examplexcom", {entry}).size(), 0);
+    QCOMPARE(m_entrySearcher.searchEntries("+title:example.com", {entry}).size(), 0);
+    QCOMPARE(m_entrySearcher.searchEntries("+title:\"example.com login\"", {entry}).size(), 1);
+    QCOMPARE(m_entrySearcher.searchEntries("attr:\"(1)\"", {entry}).size(), 1);
+    QCOMPARE(m_entrySearcher.searchEntries("_custom:\"e (1\"", {entry}).size(), 1);
+    QCOMPARE(m_entrySearcher.searchEntries("tag:mail", {entry}).size(), 1);
+    QCOMPARE(m_entrySearcher.searchEntries("tag:mai", {entry}).size(), 0);
+    QCOMPARE(m_entrySearcher.searchEntries("tag:mai?", {entry}).size(), 1);
+    QCOMPARE(m_entrySearcher.searchEntries("work", {entry}).size(), 1);
+    QCOMPARE(m_entrySearcher.searchEntries("-tag:work", {entry}).size(), 0);
+
+    m_entrySearcher.setCaseSensitive(true);
+    QCOMPARE(m_entrySearcher.searchEntries("EXAMPLE", {entry}).size(), 0);
+    QCOMPARE(m_entrySearcher.searchEntries("Example", {entry}).size(), 1);
+    QCOMPARE(m_entrySearcher.searchEntries("tag:mail", {entry}).size(), 0);
+    QCOMPARE(m_entrySearcher.searchEntries("tag:Mail", {entry}).size(), 1);
+}
+
+void TestEntrySearcher::benchmarkSearch()
+{
+    QByteArray env = qgetenv("BENCHMARK");
+    if (env.isEmpty() || env == "0" || env == "no") {
+        QSKIP("Benchmark skipped. Set env variable BENCHMARK=1 to enable.");
+    }
+
+    for (int i = 0; i < 10000; ++i) {
+        auto group = new Group();
+        group->setName(QString("Group %1").arg(i / 100));
+        group->setParent(m_rootGroup);
+        auto entry = new Entry();
+        entry->setGroup(group);
+        entry->setTitle(QString("Entry %1").arg(i));
+        entry->setUsername(QString("user%1@example.com").arg(i % 50));
+        entry->setUrl(QString("https://site%1.example.com/login").arg(i));
+        entry->setNotes(QString("Notes for entry %1").arg(i));
+        entry->setTags(i % 10 == 0 ? "work" : "home");
+        entry->attributes()->set("custom", QString("value %1").arg(i));
+    }
+
+    const QString searchString = "example.com -tag:work user:user1 group:/group";
+    QBENCHMARK
+    {
+        m_searchResult = m_entrySearcher.search(searchString, m_rootGroup);
+    }
+    QCOMPARE(m_searchResult.size(), 2000);
+    qDebug() << m_entrySearcher.searchPlan() << m_entrySearcher.lastSearchTime() << "ns";
+}
@@ -39,6 +39,8 @@ private slots:
     void testGroup();
     void testSkipProtected();
     void testUUIDSearch();
+    void testSearchPlan();
+    void benchmarkSearch();
 
 private:
     Group* m_rootGroup;
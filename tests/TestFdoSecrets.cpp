@@ -17,7 +17,7 @@
 
 #include "TestFdoSecrets.h"
 
-#include "core/EntrySearcher.h"
+#include "core/Database.h"
 #include "core/Group.h"
 #include "crypto/Random.h"
 #include "fdosecrets/objects/Collection.h"
@@ -36,7 +36,6 @@ void TestFdoSecrets::testDhIetf1024Sha256Aes128CbcPkcs7()
 void TestFdoSecrets::testCrazyAttributeKey()
 {
     using FdoSecrets::Collection;
-    using FdoSecrets::Item;
 
     const QScopedPointer<Group> root(new Group());
     const QScopedPointer<Entry> e1(new Entry());
@@ -46,47 +45,49 @@ void TestFdoSecrets::testCrazyAttributeKey()
     const QString value = "value";
     e1->attributes()->set(key, value);
 
-    // search for custom entries
-    const auto term = Collection::attributeToTerm(key, value);
-    const auto res = EntrySearcher().search({term}, root.data());
-    QCOMPARE(res.count(), 1);
+    // custom attributes are matched by their exact key
+    bool isVolatile = true;
+    const auto attrs = Collection::searchableAttributes(e1.data(), isVolatile);
+    QVERIFY(!isVolatile);
+    QCOMPARE(attrs.value(key), value);
 }
 
 void TestFdoSecrets::testSpecialCharsInAttributeValue()
 {
     using FdoSecrets::Collection;
-    using FdoSecrets::Item;
 
-    const QScopedPointer<Group> root(new Group());
+    // references are only resolved within a database
+    Database db;
+    auto* root = db.rootGroup();
     QScopedPointer<Entry> e1(new Entry());
-    e1->setGroup(root.data());
+    e1->setGroup(root);
 
     e1->setTitle("titleA");
+    e1->setPassword("secret");
     e1->attributes()->set("testAttribute", "OAuth::[test.name@gmail.com]");
+    e1->attributes()->set("protectedAttribute", "hidden", true);
 
     QScopedPointer<Entry> e2(new Entry());
-    e2->setGroup(root.data());
-    e2->setTitle("titleB");
+    e2->setGroup(root);
+    e2->setTitle("{REF:T@I:" + e1->uuidToHex() + "}");
     e2->attributes()->set("testAttribute", "Abc:*+.-");
 
-    // search for custom entries via programmatic API
-    {
-        const auto term = Collection::attributeToTerm("testAttribute", "OAuth::[test.name@gmail.com]");
-        const auto res = EntrySearcher().search({term}, root.data());
-        QCOMPARE(res.count(), 1);
-        QCOMPARE(res[0]->title(), QStringLiteral("titleA"));
-    }
-    {
-        const auto term = Collection::attributeToTerm("testAttribute", "Abc:*+.-");
-        const auto res = EntrySearcher().search({term}, root.data());
-        QCOMPARE(res.count(), 1);
-        QCOMPARE(res[0]->title(), QStringLiteral("titleB"));
-    }
-    {
-        const auto term = Collection::attributeToTerm("testAttribute", "v|");
-        const auto res = EntrySearcher().search({term}, root.data());
-        QCOMPARE(res.count(), 0);
-    }
+    // values are matched verbatim, not as patterns
+    bool isVolatile = true;
+    auto attrs = Collection::searchableAttributes(e1.data(), isVolatile);
+    QVERIFY(!isVolatile);
+    QCOMPARE(attrs.value("testAttribute"), QStringLiteral("OAuth::[test.name@gmail.com]"));
+    QCOMPARE(attrs.value(EntryAttributes::TitleKey), QStringLiteral("titleA"));
+
+    // the password and protected attributes can not be searched
+    QVERIFY(!attrs.contains(EntryAttributes::PasswordKey));
+    QVERIFY(!attrs.contains("protectedAttribute"));
+
+    // references are resolved, the entry has to be matched directly
+    attrs = Collection::searchableAttributes(e2.data(), isVolatile);
+    QVERIFY(isVolatile);
+    QCOMPARE(attrs.value("testAttribute"), QStringLiteral("Abc:*+.-"));
+    QCOMPARE(attrs.value(EntryAttributes::TitleKey), QStringLiteral("titleA"));
 }
 
 void TestFdoSecrets::testDBusPathParse()
@@ -21,6 +21,7 @@
 
 #include <QSet>
 #include <QSignalSpy>
+#include <QtConcurrent>
 #include <QtTestGui>
 
 #include "core/Group.h"
@@ -1023,6 +1024,63 @@ void TestGroup::testHierarchy()
     QVERIFY(hierarchy.contains("group3"));
 }
 
+void TestGroup::testHierarchyCache()
+{
+    Database db;
+    auto root = db.rootGroup();
+    root->setName("root");
+
+    auto group1 = new Group();
+    group1->setName("group1");
+    group1->setParent(root);
+
+    auto group2 = new Group();
+    group2->setName("group2");
+    group2->setParent(group1);
+
+    auto group3 = new Group();
+    group3->setName("group3");
+    group3->setParent(group2);
+
+    auto entry = new Entry();
+    entry->setTitle("entry");
+    entry->setGroup(group3);
+
+    QCOMPARE(group3->hierarchy(), QStringList({"root", "group1", "group2", "group3"}));
+    QCOMPARE(group3->fullPath(), QString("/root/group1/group2/group3"));
+    QCOMPARE(group2->fullPath(), QString("/root/group1/group2"));
+    QCOMPARE(entry->path(), QString("group1/group2/group3/entry"));
+
+    // Renaming an ancestor updates all descendants
+    group1->setName("renamed");
+    QCOMPARE(group3->hierarchy(), QStringList({"root", "renamed", "group2", "group3"}));
+    QCOMPARE(group3->fullPath(), QString("/root/renamed/group2/group3"));
+    QCOMPARE(entry->path(), QString("renamed/group2/group3/entry"));
+
+    root->setName("db");
+    QCOMPARE(group3->fullPath(), QString("/db/renamed/group2/group3"));
+    QCOMPARE(group3->hierarchy(2), QStringList({"group2", "group3"}));
+
+    // Moving a group updates its subtree only
+    group2->setParent(root);
+    QCOMPARE(group3->hierarchy(), QStringList({"db", "group2", "group3"}));
+    QCOMPARE(group3->fullPath(), QString("/db/group2/group3"));
+    QCOMPARE(group1->fullPath(), QString("/db/renamed"));
+    QCOMPARE(entry->path(), QString("group2/group3/entry"));
+
+    Group other;
+    other.setName("group1");
+    group1->copyDataFrom(&other);
+    QCOMPARE(group1->fullPath(), QString("/db/group1"));
+
+    // A group moved into another database takes the path of its new parent
+    Database db2;
+    db2.rootGroup()->setName("other");
+    group2->setParent(db2.rootGroup());
+    QCOMPARE(group3->fullPath(), QString("/other/group2/group3"));
+    QCOMPARE(group3->hierarchy(), QStringList({"other", "group2", "group3"}));
+}
+
 void TestGroup::testApplyGroupIconRecursively()
 {
     // Create a database with two nested groups with one entry each
@@ -1319,3 +1377,142 @@ void TestGroup::testAutoTypeState()
     QVERIFY(!entry1->groupAutoTypeEnabled());
     QVERIFY(entry2->groupAutoTypeEnabled());
 }
+
+void TestGroup::testResolvedSettingsCache()
+{
+    Database db;
+    auto* root = db.rootGroup();
+
+    auto* group1 = new Group();
+    group1->setParent(root);
+    auto* group2 = new Group();
+    group2->setParent(group1);
+    auto* group3 = new Group();
+    group3->setParent(group2);
+    auto* other = new Group();
+    other->setParent(root);
+
+    const QString key = QStringLiteral("BrowserHideEntries");
+
+    // Populate the caches
+    QVERIFY(group3->resolveSearchingEnabled());
+    QVERIFY(group3->resolveAutoTypeEnabled());
+    QCOMPARE(group3->resolveCustomDataTriState(key), Group::Inherit);
+
+    // Changing a setting of a parent group invalidates its descendants
+    group1->setSearchingEnabled(Group::Disable);
+    group1->setAutoTypeEnabled(Group::Disable);
+    QVERIFY(!group3->resolveSearchingEnabled());
+    QVERIFY(!group3->resolveAutoTypeEnabled());
+    QVERIFY(other->resolveSearchingEnabled());
+
+    root->setSearchingEnabled(Group::Disable);
+    QVERIFY(!other->resolveSearchingEnabled());
+    root->setSearchingEnabled(Group::Inherit);
+    QVERIFY(other->resolveSearchingEnabled());
+
+    // The root group caches nothing itself, its changes still reach cached grandchildren
+    QVERIFY(!group3->resolveAutoTypeEnabled());
+    group1->setAutoTypeEnabled(Group::Inherit);
+    QVERIFY(group3->resolveAutoTypeEnabled());
+    root->setAutoTypeEnabled(Group::Disable);
+    QVERIFY(!group3->resolveAutoTypeEnabled());
+    root->setAutoTypeEnabled(Group::Inherit);
+    QVERIFY(group3->resolveAutoTypeEnabled());
+    group1->setAutoTypeEnabled(Group::Disable);
+
+    // Overriding the setting in between stops the inheritance
+    group2->setSearchingEnabled(Group::Enable);
+    QVERIFY(group3->resolveSearchingEnabled());
+    group2->setSearchingEnabled(Group::Inherit);
+    QVERIFY(!group3->resolveSearchingEnabled());
+
+    // Moving a group picks up the settings of its new parent
+    group3->setParent(other);
+    QVERIFY(group3->resolveSearchingEnabled());
+    QVERIFY(group3->resolveAutoTypeEnabled());
+    group3->setParent(group2);
+    QVERIFY(!group3->resolveSearchingEnabled());
+
+    // Moving a parent group invalidates the whole subtree
+    group2->setParent(other);
+    QVERIFY(group3->resolveSearchingEnabled());
+    QVERIFY(group3->resolveAutoTypeEnabled());
+
+    // Custom data changes are picked up, including value changes
+    root->customData()->set(key, "true");
+    QCOMPARE(group3->resolveCustomDataTriState(key), Group::Enable);
+    QCOMPARE(group3->resolveCustomDataString(key), QString("true"));
+    root->customData()->set(key, "false");
+    QCOMPARE(group3->resolveCustomDataTriState(key), Group::Disable);
+    other->customData()->set(key, "true");
+    QCOMPARE(group3->resolveCustomDataTriState(key), Group::Enable);
+    QCOMPARE(group3->resolveCustomDataTriState(key, false), Group::Inherit);
+    other->customData()->remove(key);
+    QCOMPARE(group3->resolveCustomDataTriState(key), Group::Disable);
+    root->customData()->clear();
+    QCOMPARE(group3->resolveCustomDataTriState(key), Group::Inherit);
+    QCOMPARE(group3->resolveCustomDataString(key), QString());
+
+    // Renaming a key and changes made while the modified signal is disabled are picked up as well
+    root->customData()->set(QStringLiteral("OtherKey"), "true");
+    QCOMPARE(group3->resolveCustomDataTriState(key), Group::Inherit);
+    root->customData()->rename(QStringLiteral("OtherKey"), key);
+    QCOMPARE(group3->resolveCustomDataTriState(key), Group::Enable);
+    root->setEmitModified(false);
+    root->customData()->set(key, "false");
+    QCOMPARE(group3->resolveCustomDataTriState(key), Group::Disable);
+    root->setEmitModified(true);
+    root->customData()->clear();
+
+    // Other threads resolve the settings without touching the caches
+    group1->setName(QStringLiteral("Group1"));
+    QCOMPARE(QtConcurrent::run([group3] { return group3->hierarchy(); }).result(), group3->hierarchy());
+    QCOMPARE(QtConcurrent::run([group3] { return group3->fullPath(); }).result(), group3->fullPath());
+    QCOMPARE(QtConcurrent::run([group3] { return group3->resolveSearchingEnabled(); }).result(),
+             group3->resolveSearchingEnabled());
+    root->customData()->set(key, "true");
+    QCOMPARE(QtConcurrent::run([group3, key] { return group3->resolveCustomDataTriState(key); }).result(),
+             Group::Enable);
+    root->customData()->clear();
+
+    // Copying the data of another group also invalidates the cache
+    Group source;
+    source.setSearchingEnabled(Group::Disable);
+    other->copyDataFrom(&source);
+    QVERIFY(!group3->resolveSearchingEnabled());
+}
+
+void TestGroup::benchmarkResolveSettings()
+{
+    QByteArray env = qgetenv("BENCHMARK");
+    if (env.isEmpty() || env == "0" || env == "no") {
+        QSKIP("Benchmark skipped. Set env variable BENCHMARK=1 to enable.");
+    }
+
+    Database db;
+    auto* root = db.rootGroup();
+    root->setAutoTypeEnabled(Group::Disable);
+    root->customData()->set(QStringLiteral("BrowserHideEntries"), "true");
+
+    // 250 chains of 20 nested groups
+    QList<Group*> groups;
+    for (int i = 0; i < 250; ++i) {
+        Group* parent = root;
+        for (int depth = 0; depth < 20; ++depth) {
+            auto* group = new Group();
+            group->setParent(parent);
+            groups.append(group);
+            parent = group;
+        }
+    }
+
+    QBENCHMARK
+    {
+        for (const auto* group : asConst(groups)) {
+            QVERIFY(group->resolveSearchingEnabled());
+            QVERIFY(!group->resolveAutoTypeEnabled());
+            QCOMPARE(group->resolveCustomDataTriState(QStringLiteral("BrowserHideEntries")), Group::Enable);
+        }
+    }
+}
@@ -45,11 +45,14 @@ private slots:
     void testEquals();
     void testChildrenSort();
     void testHierarchy();
+    void testHierarchyCache();
     void testApplyGroupIconRecursively();
     void testUsernamesRecursive();
     void testMoveUpDown();
     void testPreviousParentGroup();
     void testAutoTypeState();
+    void testResolvedSettingsCache();
+    void benchmarkResolveSettings();
 };
 
 #endif // KEEPASSX_TESTGROUP_H
@@ -0,0 +1,291 @@
+/*
+ *  Copyright (C) 2024 KeePassXC Team <team@keepassxc.org>
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 2 or (at your option)
+ *  version 3 of the License.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "TestHibpDownloader.h"
+
+#include "core/HibpDownloader.h"
+
+#include <QCryptographicHash>
+#include <QDir>
+#include <QFileInfo>
+#include <QSet>
+#include <QSignalSpy>
+#include <QTcpSocket>
+#include <QTest>
+
+QTEST_GUILESS_MAIN(TestHibpDownloader)
+
+namespace
+{
+    QString sha1Hex(const QString& password)
+    {
+        return QCryptographicHash::hash(password.toUtf8(), QCryptographicHash::Sha1).toHex().toUpper();
+    }
+
+    QHash<QString, int> results(const QSignalSpy& spy)
+    {
+        QHash<QString, int> results;
+        for (const auto& args : spy) {
+            results.insert(args.at(0).toString(), args.at(1).toInt());
+        }
+        return results;
+    }
+} // namespace
+
+void TestHibpDownloader::initTestCase()
+{
+    connect(&m_server, &QTcpServer::newConnection, this, [this] {
+        while (auto socket = m_server.nextPendingConnection()) {
+            connect(socket, &QTcpSocket::readyRead, this, [this, socket] { handleRequest(socket); });
+            connect(socket, &QTcpSocket::disconnected, socket, &QObject::deleteLater);
+        }
+    });
+    QVERIFY(m_server.listen(QHostAddress::LocalHost));
+}
+
+void TestHibpDownloader::init()
+{
+    m_ranges.clear();
+    m_requests.clear();
+    m_heldSockets.clear();
+    m_holdResponses = false;
+    m_status = 200;
+    m_cacheDir.reset(new QTemporaryDir());
+    QVERIFY(m_cacheDir->isValid());
+}
+
+void TestHibpDownloader::cleanup()
+{
+    for (const auto& socket : m_heldSockets) {
+        if (socket) {
+            socket->abort();
+        }
+    }
+}
+
+void TestHibpDownloader::addPwned(const QString& password, int count)
+{
+    const auto hash = sha1Hex(password);
+    m_ranges[hash.left(5)] += hash.mid(5).toLatin1() + ":" + QByteArray::number(count) + "\r\n";
+}
+
+void TestHibpDownloader::configure(HibpDownloader& downloader)
+{
+    downloader.setApiUrl(QString("http://127.0.0.1:%1/range/").arg(m_server.serverPort()));
+    downloader.setCacheDirectory(m_cacheDir->path());
+}
+
+void TestHibpDownloader::handleRequest(QTcpSocket* socket)
+{
+    const auto request = socket->property("request").toByteArray() + socket->readAll();
+    socket->setProperty("request", request);
+    if (!request.contains("\r\n\r\n")) {
+        return;
+    }
+
+    // Request line: GET /range/<prefix> HTTP/1.1
+    const auto path = request.split(' ').value(1);
+    const auto prefix = QString::fromLatin1(path.mid(path.lastIndexOf('/') + 1));
+    socket->setProperty("prefix", prefix);
+    m_requests << prefix;
+
+    if (m_holdResponses) {
+        m_heldSockets << socket;
+    } else {
+        respond(socket);
+    }
+}
+
+void TestHibpDownloader::respond(QTcpSocket* socket)
+{
+    const auto body = m_status == 200 ? m_ranges.value(socket->property("prefix").toString()) : QByteArray("error");
+    socket->write("HTTP/1.1 " + QByteArray::number(m_status) + (m_status == 200 ? " OK" : " Error")
+                  + "\r\nContent-Type: text/plain\r\nContent-Length: " + QByteArray::number(body.size())
+                  + "\r\nConnection: close\r\n\r\n" + body);
+    socket->disconnectFromHost();
+}
+
+void TestHibpDownloader::testGroupedPrefixes()
+{
+    // Find two passwords sharing the first five characters of their hash
+    QHash<QString, QString> byPrefix;
+    QString first;
+    QString second;
+    for (int i = 0; second.isEmpty(); ++i) {
+        const auto password = QString("password%1").arg(i);
+        const auto prefix = sha1Hex(password).left(5);
+        if (byPrefix.contains(prefix)) {
+            first = byPrefix.value(prefix);
+            second = password;
+        }
+        byPrefix.insert(prefix, password);
+    }
+
+    addPwned(first, 12);
+    addPwned(second, 34);
+
+    HibpDownloader downloader;
+    configure(downloader);
+    QSignalSpy spy(&downloader, &HibpDownloader::hibpResult);
+
+    downloader.add(first);
+    downloader.add(second);
+    downloader.add("not pwned");
+    QCOMPARE(downloader.passwordsToValidate(), 3);
+    downloader.validate();
+    QCOMPARE(downloader.passwordsRemaining(), 3);
+    QCOMPARE(spy.count(), 0);
+
+    QTRY_COMPARE(downloader.passwordsRemaining(), 0);
+    QCOMPARE(m_requests.size(), 2);
+    QVERIFY(m_requests.contains(sha1Hex(first).left(5)));
+    QVERIFY(m_requests.contains(sha1Hex("not pwned").left(5)));
+
+    const auto found = results(spy);
+    QCOMPARE(found.size(), 3);
+    QCOMPARE(found.value(first), 12);
+    QCOMPARE(found.value(second), 34);
+    QCOMPARE(found.value("not pwned", -1), 0);
+}
+
+void TestHibpDownloader::testCache()
+{
+    addPwned("foo", 123);
+
+    {
+        HibpDownloader downloader;
+        configure(downloader);
+        downloader.add("foo");
+        downloader.add("bar");
+        downloader.validate();
+        QTRY_COMPARE(downloader.passwordsRemaining(), 0);
+    }
+    QCOMPARE(m_requests.size(), 2);
+    QVERIFY(QDir(m_cacheDir->path()).exists(sha1Hex("foo").left(5)));
+
+    // Checking again only queries passwords that were not checked before
+    HibpDownloader downloader;
+    configure(downloader);
+    QSignalSpy spy(&downloader, &HibpDownloader::hibpResult);
+    downloader.add("foo");
+    downloader.add("bar");
+    downloader.add("baz");
+    downloader.validate();
+    QCOMPARE(spy.count(), 0);
+    QTRY_COMPARE(downloader.passwordsRemaining(), 0);
+    QCOMPARE(m_requests.size(), 3);
+    QCOMPARE(m_requests.last(), sha1Hex("baz").left(5));
+
+    auto found = results(spy);
+    QCOMPARE(found.size(), 3);
+    QCOMPARE(found.value("foo"), 123);
+    QCOMPARE(found.value("bar", -1), 0);
+
+    // Expired responses are queried again
+    spy.clear();
+    downloader.setCacheExpiry(0);
+    downloader.add("foo");
+    downloader.validate();
+    QTRY_COMPARE(downloader.passwordsRemaining(), 0);
+    QCOMPARE(m_requests.size(), 4);
+    QCOMPARE(results(spy).value("foo"), 123);
+
+#ifdef Q_OS_UNIX
+    // The cache directory and the cached prefixes are only accessible by the owner
+    const auto groupOrOther = QFile::ReadGroup | QFile::WriteGroup | QFile::ExeGroup | QFile::ReadOther
+                              | QFile::WriteOther | QFile::ExeOther;
+    const QString cacheSubDir = m_cacheDir->path() + "/sub";
+    downloader.setCacheDirectory(cacheSubDir);
+    downloader.setCacheExpiry(HibpDownloader::DefaultCacheExpiry);
+    downloader.add("foo");
+    downloader.validate();
+    QTRY_COMPARE(downloader.passwordsRemaining(), 0);
+    QCOMPARE(QFileInfo(cacheSubDir).permissions() & groupOrOther, QFile::Permissions());
+    QCOMPARE(QFileInfo(cacheSubDir + "/" + sha1Hex("foo").left(5)).permissions() & groupOrOther, QFile::Permissions());
+#endif
+}
+
+void TestHibpDownloader::testCacheDisabledByDefault()
+{
+    addPwned("foo", 123);
+
+    HibpDownloader downloader;
+    downloader.setApiUrl(QString("http://127.0.0.1:%1/range/").arg(m_server.serverPort()));
+    QSignalSpy spy(&downloader, &HibpDownloader::hibpResult);
+    for (int i = 0; i < 2; ++i) {
+        downloader.add("foo");
+        downloader.validate();
+        QTRY_COMPARE(downloader.passwordsRemaining(), 0);
+    }
+
+    // Every check is sent to the server
+    QCOMPARE(m_requests.size(), 2);
+    QCOMPARE(spy.count(), 2);
+    QCOMPARE(results(spy).value("foo"), 123);
+}
+
+void TestHibpDownloader::testRequestLimit()
+{
+    m_holdResponses = true;
+
+    HibpDownloader downloader;
+    configure(downloader);
+    QSignalSpy spy(&downloader, &HibpDownloader::hibpResult);
+
+    QSet<QString> prefixes;
+    for (int i = 0; prefixes.size() < HibpDownloader::MaxRequests * 3; ++i) {
+        const auto password = QString("password%1").arg(i);
+        if (!prefixes.contains(sha1Hex(password).left(5))) {
+            prefixes.insert(sha1Hex(password).left(5));
+            downloader.add(password);
+        }
+    }
+    downloader.validate();
+
+    QTRY_COMPARE(m_heldSockets.size(), HibpDownloader::MaxRequests);
+    QTest::qWait(100);
+    QCOMPARE(m_heldSockets.size(), HibpDownloader::MaxRequests);
+
+    // Each answered request makes room for the next one
+    m_holdResponses = false;
+    const auto held = m_heldSockets;
+    for (const auto& socket : held) {
+        respond(socket);
+    }
+    QTRY_COMPARE(downloader.passwordsRemaining(), 0);
+    QCOMPARE(spy.count(), prefixes.size());
+    QCOMPARE(m_requests.size(), prefixes.size());
+}
+
+void TestHibpDownloader::testFailure()
+{
+    m_status = 503;
+
+    HibpDownloader downloader;
+    configure(downloader);
+    QSignalSpy spyResult(&downloader, &HibpDownloader::hibpResult);
+    QSignalSpy spyFailed(&downloader, &HibpDownloader::fetchFailed);
+
+    downloader.add("foo");
+    downloader.validate();
+    QTRY_COMPARE(spyFailed.count(), 1);
+    QCOMPARE(spyResult.count(), 0);
+    QCOMPARE(downloader.passwordsRemaining(), 0);
+
+    // Failed responses are not cached
+    QVERIFY(!QDir(m_cacheDir->path()).exists(sha1Hex("foo").left(5)));
+}
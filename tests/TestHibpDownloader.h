@@ -0,0 +1,61 @@
+/*
+ *  Copyright (C) 2024 KeePassXC Team <team@keepassxc.org>
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 2 or (at your option)
+ *  version 3 of the License.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef KEEPASSXC_TESTHIBPDOWNLOADER_H
+#define KEEPASSXC_TESTHIBPDOWNLOADER_H
+
+#include <QHash>
+#include <QObject>
+#include <QPointer>
+#include <QTcpServer>
+#include <QTemporaryDir>
+
+class HibpDownloader;
+class QTcpSocket;
+
+class TestHibpDownloader : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void initTestCase();
+    void init();
+    void cleanup();
+    void testGroupedPrefixes();
+    void testCache();
+    void testCacheDisabledByDefault();
+    void testRequestLimit();
+    void testFailure();
+
+private:
+    void addPwned(const QString& password, int count);
+    void configure(HibpDownloader& downloader);
+    void handleRequest(QTcpSocket* socket);
+    void respond(QTcpSocket* socket);
+
+    // Stand-in for the range API of the HIBP service
+    QTcpServer m_server;
+    QHash<QString, QByteArray> m_ranges;
+    QStringList m_requests;
+    QList<QPointer<QTcpSocket>> m_heldSockets;
+    bool m_holdResponses = false;
+    int m_status = 200;
+
+    QScopedPointer<QTemporaryDir> m_cacheDir;
+};
+
+#endif // KEEPASSXC_TESTHIBPDOWNLOADER_H
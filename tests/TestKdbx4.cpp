@@ -18,6 +18,7 @@
 #include "TestKdbx4.h"
 
 #include "config-keepassx-tests.h"
+#include "core/Group.h"
 #include "core/Metadata.h"
 #include "format/KdbxXmlReader.h"
 #include "format/KdbxXmlWriter.h"
@@ -33,6 +34,8 @@
 #include "mock/MockChallengeResponseKey.h"
 #include "mock/MockClock.h"
 #include <QTest>
+#include <QThread>
+#include <QThreadPool>
 
 int main(int argc, char* argv[])
 {
@@ -615,3 +618,218 @@ void TestKdbx4Format::testCustomData()
     QCOMPARE(newEntry->customData()->value(customDataKey1), customData1);
     QCOMPARE(newEntry->customData()->value(customDataKey2), customData2);
 }
+
+void TestKdbx4Format::testHistoryDataSharing()
+{
+    Database db;
+    db.changeKdf(fastKdf(KeePass2::uuidToKdf(KeePass2::KDF_ARGON2ID)));
+    db.setKey(QSharedPointer<CompositeKey>::create());
+
+    const QString notes = QString("Lorem ipsum dolor sit amet. ").repeated(1000);
+    auto* entry = new Entry();
+    entry->setUuid(QUuid::createUuid());
+    entry->setGroup(db.rootGroup());
+    entry->setTitle("History");
+    entry->setNotes(notes);
+    entry->attributes()->set("Custom", "constant value");
+
+    const int historyCount = 8;
+    for (int i = 0; i < historyCount; ++i) {
+        entry->beginUpdate();
+        entry->setPassword(QString("password%1").arg(i));
+        entry->endUpdate();
+    }
+    QCOMPARE(entry->historyItems().size(), historyCount);
+
+    QBuffer buffer;
+    buffer.open(QBuffer::ReadWrite);
+    KeePass2Writer writer;
+    QVERIFY(writer.writeDatabase(&buffer, &db));
+
+    buffer.seek(0);
+    KeePass2Reader reader;
+    auto newDb = QSharedPointer<Database>::create();
+    reader.readDatabase(&buffer, QSharedPointer<CompositeKey>::create(), newDb.data());
+    QVERIFY(!reader.hasError());
+
+    auto* newEntry = newDb->rootGroup()->findEntryByUuid(entry->uuid());
+    QVERIFY(newEntry);
+    QCOMPARE(newEntry->historyItems().size(), historyCount);
+
+    // unchanged values of history items share their storage with the current entry
+    const QString currentNotes = newEntry->notes();
+    QSet<const QChar*> distinctNotes({currentNotes.constData()});
+    qint64 totalBytes = currentNotes.size() * 2;
+    for (int i = 0; i < historyCount; ++i) {
+        const Entry* historyItem = newEntry->historyItems().at(i);
+        QCOMPARE(historyItem->notes(), notes);
+        QVERIFY(historyItem->notes().isSharedWith(currentNotes));
+        QVERIFY(historyItem->attributes()->value("Custom").isSharedWith(newEntry->attributes()->value("Custom")));
+        QCOMPARE(historyItem->password(), QString("password%1").arg(i));
+        distinctNotes.insert(historyItem->notes().constData());
+        totalBytes += historyItem->notes().size() * 2;
+    }
+    QCOMPARE(distinctNotes.size(), 1);
+    qDebug("History notes: %lld bytes held instead of %lld", totalBytes / (historyCount + 1), totalBytes);
+
+    // changing the current entry must not affect its history
+    newEntry->setNotes("changed");
+    QCOMPARE(newEntry->historyItems().first()->notes(), notes);
+}
+
+void TestKdbx4Format::testXmlScalars()
+{
+    Database db;
+    auto* entry = new Entry();
+    entry->setUpdateTimeinfo(false);
+    entry->setUuid(QUuid::createUuid());
+    entry->setGroup(db.rootGroup());
+    entry->setAutoTypeObfuscation(1);
+
+    TimeInfo timeInfo;
+    timeInfo.setCreationTime(QDateTime(QDate(1, 1, 1), QTime(0, 0, 0), Qt::UTC));
+    timeInfo.setLastModificationTime(QDateTime(QDate(2024, 2, 29), QTime(23, 59, 59), Qt::UTC));
+    timeInfo.setLastAccessTime(QDateTime(QDate(1969, 12, 31), QTime(12, 0, 0), Qt::UTC));
+    timeInfo.setExpiryTime(QDateTime(QDate(9999, 12, 31), QTime(23, 59, 59), Qt::UTC));
+    timeInfo.setExpires(true);
+    timeInfo.setUsageCount(42);
+    entry->setTimeInfo(timeInfo);
+
+    QBuffer buffer;
+    buffer.open(QBuffer::ReadWrite);
+    KdbxXmlWriter writer(KeePass2::FILE_VERSION_4, {});
+    writer.writeDatabase(&buffer, &db);
+    QVERIFY(!writer.hasError());
+
+    // Scalars split over several XML tokens have to be joined before decoding
+    const QByteArray uuid = entry->uuid().toRfc4122().toBase64();
+    QByteArray xml = buffer.data();
+    QVERIFY(xml.contains("<UUID>" + uuid + "</UUID>"));
+    xml.replace("<UUID>" + uuid + "</UUID>", "<UUID>" + uuid.left(5) + "<!-- split -->" + uuid.mid(5) + "</UUID>");
+
+    QBuffer xmlBuffer(&xml);
+    xmlBuffer.open(QBuffer::ReadOnly);
+    KdbxXmlReader reader(KeePass2::FILE_VERSION_4);
+    reader.setStrictMode(true);
+    auto newDb = reader.readDatabase(&xmlBuffer);
+    QVERIFY2(!reader.hasError(), qPrintable(reader.errorString()));
+
+    auto* newEntry = newDb->rootGroup()->findEntryByUuid(entry->uuid());
+    QVERIFY(newEntry);
+    QCOMPARE(newEntry->autoTypeObfuscation(), 1);
+    QCOMPARE(newEntry->timeInfo().creationTime(), timeInfo.creationTime());
+    QCOMPARE(newEntry->timeInfo().lastModificationTime(), timeInfo.lastModificationTime());
+    QCOMPARE(newEntry->timeInfo().lastAccessTime(), timeInfo.lastAccessTime());
+    QCOMPARE(newEntry->timeInfo().expiryTime(), timeInfo.expiryTime());
+    QCOMPARE(newEntry->timeInfo().expires(), true);
+    QCOMPARE(newEntry->timeInfo().usageCount(), 42);
+}
+
+void TestKdbx4Format::testXmlEntryCreation()
+{
+    Database db;
+    auto* group = new Group();
+    group->setUuid(QUuid::createUuid());
+    group->setParent(db.rootGroup());
+
+    // Enough entries to be created on the thread pool
+    QList<Entry*> entries;
+    for (int i = 0; i < 200; ++i) {
+        auto* entry = new Entry();
+        entry->setUuid(QUuid::createUuid());
+        entry->setTitle(QString("Entry %1").arg(i));
+        entry->setGroup(i % 2 == 0 ? db.rootGroup() : group);
+        entry->beginUpdate();
+        entry->setPassword(QString("password%1").arg(i));
+        entry->endUpdate();
+        entries.append(entry);
+    }
+    // Forward reference to an entry that is only defined later in the document
+    db.rootGroup()->setLastTopVisibleEntry(entries.last());
+
+    QBuffer buffer;
+    buffer.open(QBuffer::ReadWrite);
+    KdbxXmlWriter writer(KeePass2::FILE_VERSION_4, {});
+    writer.writeDatabase(&buffer, &db);
+    QVERIFY(!writer.hasError());
+
+    buffer.seek(0);
+    KdbxXmlReader reader(KeePass2::FILE_VERSION_4);
+    reader.setStrictMode(true);
+    auto newDb = reader.readDatabase(&buffer);
+    QVERIFY2(!reader.hasError(), qPrintable(reader.errorString()));
+    QCOMPARE(newDb->rootGroup()->entriesRecursive().size(), 200);
+
+    for (int i = 0; i < entries.size(); ++i) {
+        auto* newEntry = newDb->rootGroup()->findEntryByUuid(entries.at(i)->uuid());
+        QVERIFY(newEntry);
+        QCOMPARE(newEntry->title(), QString("Entry %1").arg(i));
+        QCOMPARE(newEntry->group()->uuid(), entries.at(i)->group()->uuid());
+        QCOMPARE(newEntry->thread(), QThread::currentThread());
+        QCOMPARE(newEntry->historyItems().size(), 1);
+        QCOMPARE(newEntry->historyItems().first()->thread(), QThread::currentThread());
+        QCOMPARE(newEntry->historyItems().first()->password(), QString(""));
+    }
+
+    // Entries keep the document order within their group
+    const QList<Entry*> newEntries = newDb->rootGroup()->entries();
+    for (int i = 0; i < newEntries.size(); ++i) {
+        QCOMPARE(newEntries.at(i)->uuid(), entries.at(2 * i)->uuid());
+    }
+
+    QVERIFY(newDb->rootGroup()->lastTopVisibleEntry());
+    QCOMPARE(newDb->rootGroup()->lastTopVisibleEntry()->uuid(), entries.last()->uuid());
+    QCOMPARE(newDb->rootGroup()->lastTopVisibleEntry(), newDb->rootGroup()->findEntryByUuid(entries.last()->uuid()));
+}
+
+void TestKdbx4Format::benchmarkReadXml_data()
+{
+    QTest::addColumn<int>("threads");
+
+    QTest::newRow("1 thread") << 1;
+    QTest::newRow("2 threads") << 2;
+    QTest::newRow("4 threads") << 4;
+    QTest::newRow("all cores") << QThread::idealThreadCount();
+}
+
+void TestKdbx4Format::benchmarkReadXml()
+{
+    QByteArray env = qgetenv("BENCHMARK");
+    if (env.isEmpty() || env == "0" || env == "no") {
+        QSKIP("Benchmark skipped. Set env variable BENCHMARK=1 to enable.");
+    }
+
+    QFETCH(int, threads);
+
+    Database db;
+    for (int i = 0; i < 100000; ++i) {
+        auto* entry = new Entry();
+        entry->setUuid(QUuid::createUuid());
+        entry->setTitle(QString("Entry %1").arg(i));
+        entry->setUsername(QString("user%1").arg(i));
+        entry->setUrl(QString("https://example%1.com").arg(i));
+        entry->setGroup(db.rootGroup());
+    }
+
+    QBuffer buffer;
+    buffer.open(QBuffer::ReadWrite);
+    KdbxXmlWriter writer(KeePass2::FILE_VERSION_4, {});
+    writer.writeDatabase(&buffer, &db);
+    QVERIFY(!writer.hasError());
+
+    // Entries are created on the global thread pool once the document is parsed
+    const int maxThreadCount = QThreadPool::globalInstance()->maxThreadCount();
+    QThreadPool::globalInstance()->setMaxThreadCount(threads);
+
+    QBENCHMARK
+    {
+        buffer.seek(0);
+        KdbxXmlReader reader(KeePass2::FILE_VERSION_4);
+        auto newDb = reader.readDatabase(&buffer);
+        QVERIFY(!reader.hasError());
+        QCOMPARE(newDb->rootGroup()->entries().size(), 100000);
+        qDebug("Creating entries: %lld ms", reader.modelTime() / 1000000);
+    }
+
+    QThreadPool::globalInstance()->setMaxThreadCount(maxThreadCount);
+}
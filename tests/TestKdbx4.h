@@ -66,6 +66,11 @@ private slots:
     void testUpgradeMasterKeyIntegrity_data();
     void testAttachmentIndexStability();
     void testCustomData();
+    void testHistoryDataSharing();
+    void testXmlScalars();
+    void testXmlEntryCreation();
+    void benchmarkReadXml_data();
+    void benchmarkReadXml();
 };
 
 #endif // KEEPASSXC_TEST_KDBX4_H
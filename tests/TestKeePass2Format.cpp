@@ -800,6 +800,53 @@ void TestKeePass2Format::testDuplicateAttachments()
     QCOMPARE(db->rootGroup()->entries()[2]->attachments()->value("c3"), attachment3);
 }
 
+void TestKeePass2Format::testHistoryAttachments()
+{
+    auto db = QSharedPointer<Database>::create();
+    db->setKey(QSharedPointer<CompositeKey>::create());
+
+    // Enough entries for the reader to create them concurrently
+    const int entryCount = 100;
+    for (int i = 0; i < entryCount; ++i) {
+        auto entry = new Entry();
+        entry->setGroup(db->rootGroup());
+        entry->setUuid(QUuid::createUuid());
+        entry->attachments()->set("old", QByteArray::number(i));
+        entry->beginUpdate();
+        entry->attachments()->remove("old");
+        entry->attachments()->set("new", QByteArray("new"));
+        entry->endUpdate();
+    }
+
+    QBuffer buffer;
+    buffer.open(QBuffer::ReadWrite);
+
+    bool hasError = false;
+    QString errorString;
+    writeKdbx(&buffer, db.data(), hasError, errorString);
+    if (hasError) {
+        QFAIL(qPrintable(QString("Error while writing database: %1").arg(errorString)));
+    }
+
+    buffer.seek(0);
+    readKdbx(&buffer, QSharedPointer<CompositeKey>::create(), db, hasError, errorString);
+    if (hasError) {
+        QFAIL(qPrintable(QString("Error while reading database: %1").arg(errorString)));
+    }
+
+    // Attachments only referenced by history items are kept
+    const auto entries = db->rootGroup()->entries();
+    QCOMPARE(entries.size(), entryCount);
+    for (int i = 0; i < entryCount; ++i) {
+        const Entry* entry = entries[i];
+        QCOMPARE(entry->attachments()->keys(), QStringList({"new"}));
+        QCOMPARE(entry->historyItems().size(), 1);
+        const Entry* historyItem = entry->historyItems()[0];
+        QCOMPARE(historyItem->attachments()->keys(), QStringList({"old"}));
+        QCOMPARE(historyItem->attachments()->value("old"), QByteArray::number(i));
+    }
+}
+
 /**
  * Fast "dummy" KDF
  */
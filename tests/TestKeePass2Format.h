@@ -62,6 +62,7 @@ private slots:
     void testKdbxKeyChange();
     void testKdbxKeyChange_data();
     void testDuplicateAttachments();
+    void testHistoryAttachments();
 
 protected:
     virtual void initTestCaseImpl() = 0;
@@ -21,8 +21,10 @@
 #include <QSignalSpy>
 #include <QTest>
 
+#include "core/Clock.h"
 #include "core/Group.h"
 #include "core/Metadata.h"
+#include "core/Totp.h"
 #include "crypto/Crypto.h"
 
 QTEST_GUILESS_MAIN(TestModified)
@@ -720,3 +722,105 @@ void TestModified::testBlockModifiedSignal()
     QCOMPARE(spyEntryAttachmentModified.count(), 0);
     QCOMPARE(spyEntryAutoTypeAssociationsModified.count(), 0);
 }
+
+void TestModified::testBatchUpdate()
+{
+    QScopedPointer<Database> db(new Database());
+    auto* root = db->rootGroup();
+
+    QSignalSpy spyModified(db.data(), SIGNAL(modified()));
+    QSignalSpy spyBatchStarted(db.data(), SIGNAL(batchUpdateStarted()));
+    QSignalSpy spyBatchFinished(db.data(), SIGNAL(batchUpdateFinished()));
+
+    db->beginBatchUpdate();
+    // nested batches are part of the outer batch
+    db->beginBatchUpdate();
+    QVERIFY(db->isBatchUpdating());
+    QCOMPARE(spyBatchStarted.count(), 1);
+
+    for (int i = 0; i < 10; ++i) {
+        auto* entry = new Entry();
+        entry->setGroup(root);
+        entry->setTitle(QString("Entry %1").arg(i));
+        QTest::qWait(20);
+    }
+
+    db->endBatchUpdate();
+    QVERIFY(db->isBatchUpdating());
+    QCOMPARE(spyBatchFinished.count(), 0);
+
+    QTest::qWait(200);
+    QVERIFY(db->isModified());
+    QCOMPARE(spyModified.count(), 0);
+
+    db->endBatchUpdate();
+    QVERIFY(!db->isBatchUpdating());
+    QCOMPARE(spyBatchFinished.count(), 1);
+
+    QTRY_COMPARE(spyModified.count(), 1);
+    QTest::qWait(200);
+    QCOMPARE(spyModified.count(), 1);
+}
+
+void TestModified::testBatchUpdateDeferred()
+{
+    QScopedPointer<Database> db(new Database());
+    auto* group = new Group();
+    group->setParent(db->rootGroup());
+    auto* entry = new Entry();
+    entry->setGroup(group);
+
+    const auto entryModified = entry->timeInfo().lastModificationTime();
+    QSignalSpy spyEntryModified(entry, SIGNAL(modified()));
+    QSignalSpy spyGroupModified(group, SIGNAL(modified()));
+
+    m_clock->advanceSecond(10);
+    db->beginBatchUpdate();
+    entry->setTitle("Title");
+    entry->setUsername("Username");
+    entry->attributes()->set(Totp::ATTRIBUTE_OTP, "otpauth://totp/Test?secret=GEZDGNBVGY3TQOJQ");
+    group->setName("Name");
+    group->setNotes("Notes");
+    group->customData()->set("Key", "Value");
+    entry->customData()->set("Key", "Value");
+
+    // Only noted until the batch ends
+    QCOMPARE(spyEntryModified.count(), 0);
+    QCOMPARE(spyGroupModified.count(), 0);
+    QCOMPARE(entry->timeInfo().lastModificationTime(), entryModified);
+    QVERIFY(!entry->hasTotp());
+    QVERIFY(db->isModified());
+
+    db->endBatchUpdate();
+
+    // Every object is updated and announced once
+    QCOMPARE(spyEntryModified.count(), 1);
+    QCOMPARE(spyGroupModified.count(), 1);
+    QCOMPARE(entry->timeInfo().lastModificationTime(), Clock::currentDateTimeUtc());
+    QCOMPARE(group->timeInfo().lastModificationTime(), Clock::currentDateTimeUtc());
+    QVERIFY(entry->hasTotp());
+    QCOMPARE(entry->title(), QString("Title"));
+
+    // History is still recorded for updates within a batch
+    db->beginBatchUpdate();
+    entry->beginUpdate();
+    entry->setTitle("Changed");
+    QVERIFY(entry->endUpdate());
+    db->endBatchUpdate();
+    QCOMPARE(entry->historyItems().size(), 1);
+
+    // Changes made while the time info update was disabled keep their time info, as in Merger
+    const auto entryModifiedBefore = entry->timeInfo().lastModificationTime();
+    const auto groupModifiedBefore = group->timeInfo().lastModificationTime();
+    m_clock->advanceSecond(10);
+    db->beginBatchUpdate();
+    entry->setUpdateTimeinfo(false);
+    group->setUpdateTimeinfo(false);
+    entry->setNotes("Merged");
+    group->setNotes("Merged");
+    entry->setUpdateTimeinfo(true);
+    group->setUpdateTimeinfo(true);
+    db->endBatchUpdate();
+    QCOMPARE(entry->timeInfo().lastModificationTime(), entryModifiedBefore);
+    QCOMPARE(group->timeInfo().lastModificationTime(), groupModifiedBefore);
+}
@@ -35,6 +35,8 @@ private slots:
     void testHistoryMaxSize();
     void testCustomData();
     void testBlockModifiedSignal();
+    void testBatchUpdate();
+    void testBatchUpdateDeferred();
 };
 
 #endif // KEEPASSX_TESTMODIFIED_H
@@ -0,0 +1,218 @@
+/*
+ *  Copyright (C) 2024 KeePassXC Team <team@keepassxc.org>
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "TestNativeMessagingProxy.h"
+
+#include "browser/BrowserShared.h"
+
+#include <QElapsedTimer>
+#include <QEventLoop>
+#include <QLocalSocket>
+#include <QTest>
+#include <QTimer>
+
+QTEST_GUILESS_MAIN(TestNativeMessagingProxy)
+
+namespace
+{
+    constexpr int Timeout = 5000;
+} // namespace
+
+void TestNativeMessagingProxy::initTestCase()
+{
+#ifdef Q_OS_WIN
+    QSKIP("The proxy socket location cannot be redirected on Windows.");
+#endif
+    QVERIFY(m_runtimeDir.isValid());
+
+    // Let the proxy and the stand-in host agree on a private socket location
+    qputenv("XDG_RUNTIME_DIR", m_runtimeDir.path().toLocal8Bit());
+    qputenv("TMPDIR", m_runtimeDir.path().toLocal8Bit());
+
+    connect(&m_server, SIGNAL(newConnection()), this, SLOT(hostConnected()));
+    QVERIFY(m_server.listen(BrowserShared::localServerPath()));
+}
+
+void TestNativeMessagingProxy::init()
+{
+    m_hostBuffer.clear();
+    m_hostMessages.clear();
+    m_proxyOutput.clear();
+
+    m_proxy.setProcessEnvironment(QProcessEnvironment::systemEnvironment());
+    m_proxy.setProcessChannelMode(QProcess::SeparateChannels);
+    m_proxy.setReadChannel(QProcess::StandardOutput);
+    m_proxy.start(KEEPASSXC_PROXY_EXECUTABLE, QStringList());
+    QVERIFY(m_proxy.waitForStarted(Timeout));
+    QTRY_VERIFY_WITH_TIMEOUT(m_hostSocket, Timeout);
+}
+
+void TestNativeMessagingProxy::cleanup()
+{
+    // The proxy quits once its standard input is closed
+    m_proxy.closeWriteChannel();
+    if (!m_proxy.waitForFinished(Timeout)) {
+        m_proxy.kill();
+        m_proxy.waitForFinished(Timeout);
+    }
+    if (m_hostSocket) {
+        m_hostSocket->deleteLater();
+        m_hostSocket.clear();
+    }
+}
+
+void TestNativeMessagingProxy::hostConnected()
+{
+    m_hostSocket = m_server.nextPendingConnection();
+    if (m_hostSocket) {
+        connect(m_hostSocket.data(), SIGNAL(readyRead()), this, SLOT(hostReadyRead()));
+    }
+}
+
+void TestNativeMessagingProxy::hostReadyRead()
+{
+    // Stand-in for BrowserHost, echoes back all complete messages with a single write
+    m_hostBuffer.append(m_hostSocket->readAll());
+
+    QByteArray reply;
+    int offset = 0;
+    int length = 0;
+    while ((length = BrowserShared::jsonMessageLength(m_hostBuffer, offset)) > 0) {
+        const auto message = m_hostBuffer.mid(offset, length);
+        m_hostMessages.append(message);
+        reply.append(message);
+        offset += length;
+    }
+    m_hostBuffer.remove(0, offset);
+
+    if (!reply.isEmpty()) {
+        m_hostSocket->write(reply);
+        m_hostSocket->flush();
+    }
+}
+
+void TestNativeMessagingProxy::writeFrame(const QByteArray& message)
+{
+    quint32 length = static_cast<quint32>(message.size());
+    m_proxy.write(reinterpret_cast<const char*>(&length), sizeof(length));
+    m_proxy.write(message);
+}
+
+QByteArray TestNativeMessagingProxy::readFrame()
+{
+    QElapsedTimer timer;
+    timer.start();
+
+    while (true) {
+        if (m_proxyOutput.size() >= static_cast<int>(sizeof(quint32))) {
+            quint32 length = 0;
+            memcpy(&length, m_proxyOutput.constData(), sizeof(length));
+            const int frameSize = static_cast<int>(sizeof(length) + length);
+            if (m_proxyOutput.size() >= frameSize) {
+                auto message = m_proxyOutput.mid(sizeof(length), length);
+                m_proxyOutput.remove(0, frameSize);
+                return message;
+            }
+        }
+
+        if (timer.hasExpired(Timeout) || m_proxy.state() != QProcess::Running) {
+            return {};
+        }
+
+        // Keep the stand-in host responsive while waiting for the proxy
+        if (m_proxy.bytesAvailable() == 0) {
+            QEventLoop loop;
+            QTimer::singleShot(Timeout, &loop, SLOT(quit()));
+            connect(&m_proxy, SIGNAL(readyReadStandardOutput()), &loop, SLOT(quit()));
+            loop.exec();
+        }
+        m_proxyOutput.append(m_proxy.readAllStandardOutput());
+    }
+}
+
+void TestNativeMessagingProxy::testJsonMessageLength()
+{
+    QCOMPARE(BrowserShared::jsonMessageLength(R"({"action":"test"})"), 17);
+    QCOMPARE(BrowserShared::jsonMessageLength(R"({"a":{"b":[1,2]}}{"c":3})"), 17);
+    QCOMPARE(BrowserShared::jsonMessageLength(R"({"a":{"b":[1,2]}}{"c":3})", 17), 7);
+    QCOMPARE(BrowserShared::jsonMessageLength(R"({"a":"}{\"}"})"), 13);
+    QCOMPARE(BrowserShared::jsonMessageLength(R"({"a":"\\"})"), 10);
+    QCOMPARE(BrowserShared::jsonMessageLength(R"({"a":{"b":1})"), -1);
+    QCOMPARE(BrowserShared::jsonMessageLength(R"({"a":"}")"), -1);
+    QCOMPARE(BrowserShared::jsonMessageLength(""), -1);
+}
+
+void TestNativeMessagingProxy::testRoundTrip()
+{
+    const QByteArray message(R"({"action":"get-databasehash","text":"äöü {}"})");
+    writeFrame(message);
+    QCOMPARE(readFrame(), message);
+    QCOMPARE(m_hostMessages, QList<QByteArray>({message}));
+
+    // Large messages are forwarded in one piece
+    const QByteArray large = R"({"data":")" + QByteArray(512 * 1024, 'x') + R"("})";
+    writeFrame(large);
+    QCOMPARE(readFrame(), large);
+}
+
+void TestNativeMessagingProxy::testPipelinedMessages()
+{
+    // Several frames written back-to-back must all arrive, in order and split up again
+    QList<QByteArray> messages;
+    for (int i = 0; i < 50; ++i) {
+        messages.append(QString(R"({"action":"test","nonce":"%1"})").arg(i).toUtf8());
+    }
+    for (const auto& message : messages) {
+        writeFrame(message);
+    }
+
+    for (const auto& message : messages) {
+        QCOMPARE(readFrame(), message);
+    }
+    QCOMPARE(m_hostMessages, messages);
+}
+
+void TestNativeMessagingProxy::benchmarkRoundTrip()
+{
+    QByteArray env = qgetenv("BENCHMARK");
+    if (env.isEmpty() || env == "0" || env == "no") {
+        QSKIP("Benchmark skipped. Set env variable BENCHMARK=1 to enable.");
+    }
+
+    const QByteArray message(R"({"action":"get-logins","nonce":"zBKdvTjL5bgWaKMCTut/8soM/uoMrFoZ"})");
+    const int count = 1000;
+
+    QElapsedTimer timer;
+    timer.start();
+    for (int i = 0; i < count; ++i) {
+        writeFrame(message);
+        QCOMPARE(readFrame(), message);
+    }
+    const auto sequential = timer.nsecsElapsed();
+
+    timer.restart();
+    for (int i = 0; i < count; ++i) {
+        writeFrame(message);
+    }
+    for (int i = 0; i < count; ++i) {
+        QCOMPARE(readFrame(), message);
+    }
+    const auto pipelined = timer.nsecsElapsed();
+
+    qDebug("Round trip latency: %.1f us", sequential / 1000.0 / count);
+    qDebug("Pipelined throughput: %.0f messages/s", count / (pipelined / 1e9));
+}
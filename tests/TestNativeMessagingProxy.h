@@ -0,0 +1,58 @@
+/*
+ *  Copyright (C) 2024 KeePassXC Team <team@keepassxc.org>
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef KEEPASSXC_TESTNATIVEMESSAGINGPROXY_H
+#define KEEPASSXC_TESTNATIVEMESSAGINGPROXY_H
+
+#include <QLocalServer>
+#include <QPointer>
+#include <QProcess>
+#include <QTemporaryDir>
+
+class QLocalSocket;
+
+class TestNativeMessagingProxy : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void initTestCase();
+    void init();
+    void cleanup();
+    void testJsonMessageLength();
+    void testRoundTrip();
+    void testPipelinedMessages();
+    void benchmarkRoundTrip();
+
+private slots:
+    void hostConnected();
+    void hostReadyRead();
+
+private:
+    void writeFrame(const QByteArray& message);
+    QByteArray readFrame();
+
+    QTemporaryDir m_runtimeDir;
+    QLocalServer m_server;
+    QPointer<QLocalSocket> m_hostSocket;
+    QByteArray m_hostBuffer;
+    QList<QByteArray> m_hostMessages;
+    QProcess m_proxy;
+    QByteArray m_proxyOutput;
+};
+
+#endif // KEEPASSXC_TESTNATIVEMESSAGINGPROXY_H
@@ -18,13 +18,29 @@
 #include "TestPasswordHealth.h"
 
 #include "core/PasswordHealth.h"
+#include "crypto/Crypto.h"
 
 #include <QTest>
 
 QTEST_GUILESS_MAIN(TestPasswordHealth)
 
+namespace
+{
+    QStringList generatePasswords(int count)
+    {
+        const QStringList words{"password", "dragon", "monkey", "letmein", "sunshine", "correct", "horse"};
+        QStringList passwords;
+        for (int i = 0; i < count; ++i) {
+            passwords << QString("%1%2").arg(words[i % words.size()]).arg(i * 7919 % 10000)
+                      << QString("Yohb2ChR4-%1").arg(i);
+        }
+        return passwords;
+    }
+} // namespace
+
 void TestPasswordHealth::initTestCase()
 {
+    QVERIFY(Crypto::init());
 }
 
 void TestPasswordHealth::testNoDb()
@@ -64,3 +80,41 @@ void TestPasswordHealth::testNoDb()
     QVERIFY(excellent.scoreReason().isEmpty());
     QVERIFY(excellent.scoreDetails().isEmpty());
 }
+
+void TestPasswordHealth::testEstimateEntropies()
+{
+    QVERIFY(PasswordHealth::estimateEntropies({}).isEmpty());
+
+    // Same results as one at a time, in the same order
+    const auto passwords = generatePasswords(100) << "" << "secret";
+    const auto entropies = PasswordHealth::estimateEntropies(passwords);
+    QCOMPARE(entropies.size(), passwords.size());
+    for (int i = 0; i < passwords.size(); ++i) {
+        QCOMPARE(entropies[i], PasswordHealth::estimateEntropy(passwords[i]));
+    }
+
+    // Duplicates are only estimated once
+    PasswordHealthCache cache;
+    cache.prefetch(QStringList() << "secret"
+                                 << "secret"
+                                 << "Yohb2ChR4");
+    QCOMPARE(cache.size(), 2);
+    cache.prefetch(passwords);
+    QCOMPARE(cache.size(), passwords.size() + 1);
+    QCOMPARE(cache.entropy("secret"), PasswordHealth::estimateEntropy("secret"));
+    QCOMPARE(cache.size(), passwords.size() + 1);
+}
+
+void TestPasswordHealth::benchmarkEstimateEntropies()
+{
+    QByteArray env = qgetenv("BENCHMARK");
+    if (env.isEmpty() || env == "0" || env == "no") {
+        QSKIP("Benchmark skipped. Set env variable BENCHMARK=1 to enable.");
+    }
+
+    const auto passwords = generatePasswords(5000);
+    QBENCHMARK
+    {
+        PasswordHealth::estimateEntropies(passwords);
+    }
+}
@@ -18,6 +18,7 @@
 #include "TestSSHAgent.h"
 #include "config-keepassx-tests.h"
 #include "core/Config.h"
+#include "core/Group.h"
 #include "crypto/Crypto.h"
 #include "sshagent/KeeAgentSettings.h"
 #include "sshagent/OpenSSHKeyGen.h"
@@ -225,6 +226,93 @@ void TestSSHAgent::testToOpenSSHKey()
     QVERIFY(!key.publicKey().isEmpty());
 }
 
+static QSharedPointer<Database> createDatabaseWithKeys(int keyCount, QList<QSharedPointer<OpenSSHKey>>& keys)
+{
+    QSharedPointer<Database> db(new Database());
+
+    KeeAgentSettings settings;
+    settings.setAllowUseOfSshKey(true);
+    settings.setAddAtDatabaseOpen(true);
+    settings.setRemoveAtDatabaseClose(true);
+    settings.setSelectedType("attachment");
+    settings.setAttachmentName("id_ed25519");
+
+    for (int i = 0; i < keyCount; ++i) {
+        QSharedPointer<OpenSSHKey> key(new OpenSSHKey());
+        if (!OpenSSHKeyGen::generateEd25519(*key)) {
+            return {};
+        }
+
+        auto entry = new Entry();
+        entry->setUuid(QUuid::createUuid());
+        entry->setGroup(db->rootGroup());
+        entry->attachments()->set("id_ed25519", key->privateKey().toLatin1());
+        settings.toEntry(entry);
+
+        keys.append(key);
+    }
+
+    return db;
+}
+
+void TestSSHAgent::testDatabaseUnlockedManyKeys()
+{
+    SSHAgent agent;
+    agent.setEnabled(true);
+    agent.setAuthSockOverride(m_agentSocketFileName);
+
+    QVERIFY(agent.isAgentRunning());
+
+    QList<QSharedPointer<OpenSSHKey>> keys;
+    auto db = createDatabaseWithKeys(20, keys);
+    QVERIFY(db);
+
+    agent.databaseUnlocked(db);
+
+    QList<QSharedPointer<OpenSSHKey>> agentKeys;
+    QVERIFY(agent.listIdentities(agentKeys));
+    for (const auto& key : keys) {
+        bool found = false;
+        for (const auto& agentKey : agentKeys) {
+            if (*agentKey == *key) {
+                found = true;
+                break;
+            }
+        }
+        QVERIFY(found);
+    }
+
+    agent.databaseLocked(db);
+
+    bool keyInAgent;
+    QVERIFY(agent.checkIdentity(*keys.first(), keyInAgent) && !keyInAgent);
+    QVERIFY(agent.checkIdentity(*keys.last(), keyInAgent) && !keyInAgent);
+}
+
+void TestSSHAgent::benchmarkDatabaseUnlocked()
+{
+    QByteArray env = qgetenv("BENCHMARK");
+    if (env.isEmpty() || env == "0" || env == "no") {
+        QSKIP("Benchmark skipped. Set env variable BENCHMARK=1 to enable.");
+    }
+
+    SSHAgent agent;
+    agent.setEnabled(true);
+    agent.setAuthSockOverride(m_agentSocketFileName);
+
+    QVERIFY(agent.isAgentRunning());
+
+    QList<QSharedPointer<OpenSSHKey>> keys;
+    auto db = createDatabaseWithKeys(200, keys);
+    QVERIFY(db);
+
+    QBENCHMARK
+    {
+        agent.databaseUnlocked(db);
+        agent.databaseLocked(db);
+    }
+}
+
 void TestSSHAgent::testKeyGenRSA()
 {
     SSHAgent agent;
@@ -35,6 +35,8 @@ private slots:
     void testLifetimeConstraint();
     void testConfirmConstraint();
     void testToOpenSSHKey();
+    void testDatabaseUnlockedManyKeys();
+    void benchmarkDatabaseUnlocked();
     void testKeyGenRSA();
     void testKeyGenECDSA();
     void testKeyGenEd25519();
@@ -23,6 +23,7 @@
 #include <QVector>
 
 #include "crypto/Crypto.h"
+#include "crypto/Random.h"
 #include "format/KeePass2.h"
 #include "streams/SymmetricCipherStream.h"
 
@@ -455,3 +456,110 @@ void TestSymmetricCipher::testStreamReset()
     writer.close();
     QCOMPARE(buffer.buffer().size(), 16);
 }
+
+void TestSymmetricCipher::testStreamChunks_data()
+{
+    QTest::addColumn<SymmetricCipher::Mode>("mode");
+    QTest::addColumn<int>("size");
+
+    const int chunkSize = 64 * 1024;
+    const QList<int> sizes = {1, 15, 16, 17, chunkSize - 16, chunkSize - 1, chunkSize, chunkSize + 1,
+                              chunkSize + 16, 3 * chunkSize, 3 * chunkSize + 5};
+
+    for (int size : sizes) {
+        QTest::addRow("AES-256-CBC %d", size) << SymmetricCipher::Aes256_CBC << size;
+        QTest::addRow("ChaCha20 %d", size) << SymmetricCipher::ChaCha20 << size;
+    }
+}
+
+void TestSymmetricCipher::testStreamChunks()
+{
+    QFETCH(SymmetricCipher::Mode, mode);
+    QFETCH(int, size);
+
+    QByteArray key(32, '\x42');
+    QByteArray iv(SymmetricCipher::defaultIvSize(mode), '\x24');
+    QByteArray plainText = randomGen()->randomArray(size);
+
+    QBuffer buffer;
+    QVERIFY(buffer.open(QIODevice::WriteOnly));
+    SymmetricCipherStream writer(&buffer);
+    QVERIFY(writer.init(mode, SymmetricCipher::Encrypt, key, iv));
+    QVERIFY(writer.open(QIODevice::WriteOnly));
+    // Write in odd pieces to cross the chunk boundaries at arbitrary offsets
+    for (int offset = 0; offset < size; offset += 1000) {
+        QVERIFY(writer.write(plainText.mid(offset, 1000)) >= 0);
+    }
+    writer.close();
+    buffer.close();
+
+    if (SymmetricCipher::blockSize(mode) == 1) {
+        QCOMPARE(buffer.buffer().size(), size);
+    } else {
+        QCOMPARE(buffer.buffer().size(), (size / 16 + 1) * 16);
+    }
+
+    QVERIFY(buffer.open(QIODevice::ReadOnly));
+    SymmetricCipherStream reader(&buffer);
+    QVERIFY(reader.init(mode, SymmetricCipher::Decrypt, key, iv));
+    QVERIFY(reader.open(QIODevice::ReadOnly));
+    QByteArray decrypted;
+    QByteArray piece;
+    do {
+        piece = reader.read(777);
+        decrypted.append(piece);
+    } while (!piece.isEmpty());
+    QCOMPARE(decrypted, plainText);
+}
+
+void TestSymmetricCipher::benchmarkStream_data()
+{
+    QTest::addColumn<SymmetricCipher::Mode>("mode");
+
+    QTest::newRow("AES-256-CBC") << SymmetricCipher::Aes256_CBC;
+    QTest::newRow("Twofish-CBC") << SymmetricCipher::Twofish_CBC;
+    QTest::newRow("ChaCha20") << SymmetricCipher::ChaCha20;
+}
+
+void TestSymmetricCipher::benchmarkStream()
+{
+    QByteArray env = qgetenv("BENCHMARK");
+    if (env.isEmpty() || env == "0" || env == "no") {
+        QSKIP("Benchmark skipped. Set env variable BENCHMARK=1 to enable.");
+    }
+
+    QFETCH(SymmetricCipher::Mode, mode);
+
+    QByteArray key(32, '\x42');
+    QByteArray iv(SymmetricCipher::defaultIvSize(mode), '\x24');
+    // 16 MiB, written and read in the 16 KiB pieces the KDBX reader and writer use
+    QByteArray plainText = randomGen()->randomArray(16 * 1024 * 1024);
+    const int pieceSize = 16 * 1024;
+
+    QBENCHMARK
+    {
+        QBuffer buffer;
+        QVERIFY(buffer.open(QIODevice::WriteOnly));
+        SymmetricCipherStream writer(&buffer);
+        QVERIFY(writer.init(mode, SymmetricCipher::Encrypt, key, iv));
+        QVERIFY(writer.open(QIODevice::WriteOnly));
+        for (int offset = 0; offset < plainText.size(); offset += pieceSize) {
+            QCOMPARE(writer.write(plainText.constData() + offset, pieceSize), qint64(pieceSize));
+        }
+        writer.close();
+        buffer.close();
+
+        QVERIFY(buffer.open(QIODevice::ReadOnly));
+        SymmetricCipherStream reader(&buffer);
+        QVERIFY(reader.init(mode, SymmetricCipher::Decrypt, key, iv));
+        QVERIFY(reader.open(QIODevice::ReadOnly));
+        QByteArray decrypted(pieceSize, '\0');
+        qint64 total = 0;
+        qint64 readResult;
+        while ((readResult = reader.read(decrypted.data(), pieceSize)) > 0) {
+            total += readResult;
+        }
+        QCOMPARE(readResult, qint64(0));
+        QCOMPARE(total, qint64(plainText.size()));
+    }
+}
@@ -1837,7 +1837,7 @@ void TestGui::testDatabaseLocking()
     QTest::keyClicks(editPassword, "a");
     QTest::keyClick(editPassword, Qt::Key_Enter);
 
-    QVERIFY(!dbWidget->isLocked());
+    QTRY_VERIFY(!dbWidget->isLocked());
     QCOMPARE(m_tabWidget->tabText(0), origDbName);
 
     actionDatabaseMerge = m_mainWindow->findChild<QAction*>("actionDatabaseMerge", Qt::FindChildrenRecursively);
@@ -30,6 +30,7 @@
 #include "core/Tools.h"
 #include "crypto/Crypto.h"
 #include "gui/Application.h"
+#include "gui/DatabaseOpenWidget.h"
 #include "gui/DatabaseTabWidget.h"
 #include "gui/FileDialog.h"
 #include "gui/MainWindow.h"
@@ -193,6 +194,8 @@ void TestGuiFdoSecrets::init()
 
     // open and unlock the database
     m_tabWidget->addDatabaseTab(m_dbFile->fileName(), false, "a");
+    // The database is read on a worker thread
+    VERIFY(QTest::qWaitFor([this] { return !m_tabWidget->currentDatabaseWidget()->isLocked(); }));
     m_dbWidget = m_tabWidget->currentDatabaseWidget();
     m_db = m_dbWidget->database();
 
@@ -333,6 +336,29 @@ void TestGuiFdoSecrets::testServiceSearch()
         COMPARE(locked, {});
         COMPARE(unlocked, {QDBusObjectPath(item->path())});
     }
+    {
+        DBUS_GET2(unlocked, locked, service->SearchItems({{"fdosecrets-test", "1"}, {crazyKey, crazyValue}}));
+        COMPARE(locked, {});
+        COMPARE(unlocked, {QDBusObjectPath(item->path())});
+    }
+    {
+        DBUS_GET2(unlocked, locked, service->SearchItems({{"fdosecrets-test", "1"}, {crazyKey, "other"}}));
+        COMPARE(locked, {});
+        COMPARE(unlocked, {});
+    }
+
+    // search follows changes to the entry
+    entry->attributes()->set("fdosecrets-test", "3");
+    {
+        DBUS_GET2(unlocked, locked, service->SearchItems({{"fdosecrets-test", "1"}}));
+        COMPARE(locked, {});
+        COMPARE(unlocked, {});
+    }
+    {
+        DBUS_GET2(unlocked, locked, service->SearchItems({{"fdosecrets-test", "3"}}));
+        COMPARE(locked, {});
+        COMPARE(unlocked, {QDBusObjectPath(item->path())});
+    }
 
     // searching using empty terms returns nothing
     {
@@ -1064,6 +1090,8 @@ void TestGuiFdoSecrets::testHiddenFilename()
     m_db.reset();
     VERIFY(m_tabWidget->closeAllDatabaseTabs());
     m_tabWidget->addDatabaseTab(m_dbFile->fileName(), false, "a");
+    // The database is read on a worker thread
+    VERIFY(QTest::qWaitFor([this] { return !m_tabWidget->currentDatabaseWidget()->isLocked(); }));
     m_dbWidget = m_tabWidget->currentDatabaseWidget();
     m_db = m_dbWidget->database();
 
@@ -1086,6 +1114,8 @@ void TestGuiFdoSecrets::testDuplicateName()
     QString anotherFile = dir.path() + "/" + QFileInfo(*m_dbFile).fileName();
     m_dbFile->copy(anotherFile);
     m_tabWidget->addDatabaseTab(anotherFile, false, "a");
+    // The database is read on a worker thread
+    VERIFY(QTest::qWaitFor([this] { return !m_tabWidget->currentDatabaseWidget()->isLocked(); }));
 
     auto service = enableService();
     VERIFY(service);
@@ -1696,6 +1726,8 @@ void TestGuiFdoSecrets::lockDatabaseInBackend()
 void TestGuiFdoSecrets::unlockDatabaseInBackend()
 {
     m_dbWidget->performUnlockDatabase("a");
+    // The database is read on a worker thread
+    VERIFY(QTest::qWaitFor([this] { return !m_dbWidget->isLocked(); }));
     m_db = m_dbWidget->database();
     processEvents();
 }
@@ -1905,6 +1937,10 @@ bool TestGuiFdoSecrets::driveUnlockDialog(DatabaseWidget* target)
     editPassword->setFocus();
     QTest::keyClicks(editPassword, "a");
     QTest::keyClick(editPassword, Qt::Key_Enter);
+    // The database is read on a worker thread, wait until the unlock completed
+    auto openWidget = dbOpenDlg->findChild<DatabaseOpenWidget*>();
+    VERIFY(openWidget);
+    VERIFY(QTest::qWaitFor([openWidget] { return !openWidget->unlockingDatabase(); }));
     processEvents();
     return true;
 }